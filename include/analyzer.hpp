@@ -1,9 +1,10 @@
 #pragma once 
 
 #include "ast.hpp"
-#include "visitor.hpp"
+#include "walker.hpp"
 #include "scope.hpp"
 #include "type.hpp"
+#include "constant_folder.hpp"
 #include <iostream>
 
 
@@ -17,10 +18,12 @@
 
 
 
-class Analyzer : public Visitor{
+class Analyzer : public Walker<Analyzer> {
 public:
 	Analyzer();
 	void analyze(TranslationUnit&);
+	// проверить тело, разобранное после analyze (ленивый разбор); ошибки — std::runtime_error
+	void analyze_body(FuncDeclaration&);
 
 	std::vector<std::string> errors;
 	
@@ -33,61 +36,76 @@ public:
     }
 
 public:
-	void visit(ASTNode&) override;
-	void visit(TranslationUnit& unit) override;
+	void visit(ASTNode&);
+	void visit(TranslationUnit& unit);
 public:
-	void visit(Declaration::PtrDeclarator&) override;
-	void visit(Declaration::SimpleDeclarator&) override;
-	void visit(Declaration::InitDeclarator&) override;
-	void visit(VarDeclaration&) override;
-	void visit(ParameterDeclaration&) override;
-	void visit(FuncDeclaration&) override;
-	void visit(StructDeclaration&) override;
-	void visit(ArrayDeclaration&) override;
-	void visit(NameSpaceDeclaration&) override;
+	void visit(Declaration::PtrDeclarator&);
+	void visit(Declaration::SimpleDeclarator&);
+	void visit(Declaration::InitDeclarator&);
+	void visit(VarDeclaration&);
+	void visit(ParameterDeclaration&);
+	void visit(FuncDeclaration&);
+	void visit(StructDeclaration&);
+	void visit(ArrayDeclaration&);
+	void visit(NameSpaceDeclaration&);
 public:
-	void visit(CompoundStatement&) override;
-	void visit(DeclarationStatement&) override;
-	void visit(ExpressionStatement&) override;
-	void visit(ConditionalStatement&) override;
-	void visit(WhileStatement&) override;
-	void visit(ForStatement&) override;
-	void visit(ReturnStatement&) override;
-	void visit(BreakStatement&) override;
-	void visit(ContinueStatement&) override;
-	void visit(StructMemberAccessExpression&) override;
-	void visit(DoWhileStatement&) override;
-	void visit(StaticAssertStatement&) override;
+	void visit(CompoundStatement&);
+	void visit(DeclarationStatement&);
+	void visit(ExpressionStatement&);
+	void visit(ConditionalStatement&);
+	void visit(WhileStatement&);
+	void visit(ForStatement&);
+	void visit(ReturnStatement&);
+	void visit(BreakStatement&);
+	void visit(ContinueStatement&);
+	void visit(StructMemberAccessExpression&);
+	void visit(DoWhileStatement&);
+	void visit(StaticAssertStatement&);
 public:
-	void visit(BinaryOperation&) override;
-	void visit(PrefixExpression&) override;
-	void visit(PostfixIncrementExpression&) override;
-	void visit(PostfixDecrementExpression&) override;
-	void visit(FunctionCallExpression&) override;
-	void visit(SubscriptExpression&) override;
-	void visit(IntLiteral&) override;
-	void visit(FloatLiteral&) override;
-	void visit(CharLiteral&) override;
-	void visit(StringLiteral&) override;
-	void visit(BoolLiteral&) override;
-	void visit(NullPtrLiteral&) override;
-	void visit(IdentifierExpression&) override;
-	void visit(ParenthesizedExpression&) override;
-	void visit(TernaryExpression&) override;
-	void visit(SizeOfExpression&) override;
-	void visit(NameSpaceAcceptExpression&) override;
+	void visit(BinaryOperation&);
+	void visit(PrefixExpression&);
+	void visit(PostfixIncrementExpression&);
+	void visit(PostfixDecrementExpression&);
+	void visit(FunctionCallExpression&);
+	void visit(SubscriptExpression&);
+	void visit(IntLiteral&);
+	void visit(FloatLiteral&);
+	void visit(CharLiteral&);
+	void visit(StringLiteral&);
+	void visit(BoolLiteral&);
+	void visit(NullPtrLiteral&);
+	void visit(IdentifierExpression&);
+	void visit(ParenthesizedExpression&);
+	void visit(TernaryExpression&);
+	void visit(SizeOfExpression&);
+	void visit(NameSpaceAcceptExpression&);
 
-	std::shared_ptr<Type> get_type(const std::string&);
-	static std::unordered_map<std::string, std::shared_ptr<Type>> default_types;
+	std::shared_ptr<Type> get_type(Name);
+	static std::unordered_map<Name, std::shared_ptr<Type>> default_types;
 	std::shared_ptr<Scope> scope;
     std::shared_ptr<Type> current_type;
 	std::vector<std::shared_ptr<Type>> return_type_stack;
 
+	// раскладка кадра активации анализируемой функции
+	int frame_top = 0;
+	int frame_size = 0;
+	int declare(Name name, std::shared_ptr<Symbol> symbol);
+	void open_frame();
+	// адрес имени для исполнителя: слот или поле/метод экземпляра (тело метода)
+	void resolve(const std::shared_ptr<Symbol>& symbol, IdentifierExpression& node);
+	// поля и методы структуры, тела методов которой сейчас проверяются
+	std::shared_ptr<Scope> member_scope;
+	void check_body(FuncDeclaration&, std::shared_ptr<Type> ret_t, const std::vector<std::shared_ptr<Type>>& arg_ts);
+
 	bool is_deducing_return = false;
     std::shared_ptr<Type> deduced_return_type = nullptr;
 
-	
-	bool evaluateConstant(ASTNode*);
+	// значения const-переменных с константным инициализатором и места, где они прочитаны
+	std::unordered_map<std::shared_ptr<Symbol>, Value> constant_symbols;
+	ConstantNames constants;
+	// функции, которые вызывают f(...), — для вычисления вызовов чистых функций до исполнения
+	ConstantCalls callees;
+	std::optional<Value> constant_value(Expression&);
 	std::shared_ptr<Scope> getScope() const { return scope; }
 		
 	enum class BinaryOp{
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Арена узлов дерева: узлы выделяются подряд в больших блоках и
+// освобождаются все сразу вместе с ареной, без счётчиков ссылок и деструкторов.
+class Arena {
+public:
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    template<typename T, typename... Args>
+    T* make(Args&&... args) {
+        // деструкторы узлов не вызываются: строки узла тоже лежат в арене (copy)
+        static_assert(std::is_trivially_destructible_v<T>, "arena objects must be trivially destructible");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // неизменяемая копия списка в арене
+    template<typename T>
+    std::span<T> copy(const std::vector<T>& items) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (items.empty()) {
+            return {};
+        }
+        T* data = static_cast<T*>(allocate(sizeof(T) * items.size(), alignof(T)));
+        std::uninitialized_copy(items.begin(), items.end(), data);
+        return {data, items.size()};
+    }
+
+    // неизменяемая копия строки в арене
+    std::string_view copy(std::string_view text) {
+        if (text.empty()) {
+            return {};
+        }
+        auto data = static_cast<char*>(allocate(text.size(), alignof(char)));
+        std::copy(text.begin(), text.end(), data);
+        return {data, text.size()};
+    }
+
+    // узлы другой арены живут столько же, сколько эта (слияние кусков параллельного разбора)
+    void adopt(std::unique_ptr<Arena> other) {
+        bytes += other->bytes;
+        adopted.push_back(std::move(other));
+    }
+
+    // байт, занятых узлами
+    std::size_t used() const { return bytes; }
+
+private:
+    void* allocate(std::size_t size, std::size_t align);
+
+    static constexpr std::size_t block_size = 64 * 1024;
+
+    std::vector<std::unique_ptr<std::byte[]>> blocks;
+    std::byte* cursor = nullptr;
+    std::byte* limit = nullptr;
+    std::size_t bytes = 0;
+    std::vector<std::unique_ptr<Arena>> adopted;
+};
@@ -1,23 +1,94 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <span>
+
+#include "arena.hpp"
 
 
 class Visitor;
 
+// вид конкретного узла: по нему Walker выбирает обработчик, а node_cast заменяет dynamic_cast
+enum class NodeKind : std::uint8_t {
+	TranslationUnit,
+
+	SimpleDeclarator,
+	PtrDeclarator,
+	VarDeclaration,
+	ParameterDeclaration,
+	FuncDeclaration,
+	StructDeclaration,
+	ArrayDeclaration,
+	NameSpaceDeclaration,
+
+	CompoundStatement,
+	DeclarationStatement,
+	ExpressionStatement,
+	ConditionalStatement,
+	WhileStatement,
+	DoWhileStatement,
+	ForStatement,
+	ReturnStatement,
+	BreakStatement,
+	ContinueStatement,
+	StaticAssertStatement,
+
+	BinaryOperation,
+	PrefixExpression,
+	PostfixIncrementExpression,
+	PostfixDecrementExpression,
+	FunctionCallExpression,
+	SubscriptExpression,
+	StructMemberAccessExpression,
+	IdentifierExpression,
+	IntLiteral,
+	FloatLiteral,
+	CharLiteral,
+	StringLiteral,
+	BoolLiteral,
+	NullPtrLiteral,
+	ParenthesizedExpression,
+	TernaryExpression,
+	SizeOfExpression,
+	NameSpaceAcceptExpression,
+};
+
 struct ASTNode {
-	virtual ~ASTNode() = default;
+	const NodeKind kind;
+
+	explicit ASTNode(NodeKind kind) : kind(kind) {}
 	virtual void accept(Visitor&) = 0;
+
+protected:
+	// узлы живут в арене и не удаляются по отдельности, поэтому деструктор тривиален
+	~ASTNode() = default;
 };
 
+// dynamic_cast к конкретному классу узла (или декларатора) по тегу вида
+template<typename T, typename Node>
+T* node_cast(Node* node) {
+	return node && node->kind == T::node_kind ? static_cast<T*>(node) : nullptr;
+}
+
+template<typename T, typename Node>
+const T* node_cast(const Node* node) {
+	return node && node->kind == T::node_kind ? static_cast<const T*>(node) : nullptr;
+}
+
+// виды выражений идут в NodeKind подряд, от BinaryOperation до NameSpaceAcceptExpression
+constexpr bool is_expression(NodeKind kind) {
+	return kind >= NodeKind::BinaryOperation && kind <= NodeKind::NameSpaceAcceptExpression;
+}
+
 struct Statement: public ASTNode {
-	virtual ~Statement() = default;
+	using ASTNode::ASTNode;
 	virtual void accept(Visitor&) override = 0;
 };
 
 struct Declaration: public ASTNode {
-	virtual ~Declaration() = default;
+	using ASTNode::ASTNode;
 	virtual void accept(Visitor&) override = 0;
 
 	struct Declarator;
@@ -28,14 +99,21 @@ struct Declaration: public ASTNode {
 };
 
 struct Expression: public ASTNode {
-	virtual ~Expression() = default;
+	using ASTNode::ASTNode;
 	virtual void accept(Visitor&) override = 0;
 };
 
-struct TranslationUnit : public ASTNode {
-    std::vector<std::shared_ptr<ASTNode>> declarations;
-	std::vector<std::shared_ptr<ASTNode>>& get_nodes();
+// дочерние узлы лежат в арене единицы трансляции; список — непрерывный массив там же
+template<typename T>
+using node_list = std::span<T*>;
+
+struct TranslationUnit final : public ASTNode {
+	static constexpr NodeKind node_kind = NodeKind::TranslationUnit;
+    node_list<ASTNode> declarations;
+	node_list<ASTNode>& get_nodes();
+    // владеет всеми узлами дерева
+    std::unique_ptr<Arena> arena;
 
-    TranslationUnit(const std::vector<std::shared_ptr<ASTNode>>& declarations);
+    TranslationUnit(node_list<ASTNode> declarations, std::unique_ptr<Arena> arena);
     void accept(Visitor& visitor) override;
 };
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+#include "ast.hpp"
+
+// Кэш разобранных деревьев на диске. Ключ — хеш текста программы и версии интерпретатора,
+// при попадании лексер и парсер не запускаются.
+//
+// Файл кэша не содержит указателей: заголовок, таблица имён и узлы в прямом порядке обхода,
+// дети ссылаются на имена по номеру в таблице. Файл отображается через mmap и читается
+// за один линейный проход в новую арену.
+class AstCache {
+public:
+    // $CPP_INTERPRETER_CACHE, иначе $XDG_CACHE_HOME/cpp-interpreter, иначе ~/.cache/cpp-interpreter;
+    // пустой путь, если ни одна переменная не задана
+    static std::filesystem::path default_directory();
+
+    // пустой каталог выключает кэш: load ничего не находит, store ничего не пишет
+    explicit AstCache(std::filesystem::path directory);
+
+    // дерево, сохранённое для этого текста, или nullptr; повреждённый файл считается промахом
+    std::unique_ptr<TranslationUnit> load(std::string_view source) const;
+
+    // сохранить дерево; ошибки записи не мешают работе, кэш просто не пополняется
+    void store(std::string_view source, TranslationUnit& unit) const;
+
+private:
+    std::filesystem::path entry(std::uint64_t key) const;
+
+    std::filesystem::path directory;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "value.hpp"
+#include "symbol.hpp"
+#include "type.hpp"
+
+// Регистровый байткод. Регистры функции — окно стека значений,
+// параметры занимают регистры 0..n-1, результат вызова возвращается в регистр 0 окна.
+// Операнды: a — обычно регистр результата, b и c — регистры/индексы.
+enum class OpCode : std::uint8_t {
+    Move,       // r[a] = r[b]
+    LoadConst,  // r[a] = constants[b]
+    Convert,    // r[a] = r[b], приведённое к ValueKind(c)
+    GetGlobal,  // r[a] = globals[b] (глобальные переменные — регистры окна entry)
+    SetGlobal,  // globals[a] = r[b]
+
+    Add,        // r[a] = r[b] + r[c]
+    Sub,
+    Mul,
+    Div,
+    Mod,
+    ShiftLeft,
+    ShiftRight,
+    BitAnd,
+    BitOr,
+    BitXor,
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    Negate,     // r[a] = -r[b]
+    Plus,       // r[a] = +r[b]
+    Not,        // r[a] = !r[b]
+    Test,       // r[a] = bool(r[b])
+    Increment,  // r[a] = r[a] + 1 с сохранением тега
+    Decrement,  // r[a] = r[a] - 1 с сохранением тега
+
+    Jump,         // pc = a
+    JumpIfFalse,  // if (!r[a]) pc = b
+    JumpIfTrue,   // if (r[a]) pc = b
+
+    Box,        // boxes[b] = новая переменная (boxes info c), r[a] = её адрес
+    Array,      // boxes[b] = массив длины r[a] (boxes info c), r[a] = адрес нулевого элемента
+    NewStruct,  // boxes[b] = экземпляр структуры c, r[a] = экземпляр
+    Address,    // r[a] = адрес переменной boxes[b]
+    CopyStruct, // поля r[a] = поля r[b]
+    Load,       // r[a] = *r[b]
+    Store,      // *r[a] = r[b] (с преобразованием к типу ячейки)
+    Field,      // r[a] = адрес поля names[c] экземпляра r[b]
+
+    Call,       // вызов functions[b] с c аргументами в r[a..a+c), результат в r[a]
+    Return,     // возврат r[a] (a < 0 — без значения)
+    Print,      // печать r[a..a+b), r[a] = 0
+    Read,       // r[a] = значение типа ValueKind(b) из stdin
+};
+
+struct Instruction {
+    OpCode op;
+    std::int32_t a = 0;
+    std::int32_t b = 0;
+    std::int32_t c = 0;
+};
+
+// скомпилированная функция (или метод: тогда регистр 0 — this)
+struct Function {
+    std::string name;
+    std::vector<Instruction> code;
+    int num_params = 0;
+    int num_registers = 0;
+    int num_boxes = 0;
+};
+
+// описание переменной, живущей вне регистров (массив или переменная, чей адрес берут)
+struct BoxInfo {
+    std::shared_ptr<Type> type;
+    Value init;
+};
+
+struct Program {
+    std::vector<Function> functions;
+    std::vector<Value> constants;
+    std::vector<Name> names;
+    std::vector<BoxInfo> boxes;
+    std::vector<std::shared_ptr<StructSymbol>> structs;  // шаблоны экземпляров
+    int entry = 0;  // функция, инициализирующая глобальные переменные и вызывающая main
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "visitor.hpp"
+#include "bytecode.hpp"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <string>
+#include <memory>
+
+// Переводит проанализированное дерево в регистровый байткод для VM.
+class Compiler : public Visitor {
+public:
+    Compiler();
+
+    Program compile(TranslationUnit& unit);
+
+    void visit(ASTNode&) override;
+    void visit(TranslationUnit& unit) override;
+    void visit(Declaration::PtrDeclarator&) override;
+    void visit(Declaration::SimpleDeclarator&) override;
+    void visit(Declaration::InitDeclarator&) override;
+    void visit(VarDeclaration&) override;
+    void visit(ParameterDeclaration&) override;
+    void visit(FuncDeclaration&) override;
+    void visit(StructDeclaration&) override;
+    void visit(ArrayDeclaration&) override;
+    void visit(NameSpaceDeclaration&) override;
+
+    void visit(CompoundStatement&) override;
+    void visit(DeclarationStatement&) override;
+    void visit(ExpressionStatement&) override;
+    void visit(ConditionalStatement&) override;
+    void visit(WhileStatement&) override;
+    void visit(ForStatement&) override;
+    void visit(ReturnStatement&) override;
+    void visit(BreakStatement&) override;
+    void visit(ContinueStatement&) override;
+    void visit(StructMemberAccessExpression&) override;
+    void visit(DoWhileStatement&) override;
+
+    void visit(BinaryOperation&) override;
+    void visit(PrefixExpression&) override;
+    void visit(PostfixIncrementExpression&) override;
+    void visit(PostfixDecrementExpression&) override;
+    void visit(FunctionCallExpression&) override;
+    void visit(SubscriptExpression&) override;
+    void visit(IntLiteral&) override;
+    void visit(FloatLiteral&) override;
+    void visit(CharLiteral&) override;
+    void visit(StringLiteral&) override;
+    void visit(BoolLiteral&) override;
+    void visit(NullPtrLiteral&) override;
+    void visit(IdentifierExpression&) override;
+    void visit(ParenthesizedExpression&) override;
+    void visit(TernaryExpression&) override;
+    void visit(SizeOfExpression&) override;
+    void visit(NameSpaceAcceptExpression&) override;
+    void visit(StaticAssertStatement&) override;
+
+private:
+    // переменная, видимая компилятору
+    struct Local {
+        Name name;
+        int reg;
+        std::shared_ptr<Type> type;
+        bool boxed;     // в регистре лежит адрес переменной
+        bool array;     // в регистре лежит адрес нулевого элемента
+    };
+
+    // куда записывать: регистр, глобальная переменная или адрес в регистре
+    struct LValue {
+        enum Kind { Register, Global, Pointer } kind;
+        int index;
+        std::shared_ptr<Type> type;
+    };
+
+    struct StructInfo {
+        Name name;
+        std::shared_ptr<StructType> type;
+        StructDeclaration* declaration;
+        int index;                                      // Program::structs
+        std::unordered_map<Name, int> methods;   // имя -> Program::functions
+    };
+
+    struct FunctionInfo {
+        int index;
+        std::shared_ptr<Type> returns;
+        std::vector<std::shared_ptr<Type>> params;
+    };
+
+    struct Loop {
+        std::vector<int> breaks;
+        std::vector<int> continues;
+    };
+
+    // состояние компилируемой функции
+    struct FunctionState {
+        int index = 0;
+        std::vector<Local> locals;
+        int locals_top = 0;     // первый регистр, свободный от локальных переменных
+        int next_reg = 0;
+        std::vector<size_t> blocks;     // число локальных переменных на входе в блок
+        std::vector<Loop> loops;
+    };
+
+    Function& current();
+    int emit(OpCode op, int a = 0, int b = 0, int c = 0);
+    int here();
+    void patch(int at, int target);
+    int temp();
+    void release();
+    int constant(const Value& v);
+    int name_index(Name name);
+
+    void declare(Name name, int reg, const std::shared_ptr<Type>& type, bool boxed, bool array);
+    int box_slot(const std::shared_ptr<Type>& type, const Value& init);
+    const Local* find_local(const FunctionState& scope, Name name) const;
+    Name qualified(Name name) const;
+    const FunctionInfo* find_function(Name name) const;
+    StructInfo* find_struct(const std::shared_ptr<Type>& type);
+    std::shared_ptr<Type> resolve_type(Name name, Declaration::Declarator* declarator);
+
+    // вычислить выражение; target >= 0 — результат нужен именно в этом регистре
+    int compile_expr(Expression& node, int target = -1);
+    LValue compile_lvalue(Expression& node);
+    LValue variable(Name name, bool scoped);
+    int load(const LValue& lv, int target = -1);
+    int store(const LValue& lv, int reg, const std::shared_ptr<Type>& from);
+    int convert(int reg, const std::shared_ptr<Type>& from, const std::shared_ptr<Type>& to, int target);
+    int field_address(Expression& base, Name member, std::shared_ptr<Type>& type);
+    void call(const FunctionInfo& func, node_list<Expression> args, int self);
+    void increment(Expression& base, bool prefix, OpCode op);
+    void compile_function(FuncDeclaration& node, const FunctionInfo& info, StructInfo* owner);
+    void push_block();
+    void pop_block();
+
+    Program program;
+    FunctionState root;
+    FunctionState* state = nullptr;
+    StructInfo* current_struct = nullptr;      // структура, метод которой компилируется
+    std::string ns_prefix;
+
+    std::unordered_map<Name, FunctionInfo> functions;
+    std::unordered_map<Name, StructInfo> structs;
+    std::unordered_set<Name> address_taken;
+
+    // результат последнего скомпилированного выражения
+    int target = -1;
+    int result_reg = -1;
+    std::shared_ptr<Type> result_type;
+};
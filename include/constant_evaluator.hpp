@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "walker.hpp"
+#include "value.hpp"
+
+// значения const-переменных в местах их использования (IdentifierExpression -> значение), их находит Analyzer
+using ConstantNames = std::unordered_map<const Expression*, Value>;
+// вызываемая функция для каждого вызова f(...) свободной функции с телом, её находит Analyzer
+using ConstantCalls = std::unordered_map<const Expression*, const FuncDeclaration*>;
+
+// Вычисление вызова функции до исполнения. Тело интерпретируется над параметрами и локальными
+// переменными кадра (слоты Analyzer) с теми же binary_operation/unary_operation и store, что у Execute.
+// Функция считается чистой, пока тело обращается только к ним, const-переменным и другим таким функциям;
+// глобальные переменные, массивы, указатели, структуры, print/read прерывают вычисление.
+// Число шагов и глубина вызовов ограничены: вызов, не уложившийся в бюджет, остаётся исполнителю.
+class ConstantEvaluator : public Walker<ConstantEvaluator> {
+public:
+    ConstantEvaluator(const ConstantNames& names, const ConstantCalls& calls);
+
+    // результат вызова или nullopt, если его можно получить только при исполнении
+    std::optional<Value> call(const FuncDeclaration&, const std::vector<Value>& args);
+
+public:
+    // всё, что не разобрано ниже, вычисляется только при исполнении
+    void visit(ASTNode&);
+
+    void visit(VarDeclaration&);
+
+    void visit(CompoundStatement&);
+    void visit(DeclarationStatement&);
+    void visit(ExpressionStatement&);
+    void visit(ConditionalStatement&);
+    void visit(WhileStatement&);
+    void visit(DoWhileStatement&);
+    void visit(ForStatement&);
+    void visit(ReturnStatement&);
+    void visit(BreakStatement&);
+    void visit(ContinueStatement&);
+
+    void visit(BinaryOperation&);
+    void visit(PrefixExpression&);
+    void visit(PostfixIncrementExpression&);
+    void visit(PostfixDecrementExpression&);
+    void visit(FunctionCallExpression&);
+    void visit(IdentifierExpression&);
+    void visit(IntLiteral&);
+    void visit(FloatLiteral&);
+    void visit(CharLiteral&);
+    void visit(BoolLiteral&);
+    void visit(ParenthesizedExpression&);
+    void visit(TernaryExpression&);
+
+private:
+    enum class Completion { Normal, Break, Continue, Return };
+
+    Value evaluate(Expression&);
+    Value invoke(const FuncDeclaration&, const std::vector<Value>& args);
+    // ячейка локальной переменной, которую обозначает выражение
+    Value& local(Expression&);
+    bool leave_loop();
+    void step();
+
+    const ConstantNames& names;
+    const ConstantCalls& calls;
+    std::vector<Value>* frame = nullptr;
+    Value result;
+    Value return_value;
+    Completion completion = Completion::Normal;
+    std::size_t steps = 0;
+    std::size_t budget = 0;
+    std::size_t depth = 0;
+};
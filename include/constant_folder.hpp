@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include "constant_evaluator.hpp"
+
+// Свёртка констант после анализа: подвыражения из литералов, const-переменных, сравнений,
+// тернарных операторов, sizeof и вызовов чистых функций (ConstantEvaluator) заменяются литералами.
+// Операторы вычисляются теми же binary_operation/unary_operation, что и при исполнении,
+// поэтому результат не меняется.
+// Без арены дерево не меняется: evaluate только вычисляет выражение (static_assert, размер массива).
+class ConstantFolder : public Walker<ConstantFolder> {
+public:
+    ConstantFolder(const ConstantNames& names, const ConstantCalls& calls, Arena* arena = nullptr);
+
+    void fold(TranslationUnit&);
+    void fold(FuncDeclaration&);
+    // значение выражения, если оно известно до исполнения
+    std::optional<Value> evaluate(Expression&);
+    // сколько выражений заменено литералами
+    std::size_t folded() const { return replaced; }
+
+public:
+    void visit(ASTNode&);
+    void visit(TranslationUnit&);
+
+    void visit(VarDeclaration&);
+    void visit(ParameterDeclaration&);
+    void visit(FuncDeclaration&);
+    void visit(StructDeclaration&);
+    void visit(ArrayDeclaration&);
+    void visit(NameSpaceDeclaration&);
+
+    void visit(CompoundStatement&);
+    void visit(DeclarationStatement&);
+    void visit(ExpressionStatement&);
+    void visit(ConditionalStatement&);
+    void visit(WhileStatement&);
+    void visit(DoWhileStatement&);
+    void visit(ForStatement&);
+    void visit(ReturnStatement&);
+    void visit(BreakStatement&);
+    void visit(ContinueStatement&);
+    void visit(StaticAssertStatement&);
+
+    void visit(BinaryOperation&);
+    void visit(PrefixExpression&);
+    void visit(PostfixIncrementExpression&);
+    void visit(PostfixDecrementExpression&);
+    void visit(FunctionCallExpression&);
+    void visit(SubscriptExpression&);
+    void visit(StructMemberAccessExpression&);
+    void visit(IdentifierExpression&);
+    void visit(IntLiteral&);
+    void visit(FloatLiteral&);
+    void visit(CharLiteral&);
+    void visit(StringLiteral&);
+    void visit(BoolLiteral&);
+    void visit(NullPtrLiteral&);
+    void visit(ParenthesizedExpression&);
+    void visit(TernaryExpression&);
+    void visit(SizeOfExpression&);
+    void visit(NameSpaceAcceptExpression&);
+
+private:
+    // свернуть выражение в ячейке: сначала подвыражения, затем само выражение
+    void fold(Expression*& slot);
+    // подвыражения выражения, которое обозначает ячейку (операнд &, ++, присваивания):
+    // само оно остаётся на месте, даже если это const-переменная
+    void fold_operands(Expression& lvalue);
+    Expression* make_literal(const Value&);
+
+    const ConstantNames& names;
+    const ConstantCalls& calls;
+    Arena* arena;
+    std::size_t replaced = 0;
+    // значение последнего обойдённого выражения; nullopt — известно только при исполнении
+    std::optional<Value> value;
+};
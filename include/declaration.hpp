@@ -5,104 +5,124 @@
 #include <memory>
 
 #include "ast.hpp"
+#include "name.hpp"
+#include "token.hpp"
 
 struct CompoundStatement;
 
 
 struct Declaration:: Declarator {
-	std::string name;
-	Declarator(const std::string&);
+	const NodeKind kind;
+	Name name;
+	Declarator(NodeKind, Name);
 
-	virtual ~Declarator() = default;
 	virtual void accept(Visitor&) = 0;
+
+protected:
+	~Declarator() = default;
 };
 
 struct Declaration::SimpleDeclarator : public Declaration::Declarator{
-	using Declarator::Declarator;
+	static constexpr NodeKind node_kind = NodeKind::SimpleDeclarator;
+
+	SimpleDeclarator(Name);
 
 	void accept(Visitor&) override;
 };
 
 struct Declaration::PtrDeclarator : public Declaration::Declarator{
-	std::shared_ptr<Declarator> inner;
+	static constexpr NodeKind node_kind = NodeKind::PtrDeclarator;
+	Declarator* inner = nullptr;
 
-	PtrDeclarator(const std::shared_ptr<Declarator>&);
+	PtrDeclarator(Declarator*);
 	void accept(Visitor&) override;
 };
 
 struct Declaration::InitDeclarator {
-	std::shared_ptr<Declarator> declarator;
-	std::shared_ptr<Expression> initializer;
+	Declarator* declarator = nullptr;
+	Expression* initializer = nullptr;
+	int slot = -1; // слот объявляемой переменной в её области видимости
 
-	InitDeclarator(const std::shared_ptr<Declarator>&, const std::shared_ptr<Expression>&);
+	InitDeclarator(Declarator*, Expression*);
 	void accept(Visitor&);
 };
 
 struct VarDeclaration: public Declaration {
+	static constexpr NodeKind node_kind = NodeKind::VarDeclaration;
 	bool is_const = false; // std::vector<std::string> modifiers
-	std::string type;
-	std::vector<std::shared_ptr<InitDeclarator>> declarator_list;
+	Name type;
+	node_list<InitDeclarator> declarator_list;
 
-	VarDeclaration(bool is_const, const std::string&, const std::vector<std::shared_ptr<InitDeclarator>>&);
+	VarDeclaration(bool is_const, Name, node_list<InitDeclarator>);
 	void accept(Visitor&) override;
 };
 
 struct ParameterDeclaration: public Declaration {
-	std::string type;
-	std::shared_ptr<InitDeclarator> init_declarator;
+	static constexpr NodeKind node_kind = NodeKind::ParameterDeclaration;
+	Name type;
+	InitDeclarator* init_declarator = nullptr;
 
-	ParameterDeclaration(const std::string&, const std::shared_ptr<InitDeclarator>&);
+	ParameterDeclaration(Name, InitDeclarator*);
 	void accept(Visitor&) override;
 };
 
 struct FuncDeclaration: public Declaration {
+	static constexpr NodeKind node_kind = NodeKind::FuncDeclaration;
 	bool is_const = false; //std::vector<std::string> modifiers
-	std::string type;
-	std::shared_ptr<Declarator> declarator;
+	Name type;
+	Declarator* declarator = nullptr;
 	bool is_readonly = false;
-	std::vector<std::shared_ptr<ParameterDeclaration>> args;
-	std::shared_ptr<CompoundStatement> body;
+	node_list<ParameterDeclaration> args;
+	CompoundStatement* body = nullptr;
+	// лексемы неразобранного тела после «{» (ленивый разбор); пусто, когда тело разобрано
+	std::span<const Token> deferred_body;
+	int frame_size = -1; // число слотов кадра активации; -1 — тело не анализировалось
+	bool is_constexpr = false;
 
 	FuncDeclaration(
 					bool is_const,
-					const std::string&,
-					const std::shared_ptr<Declarator>&,
+					Name,
+					Declarator*,
 					bool is_readonly,
-					const std::vector<std::shared_ptr<ParameterDeclaration>>&,
-					const std::shared_ptr<CompoundStatement>&
+					node_list<ParameterDeclaration>,
+					CompoundStatement*
 					);
 
 	void accept(Visitor&) override;
 };
 
 struct StructDeclaration: public Declaration {
-	std::string name;
-	std::vector<std::shared_ptr<Declaration>> members;
-	StructDeclaration(const std::string& name, 
-						const std::vector<std::shared_ptr<Declaration>>& members);
+	static constexpr NodeKind node_kind = NodeKind::StructDeclaration;
+	Name name;
+	node_list<Declaration> members;
+	StructDeclaration(Name name, 
+						node_list<Declaration> members);
 
 	void accept(Visitor&) override;
 
 };
 
 struct ArrayDeclaration: public Declaration { 
- 	std::string type;
-	std::string name;
-	std::shared_ptr<Expression> size;
-	std::vector<std::shared_ptr<Expression>> initializer_list;
-
+	static constexpr NodeKind node_kind = NodeKind::ArrayDeclaration;
+ 	Name type;
+	Name name;
+	Expression* size = nullptr;
+	node_list<Expression> initializer_list;
+	int slot = -1;
+	int length = -1; // число элементов, вычисленное Analyzer; -1 — размер известен только при исполнении
 
-	ArrayDeclaration(const std::string& type, const std::string& name, const std::shared_ptr<Expression>& size, 
-					const std::vector<std::shared_ptr<Expression>>& initializer_list);
+	ArrayDeclaration(Name type, Name name, Expression* size, 
+					node_list<Expression> initializer_list);
 
     void accept(Visitor &visitor) override;
 };
 
 struct NameSpaceDeclaration : public Declaration{
-	std::string name;
-	std::vector<std::shared_ptr<Declaration>> declarations;
+	static constexpr NodeKind node_kind = NodeKind::NameSpaceDeclaration;
+	Name name;
+	node_list<Declaration> declarations;
 
-	NameSpaceDeclaration(const std::string& name, const std::vector<std::shared_ptr<Declaration>>& declarations);
+	NameSpaceDeclaration(Name name, node_list<Declaration> declarations);
 
 	void accept(Visitor&) override;
 };
@@ -112,13 +132,13 @@ struct NameSpaceDeclaration : public Declaration{
 
 
 
-using node = std::shared_ptr<TranslationUnit>;
-using declaration = std::shared_ptr<Declaration>;
-using func_declaration = std::shared_ptr<FuncDeclaration>;
-using parameter_declaration = std::shared_ptr<ParameterDeclaration>;
-using var_declaration = std::shared_ptr<VarDeclaration>;
-using init_declarator = std::shared_ptr<Declaration::InitDeclarator>;
-using declarator = std::shared_ptr<Declaration::Declarator>;
-using struct_declaration = std::shared_ptr<StructDeclaration>;
-using array_declaration = std::shared_ptr<ArrayDeclaration>;
-using name_space_declaration = std::shared_ptr<NameSpaceDeclaration>;
\ No newline at end of file
+using node = TranslationUnit*;
+using declaration = Declaration*;
+using func_declaration = FuncDeclaration*;
+using parameter_declaration = ParameterDeclaration*;
+using var_declaration = VarDeclaration*;
+using init_declarator = Declaration::InitDeclarator*;
+using declarator = Declaration::Declarator*;
+using struct_declaration = StructDeclaration*;
+using array_declaration = ArrayDeclaration*;
+using name_space_declaration = NameSpaceDeclaration*;
\ No newline at end of file
@@ -1,77 +1,118 @@
 #pragma once
 
-#include "visitor.hpp"
+#include "walker.hpp"
 #include "symbol.hpp"
 #include "scope.hpp"
+#include "value.hpp"
 
-#include <any>
+#include <functional>
 #include <unordered_map>
 #include <vector>
 #include <string>
 #include <memory>
 
-class Execute : public Visitor {
+class Execute : public Walker<Execute> {
 public:
     Execute();
     ~Execute();
 
     void execute(TranslationUnit& unit);
-    void visit(ASTNode&) override;
-    void visit(TranslationUnit& unit) override;
-    void visit(Declaration::PtrDeclarator&) override;
-    void visit(Declaration::SimpleDeclarator&) override;
-    void visit(Declaration::InitDeclarator&) override;
-    void visit(VarDeclaration&) override;
-    void visit(ParameterDeclaration&) override;
-    void visit(FuncDeclaration&) override;
-    void visit(StructDeclaration&) override;
-    void visit(ArrayDeclaration&) override;
-    void visit(NameSpaceDeclaration&) override;
+    void visit(ASTNode&);
+    void visit(TranslationUnit& unit);
+    void visit(Declaration::PtrDeclarator&);
+    void visit(Declaration::SimpleDeclarator&);
+    void visit(Declaration::InitDeclarator&);
+    void visit(VarDeclaration&);
+    void visit(ParameterDeclaration&);
+    void visit(FuncDeclaration&);
+    void visit(StructDeclaration&);
+    void visit(ArrayDeclaration&);
+    void visit(NameSpaceDeclaration&);
 
-    void visit(CompoundStatement&) override;
-    void visit(DeclarationStatement&) override;
-    void visit(ExpressionStatement&) override;
-    void visit(ConditionalStatement&) override;
-    void visit(WhileStatement&) override;
-    void visit(ForStatement&) override;
-    void visit(ReturnStatement&) override;
-    void visit(BreakStatement&) override;
-    void visit(ContinueStatement&) override;
-    void visit(StructMemberAccessExpression&) override;
-    void visit(DoWhileStatement&) override;
+    void visit(CompoundStatement&);
+    void visit(DeclarationStatement&);
+    void visit(ExpressionStatement&);
+    void visit(ConditionalStatement&);
+    void visit(WhileStatement&);
+    void visit(ForStatement&);
+    void visit(ReturnStatement&);
+    void visit(BreakStatement&);
+    void visit(ContinueStatement&);
+    void visit(DoWhileStatement&);
 
-    void visit(BinaryOperation&) override;
-    void visit(PrefixExpression&) override;
-    void visit(PostfixIncrementExpression&) override;
-    void visit(PostfixDecrementExpression&) override;
-    void visit(FunctionCallExpression&) override;
-    void visit(SubscriptExpression&) override;
-    void visit(IntLiteral&) override;
-    void visit(FloatLiteral&) override;
-    void visit(CharLiteral&) override;
-    void visit(StringLiteral&) override;
-    void visit(BoolLiteral&) override;
-    void visit(NullPtrLiteral&) override;
-    void visit(IdentifierExpression&) override;
-    void visit(ParenthesizedExpression&) override;
-    void visit(TernaryExpression&) override;
-    void visit(SizeOfExpression&) override;
-    void visit(NameSpaceAcceptExpression&) override;
-    void visit(StaticAssertStatement&) override;
+    // выражения возвращают своё значение; ячейку lvalue оставляют в current_ref
+    Value visit(StructMemberAccessExpression&);
+    Value visit(BinaryOperation&);
+    Value visit(PrefixExpression&);
+    Value visit(PostfixIncrementExpression&);
+    Value visit(PostfixDecrementExpression&);
+    Value visit(FunctionCallExpression&);
+    Value visit(SubscriptExpression&);
+    Value visit(IntLiteral&);
+    Value visit(FloatLiteral&);
+    Value visit(CharLiteral&);
+    Value visit(StringLiteral&);
+    Value visit(BoolLiteral&);
+    Value visit(NullPtrLiteral&);
+    Value visit(IdentifierExpression&);
+    Value visit(ParenthesizedExpression&);
+    Value visit(TernaryExpression&);
+    Value visit(SizeOfExpression&);
+    Value visit(NameSpaceAcceptExpression&);
+    void visit(StaticAssertStatement&);
 
     std::shared_ptr<Scope> symbolTable;
+    // разбор и проверка отложенного тела функции при первом вызове (ленивый разбор)
+    std::function<void(FuncDeclaration&)> load_body;
 
 private:
 
-    std::shared_ptr<Symbol> match_symbol (const std::string& token);
+    std::shared_ptr<Symbol> match_symbol (Name token);
     bool is_record_type(const std::shared_ptr<Type>& type);
-    bool count_bool(std::any, std::string&, std::any);
-    std::shared_ptr<VarSymbol> binary_operation(std::shared_ptr<VarSymbol>, std::string&, std::shared_ptr<VarSymbol>);
-    std::shared_ptr<VarSymbol> unary_operation(std::shared_ptr<VarSymbol>, std::string&);
-    std::shared_ptr<VarSymbol> postfix_operation(std::shared_ptr<VarSymbol>, std::string&);
+    Value postfix_operation(const Ref&, Operator);
     bool can_convert(const std::shared_ptr<Type>& from, const std::shared_ptr<Type>& to);
 
-    std::shared_ptr<Symbol> current_value;
+    // вычисление выражения как rvalue и как lvalue
+    Value evaluate(Expression&);
+    Ref locate(Expression&);
+    // аргументы вызова — значения arguments начиная с first; вызов снимает их со стека
+    Value call_function(FuncSymbol&, std::size_t first, StructSymbol* instance);
+    void ensure_body(FuncDeclaration&);
+    std::shared_ptr<StructSymbol> instantiate(Name typeName, const std::shared_ptr<StructType>&);
+
+    // глобальная область: от неё отсчитываются области видимости вызываемых функций
+    std::shared_ptr<Scope> globals;
+
+    // стек кадров активации: слоты функции лежат подряд в блоках фиксированного размера
+    // и переиспользуются следующими вызовами, поэтому вызов не выделяет память
+    struct FrameStack {
+        static constexpr std::size_t block_size = 1024;
+        std::vector<std::vector<VarSymbol>> blocks;
+        std::size_t block = 0;
+        std::size_t top = 0;
+
+        VarSymbol* push(int size);
+    };
+    FrameStack frames;
+    // значения аргументов вычисляемых вызовов; память переиспользуется, вызов её не выделяет
+    std::vector<Value> arguments;
+    // кадр выполняемой функции; nullptr — глобальный код
+    VarSymbol* frame = nullptr;
+    // экземпляр, метод которого выполняется: его поля и методы — имена с IdentifierExpression::member
+    StructSymbol* self = nullptr;
+
+    // переменная, которую обозначает выражение (nullptr для rvalue)
+    Ref current_ref;
+    // функция или пространство имён, которое обозначает выражение
+    std::shared_ptr<Symbol> current_symbol;
+
+    // способ завершения последнего выполненного оператора
+    enum class Completion { Normal, Break, Continue, Return };
+    Completion completion = Completion::Normal;
+    // значение, переданное в return
+    Value return_value;
+    // сбрасывает break/continue после тела цикла; true — цикл нужно покинуть
+    bool leave_loop();
     std::vector<std::shared_ptr<FuncType>> matched_functions;
-    static std::unordered_map<std::string, std::shared_ptr<Symbol>> default_types;
+    static std::unordered_map<Name, std::shared_ptr<Symbol>> default_types;
 };
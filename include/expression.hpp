@@ -1,171 +1,202 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 
 #include "ast.hpp"
+#include "operator.hpp"
+#include "name.hpp"
 
 
 
 struct BinaryExpression: public Expression {
-	virtual ~BinaryExpression() = default;
+	using Expression::Expression;
 	virtual void accept(Visitor&) override = 0;
 
 };
 
 struct BinaryOperation: public BinaryExpression {
-	std::string op;
-	std::shared_ptr<Expression> lhs, rhs;
+	static constexpr NodeKind node_kind = NodeKind::BinaryOperation;
+	Operator op;
+	Expression* lhs = nullptr;
+	Expression* rhs = nullptr;
 
-	BinaryOperation(std::string, std::shared_ptr<Expression>, std::shared_ptr<Expression>);
+	BinaryOperation(Operator, Expression*, Expression*);
 	void accept(Visitor&) override;
 };
 
 struct UnaryExpression: public Expression {
-	virtual ~UnaryExpression() = default;
+	using Expression::Expression;
 	virtual void accept(Visitor&) override = 0;
 };
 
 struct PrefixExpression: public UnaryExpression {
-	std::string op;
-	std::shared_ptr<Expression> base;
+	static constexpr NodeKind node_kind = NodeKind::PrefixExpression;
+	Operator op;
+	Expression* base = nullptr;
 
-	PrefixExpression(std::string, std::shared_ptr<Expression>);
+	PrefixExpression(Operator, Expression*);
 	void accept(Visitor&) override;
 };
 
 
 struct PostfixExpression: public UnaryExpression {
-	virtual ~PostfixExpression() = default;
+	using UnaryExpression::UnaryExpression;
 	virtual void accept(Visitor&) override = 0;
 };
 
 struct FunctionCallExpression: public PostfixExpression {
-	std::shared_ptr<Expression> base;
-	std::vector<std::shared_ptr<Expression>> args;
+	static constexpr NodeKind node_kind = NodeKind::FunctionCallExpression;
+	Expression* base = nullptr;
+	node_list<Expression> args;
 
-	FunctionCallExpression(std::shared_ptr<Expression>, const std::vector<std::shared_ptr<Expression>>&);
+	FunctionCallExpression(Expression*, node_list<Expression>);
 	void accept(Visitor&) override;
 };
 
 
 struct PostfixIncrementExpression: public PostfixExpression {
-	std::shared_ptr<Expression> base;
+	static constexpr NodeKind node_kind = NodeKind::PostfixIncrementExpression;
+	Expression* base = nullptr;
 
-	PostfixIncrementExpression(std::shared_ptr<Expression>);
+	PostfixIncrementExpression(Expression*);
 	void accept(Visitor&) override;
 };
 
 struct PostfixDecrementExpression: public PostfixExpression {
-	std::shared_ptr<Expression> base;
+	static constexpr NodeKind node_kind = NodeKind::PostfixDecrementExpression;
+	Expression* base = nullptr;
 
-	PostfixDecrementExpression(std::shared_ptr<Expression>);
+	PostfixDecrementExpression(Expression*);
 	void accept(Visitor&) override;
 };
 
 struct PrimaryExpression: public PostfixExpression {
-	virtual ~PrimaryExpression() = default;
+	using PostfixExpression::PostfixExpression;
 	virtual void accept(Visitor&) override = 0;
 };
 
 struct IdentifierExpression: public PrimaryExpression {
-	std::string name;
+	static constexpr NodeKind node_kind = NodeKind::IdentifierExpression;
+	Name name;
+	// адрес, найденный Analyzer: сколько областей видимости подняться и номер слота в ней
+	int depth = -1;
+	int slot = -1;
+	// поле или метод экземпляра в теле метода: ищется в self, а не по (depth, slot)
+	bool member = false;
 
-	IdentifierExpression(const std::string&);
+	IdentifierExpression(Name);
 	void accept(Visitor&) override;
 };
 
 struct LiteralExpression: public PrimaryExpression {
-	virtual ~LiteralExpression() = default;
+	using PrimaryExpression::PrimaryExpression;
 	virtual void accept(Visitor&) override = 0;
 };
 
 
 struct IntLiteral: public LiteralExpression {
+	static constexpr NodeKind node_kind = NodeKind::IntLiteral;
 	int value;
 
 	IntLiteral(const std::string&);
+	explicit IntLiteral(int);
 	void accept(Visitor&) override;
 };
 
 struct FloatLiteral: public LiteralExpression {
-	float value;
+	static constexpr NodeKind node_kind = NodeKind::FloatLiteral;
+	double value;   // текст литерала читается как float, свёрнутые значения хранятся точно
 
 	FloatLiteral(const std::string&);
+	explicit FloatLiteral(double);
 	void accept(Visitor&) override;
 };
 
 struct CharLiteral: public LiteralExpression {
+	static constexpr NodeKind node_kind = NodeKind::CharLiteral;
 	char value;
 
 	CharLiteral(const std::string&);
+	explicit CharLiteral(char);
 	void accept(Visitor&) override;
 };
 
 struct StringLiteral: public LiteralExpression {
-	std::string value;
+	static constexpr NodeKind node_kind = NodeKind::StringLiteral;
+	std::string_view value; // текст в арене
 
-	StringLiteral(const std::string&);
+	explicit StringLiteral(std::string_view);
 	void accept(Visitor&) override;
 };
 
 struct BoolLiteral: public LiteralExpression {
+	static constexpr NodeKind node_kind = NodeKind::BoolLiteral;
 	bool value;
 
 	BoolLiteral(const std::string&);
+	explicit BoolLiteral(bool);
 	void accept(Visitor&) override;
 };
 
 struct NullPtrLiteral: public LiteralExpression{
-	
+	static constexpr NodeKind node_kind = NodeKind::NullPtrLiteral;
+
+	NullPtrLiteral();
 	void accept(Visitor&) override;
 };
 
 struct ParenthesizedExpression: public PrimaryExpression {
-	std::shared_ptr<Expression> expression;
+	static constexpr NodeKind node_kind = NodeKind::ParenthesizedExpression;
+	Expression* expression = nullptr;
 
-	ParenthesizedExpression(std::shared_ptr<Expression>);
+	ParenthesizedExpression(Expression*);
 	void accept(Visitor&) override;
 };
 
 
 struct StructMemberAccessExpression : public PostfixExpression {
-	std::shared_ptr<Expression> base;
-	std::string member;
+	static constexpr NodeKind node_kind = NodeKind::StructMemberAccessExpression;
+	Expression* base = nullptr;
+	Name member;
 
-	StructMemberAccessExpression(std::shared_ptr<Expression>, const std::string&);
+	StructMemberAccessExpression(Expression*, Name);
 	
 	void accept(Visitor&) override;
 };
 
 struct SubscriptExpression: public PostfixExpression {
-	std::shared_ptr<Expression> base;
-	std::shared_ptr<Expression> index;
+	static constexpr NodeKind node_kind = NodeKind::SubscriptExpression;
+	Expression* base = nullptr;
+	Expression* index = nullptr;
 
-	SubscriptExpression(std::shared_ptr<Expression>, std::shared_ptr<Expression>);
+	SubscriptExpression(Expression*, Expression*);
 	void accept(Visitor&) override;
 };
 
 struct TernaryExpression : public Expression{
-	std::shared_ptr<Expression> condition;
-	std::shared_ptr<Expression> true_expr;
-	std::shared_ptr<Expression> false_expr;
+	static constexpr NodeKind node_kind = NodeKind::TernaryExpression;
+	Expression* condition = nullptr;
+	Expression* true_expr = nullptr;
+	Expression* false_expr = nullptr;
 
 
-	TernaryExpression(std::shared_ptr<Expression>, std::shared_ptr<Expression>, std::shared_ptr<Expression>);
+	TernaryExpression(Expression*, Expression*, Expression*);
 
 	void accept(Visitor&) override;
 };
 
 
 struct SizeOfExpression : public PostfixExpression{
+	static constexpr NodeKind node_kind = NodeKind::SizeOfExpression;
 	bool is_type;
-	std::string type_name;
-	std::shared_ptr<Expression> expression;
+	Name type_name;
+	Expression* expression = nullptr;
 
-	SizeOfExpression(const std::string&);
-	SizeOfExpression(std::shared_ptr<Expression>);
+	SizeOfExpression(Name);
+	SizeOfExpression(Expression*);
 	
 	
 	
@@ -176,19 +207,20 @@ struct SizeOfExpression : public PostfixExpression{
 };
 
 struct NameSpaceAcceptExpression : public PostfixExpression{
-	std::shared_ptr<Expression> base;
-	std::string name;
+	static constexpr NodeKind node_kind = NodeKind::NameSpaceAcceptExpression;
+	Expression* base = nullptr;
+	Name name;
 
-	NameSpaceAcceptExpression(std::shared_ptr<Expression>, const std::string&);
+	NameSpaceAcceptExpression(Expression*, Name);
 
 	void accept(Visitor&) override;
 };
 
 
-using expression = std::shared_ptr<Expression>;
-using binary_expression = std::shared_ptr<BinaryExpression>;
-using unary_expression = std::shared_ptr<UnaryExpression>;
-using postfix_expression = std::shared_ptr<PostfixExpression>;
-using primary_expression = std::shared_ptr<PrimaryExpression>;
-using parentsized_expression = std::shared_ptr<ParenthesizedExpression>;
-using func_param = std::vector<std::shared_ptr<Expression>>;
\ No newline at end of file
+using expression = Expression*;
+using binary_expression = BinaryExpression*;
+using unary_expression = UnaryExpression*;
+using postfix_expression = PostfixExpression*;
+using primary_expression = PrimaryExpression*;
+using parentsized_expression = ParenthesizedExpression*;
+using func_param = node_list<Expression>;
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ast.hpp"
+#include "token.hpp"
+
+// Разбор файла, который правится между запусками (цикл «правка — запуск»).
+// Текст делится на объявления и операторы верхнего уровня; после правки заново
+// лексируются и разбираются только задетые ими, узлы остальных берутся из прежнего дерева.
+// Если отрезок нельзя разобрать отдельно (правка открыла скобку, комментарий, добавила else),
+// он расширяется в обе стороны вдвое, в худшем случае до всего файла.
+class IncrementalParser {
+public:
+    // filename — только для сообщений об ошибках
+    explicit IncrementalParser(std::string filename);
+
+    // заменить байты [begin, end) текста на replacement и обновить дерево;
+    // при ошибке разбора текст уже изменён, дерево остаётся прежним
+    void edit(std::size_t begin, std::size_t end, std::string_view replacement);
+
+    // новый текст целиком; изменённый участок находится сравнением с прежним
+    void update(std::string_view text);
+
+    const std::string& text() const { return source; }
+    // дерево последнего удачного разбора; nullptr до первого.
+    // Живёт, пока жив разборщик: список узлов верхнего уровня хранится здесь
+    TranslationUnit* unit() const { return tree.get(); }
+    // сколько узлов верхнего уровня разобрано заново при последней правке
+    std::size_t reparsed() const { return last_reparsed; }
+
+private:
+    // узел верхнего уровня и его отрезок текста: от конца предыдущего узла до своей
+    // последней лексемы включительно (у последнего узла — до конца файла)
+    struct Item {
+        ASTNode* node;
+        std::size_t length;
+        TokenType first;    // первая лексема: else, while или «;» продолжают предыдущий узел
+    };
+
+    std::vector<Item> parse_range(std::size_t begin, std::size_t end, std::unique_ptr<Arena>& arena) const;
+
+    std::string filename;
+    std::string source;
+    std::vector<Item> items;
+    std::vector<ASTNode*> nodes;    // список узлов дерева; tree->declarations смотрит сюда
+    std::unique_ptr<TranslationUnit> tree;
+    bool valid = false;             // items соответствуют тексту (последний разбор удался)
+    std::size_t garbage = 0;        // байт текста, чьи старые узлы ещё лежат в арене
+    std::size_t last_reparsed = 0;
+};
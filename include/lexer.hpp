@@ -1,9 +1,9 @@
 #pragma once
 
 #include <vector>
-#include <unordered_map>
-#include <set>
+#include <string_view>
 #include "token.hpp"
+#include "source_buffer.hpp"
 
 
 
@@ -11,27 +11,39 @@
 class Lexer{
 public:
     Lexer(const std::string& filename);
+    // готовый текст, начинающийся в строке line и столбце column файла filename
+    // (отрезок файла при повторном разборе); текст должен пережить лексемы
+    Lexer(const std::string& filename, std::string_view text, std::uint32_t line, std::uint32_t column);
     std::vector<Token> tokenize();
+    Token next();
+    // размер исходного текста в байтах
+    std::size_t size() const { return source.size(); }
+    // исходный текст целиком, без разбора (ключ кэша деревьев)
+    std::string_view text() const { return source; }
     static void print_tokens(const std::vector<Token>& tokens);
 
 private:
 
     std::string filename;
+    // весь текст файла; лексемы — виды на него, поэтому лексер живёт дольше токенов
+    SourceBuffer buffer;
+    std::string_view source;
     std::size_t offset;
+    std::uint32_t line;
+    std::size_t line_start;     // смещение начала текущей строки
 
 
-    static std::set<std::string> types;
-    static std::unordered_map<std::string, TokenType> operators;
-    static std::unordered_map<std::string, TokenType> punctuators;
-    static std::unordered_map<std::string, TokenType> keywords;
-    static std::string spec_symbols;
-    std::string operator_char = "+-*/%^&|=<>!~?:";
-    
-    Token extract_literal(const std::string& line);
-    Token extract_type(const std::string& line);
-    Token extract_operator(const std::string& line);
-    Token extract_punctuator(const std::string& line);
-    Token extract_id(const std::string& line);
-    Token extract_keyword(const std::string& line);   
+
+    void skip_block_comment();
+    // указатели в текст для функций scan::* и обратно в смещения
+    const char* at(std::size_t pos) const;
+    std::size_t scan_to(const char* p) const;
+    Token make_token(TokenType type, std::size_t start);
+    [[noreturn]] void error(const std::string& message, std::size_t at);
+
+    Token extract_literal();
+    Token extract_operator();
+    Token extract_punctuator();
+    Token extract_id();
     static std::string token_type_to_string(TokenType type);
-};
+};
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Таблица интернирования: каждый различный текст хранится один раз и получает номер.
+// Общая для лексера, парсера, анализатора и исполнителей.
+// Не синхронизирована: новые имена добавляет только лексер, а параллельный разбор
+// запускается уже после лексики и таблицу лишь читает.
+class Interner {
+public:
+    static Interner& global();
+
+    std::uint32_t intern(std::string_view text);
+    const std::string& text(std::uint32_t id) const { return strings[id]; }
+    std::size_t size() const { return strings.size(); }
+
+private:
+    Interner();
+
+    std::deque<std::string> strings;    // deque не перемещает строки, ключи ids остаются верными
+    std::unordered_map<std::string_view, std::uint32_t> ids;
+};
+
+// Интернированный идентификатор: 32-битный номер в Interner::global().
+// Сравнение и хеширование — по номеру, текст нужен только для сообщений и печати.
+class Name {
+public:
+    Name() = default;
+    Name(std::string_view text) : id(Interner::global().intern(text)) {}
+    Name(const std::string& text) : Name(std::string_view(text)) {}
+    Name(const char* text) : Name(std::string_view(text)) {}
+
+    std::uint32_t index() const { return id; }
+    bool empty() const { return id == 0; }
+
+    const std::string& str() const { return Interner::global().text(id); }
+    operator const std::string&() const { return str(); }
+
+    bool operator==(const Name&) const = default;
+    auto operator<=>(const Name&) const = default;
+
+private:
+    std::uint32_t id = 0;   // 0 — пустая строка
+};
+
+inline std::string operator+(const std::string& lhs, const Name& rhs) { return lhs + rhs.str(); }
+inline std::string operator+(const char* lhs, const Name& rhs)        { return lhs + rhs.str(); }
+inline std::string operator+(const Name& lhs, const std::string& rhs) { return lhs.str() + rhs; }
+inline std::string operator+(const Name& lhs, const char* rhs)        { return lhs.str() + rhs; }
+
+inline std::ostream& operator<<(std::ostream& out, const Name& name) { return out << name.str(); }
+
+// имена, с которыми сравнивают на каждом вызове, интернированы заранее
+namespace known {
+inline const Name auto_type{"auto"};
+inline const Name main{"main"};
+inline const Name print{"print"};
+inline const Name read{"read"};
+inline const Name self{"this"};
+}
+
+template<>
+struct std::hash<Name> {
+    std::size_t operator()(const Name& name) const noexcept { return name.index(); }
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Операторы выражений. Парсер переводит лексему в код один раз,
+// дальше анализатор, исполнители и печать сравнивают коды, а не строки.
+enum class Operator : std::uint8_t {
+    // присваивания
+    Assign,
+    AddAssign,
+    SubAssign,
+    MulAssign,
+    DivAssign,
+    ModAssign,
+
+    // бинарные
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Mod,
+    ShiftLeft,
+    ShiftRight,
+    BitAnd,
+    BitOr,
+    BitXor,
+    Power,
+    Equal,
+    NotEqual,
+    Less,
+    Greater,
+    LessEqual,
+    GreaterEqual,
+    And,
+    Or,
+    Comma,
+
+    // префиксные
+    Increment,
+    Decrement,
+    Dereference,
+    AddressOf,
+    Plus,
+    Minus,
+    Not
+};
+
+// код оператора по лексеме; бросает std::runtime_error для неизвестной
+Operator binary_operator(std::string_view lexeme);
+Operator prefix_operator(std::string_view lexeme);
+
+// лексема оператора — для диагностики и печати дерева
+std::string spelling(Operator op);
+
+inline bool is_comparison(Operator op) {
+    return op >= Operator::Equal && op <= Operator::GreaterEqual;
+}
+
+// %, сдвиги и поразрядные операции определены только для целых
+inline bool is_integral_operation(Operator op) {
+    return op >= Operator::Mod && op <= Operator::BitXor;
+}
+
+inline bool is_compound_assignment(Operator op) {
+    return op >= Operator::AddAssign && op <= Operator::ModAssign;
+}
+
+// арифметическая часть составного присваивания: += -> +
+Operator compound_operation(Operator op);
@@ -1,37 +1,53 @@
 #pragma once
 
+#include <span>
 #include <unordered_map>
 #include <unordered_set>
 
 #include "token.hpp"
+#include "token_stream.hpp"
 #include "ast.hpp"
 #include "declaration.hpp"
 #include "statement.hpp"
 #include "expression.hpp"
 
 class Parser {
+	// разбирает отрезки файла тем же парсером, что и parse_parallel
+	friend class IncrementalParser;
 private:
 	
-	std::vector<Token> tokens;
-	std::size_t offset;
+	Lexer* lexer = nullptr;
+	// лексемы читаются из лексера по мере разбора, без общего вектора
+	TokenStream tokens;
+	// узлы строящегося дерева; по окончании разбора переходит к TranslationUnit
+	std::unique_ptr<Arena> arena;
+	// тела функций верхнего уровня не разбираются, а запоминаются лексемами (см. parse_body)
+	bool lazy_bodies = false;
+	bool at_top_level = false;  // parse_declaration вызван из parse_top_level
 	
 	static const std::unordered_set<std::string> unary_operators;
 
 public:
-	Parser(const std::vector<Token>&);
+	explicit Parser(Lexer&, bool lazy_bodies = false);
+
+	// файлы от этого размера разбираются параллельно по объявлениям верхнего уровня
+	static constexpr std::size_t parallel_threshold = 64 * 1024;
 
 	bool is_type_specifier();
 public:
-	std::shared_ptr<TranslationUnit> parse();
+	std::unique_ptr<TranslationUnit> parse();
+	// разобрать отложенное тело функции в арену её дерева; лексер, давший лексемы, должен быть жив
+	static void parse_body(FuncDeclaration&, std::unique_ptr<Arena>& arena);
 
 	declaration parse_declaration();
-	func_declaration parse_function_declaration();
+	func_declaration parse_function_declaration(bool is_const, Name type, declarator declarator, bool defer_body = false);
 	parameter_declaration parse_parameter_declaration();
-	var_declaration parse_var_declaration();
+	var_declaration parse_var_declaration(bool is_const, Name type, declarator first);
 	struct_declaration parse_struct_declaration();
-	array_declaration parse_array_declaration();
-	init_declarator parse_init_declarator();
+	array_declaration parse_array_declaration(Name type, Name name);
+	init_declarator parse_init_declarator(declarator declarator = nullptr);
 	declarator parse_declarator();
+	declarator make_declarator(Name name, std::size_t pointer_level);
 	name_space_declaration parse_namespace_declaration();
 public:
 	statement parse_statement();
@@ -51,55 +67,21 @@ public:
 public:
 	expression parse_expression();
 	expression parse_comma_expression();
-	expression parse_assignment();
-	expression parse_ternary_expression();
-	expression parse_logical_or_expression();
-	expression parse_logical_and_expression();
-	expression parse_equality_expression();	
-	expression parse_compared_expression();
-
-	expression parse_sum_expression();
-	expression parse_mul_expression();
-	expression parse_pow_expression();	
+	expression parse_binary_expression(int min_precedence);
+
 	expression parse_unary_expression();
 	expression parse_postfix_expression();
 	expression parse_base();
 
-/*
-	expression parse_expression();
-	assignment_expression parse_assignment();
-	ternary_expression parse_ternary();
-	conditional_expression parse_conditional();
-	arithmetic_parse parse_arithmetic_expression(int);
-	//parse sum, mul, add...
-	parse_base();
-	a+(b*c)+c;
-
-	a + (b*c) + c
-
-	++a; - unary
-	a++ - postfix;
-	base->parse_base()-> parse_postfix() -> parse_unary()
-
-
-*/
-
-
-/*parse_expression
-
-    parse_assignment - dobavit
-    /parse_ternary
-    /parse_compared - delitsya na svoi podtipy
-    1 -/parse_sum
-    /parse_mul
-    /parse_pow
-    /parse_unary
-    /parse_postfix
-    /parse_base
+private:
+	// кусок файла из целых объявлений верхнего уровня; end — END с позицией конца куска
+	Parser(std::span<const Token> tokens, const Token& end);
 
+	// ends, если задан, получает для каждого узла число лексем, пройденных к его концу
+	std::vector<ASTNode*> parse_top_level(std::vector<std::size_t>* ends = nullptr);
+	std::unique_ptr<TranslationUnit> parse_parallel(unsigned threads);
+	std::span<const Token> skip_body();
 
-*/
-private:
 	template<typename... Args>
 	bool check_token(const Args&...);
 
@@ -109,8 +91,9 @@ private:
 	template<typename... Args>
 	std::string extract_token(const Args&...);
 
+	// интернированное имя идентификатора или типа
 	template<typename... Args>
-	bool match_pattern(const Args&...);
+	Name extract_name(const Args&...);
 
 
 	Token peek_token(int lookahead);
@@ -1,51 +1,51 @@
-#include "visitor.hpp"
+#include "walker.hpp"
 
-class Printer : public Visitor {
+class Printer : public Walker<Printer> {
 public:
-	void visit(TranslationUnit&) override;
+	void visit(TranslationUnit&);
 	int indent_level = 0;
 
 	void indent();
 public:
-	void visit(ASTNode&) override;
-	void visit(Declaration::PtrDeclarator&) override;
-	void visit(Declaration::SimpleDeclarator&) override;
-	void visit(Declaration::InitDeclarator&) override;
-	void visit(VarDeclaration&) override;
-	void visit(ParameterDeclaration&) override;
-	void visit(FuncDeclaration&) override;
-	void visit(StructDeclaration&) override;
-	void visit(ArrayDeclaration&) override;
-	void visit(NameSpaceDeclaration&) override;
+	void visit(ASTNode&);
+	void visit(Declaration::PtrDeclarator&);
+	void visit(Declaration::SimpleDeclarator&);
+	void visit(Declaration::InitDeclarator&);
+	void visit(VarDeclaration&);
+	void visit(ParameterDeclaration&);
+	void visit(FuncDeclaration&);
+	void visit(StructDeclaration&);
+	void visit(ArrayDeclaration&);
+	void visit(NameSpaceDeclaration&);
 public:
-	void visit(CompoundStatement&) override;
-	void visit(DeclarationStatement&) override;
-	void visit(ExpressionStatement&) override;
-	void visit(ConditionalStatement&) override;
-	void visit(WhileStatement&) override;
-	void visit(ForStatement&) override;
-	void visit(ReturnStatement&) override;
-	void visit(BreakStatement&) override;
-	void visit(ContinueStatement&) override;
-	void visit(StructMemberAccessExpression&) override;
-	void visit(DoWhileStatement&) override;
-	void visit(StaticAssertStatement&) override;
+	void visit(CompoundStatement&);
+	void visit(DeclarationStatement&);
+	void visit(ExpressionStatement&);
+	void visit(ConditionalStatement&);
+	void visit(WhileStatement&);
+	void visit(ForStatement&);
+	void visit(ReturnStatement&);
+	void visit(BreakStatement&);
+	void visit(ContinueStatement&);
+	void visit(StructMemberAccessExpression&);
+	void visit(DoWhileStatement&);
+	void visit(StaticAssertStatement&);
 public:
-	void visit(BinaryOperation&) override;
-	void visit(PrefixExpression&) override;
-	void visit(PostfixIncrementExpression&) override;
-	void visit(PostfixDecrementExpression&) override;
-	void visit(FunctionCallExpression&) override;
-	void visit(SubscriptExpression&) override;
-	void visit(IntLiteral&) override;
-	void visit(FloatLiteral&) override;
-	void visit(CharLiteral&) override;
-	void visit(StringLiteral&) override;
-	void visit(BoolLiteral&) override;
-	void visit(NullPtrLiteral&) override;
-	void visit(IdentifierExpression&) override;
-	void visit(ParenthesizedExpression&) override;
-	void visit(TernaryExpression&) override;
-	void visit(SizeOfExpression&) override;
-	void visit(NameSpaceAcceptExpression&) override;
+	void visit(BinaryOperation&);
+	void visit(PrefixExpression&);
+	void visit(PostfixIncrementExpression&);
+	void visit(PostfixDecrementExpression&);
+	void visit(FunctionCallExpression&);
+	void visit(SubscriptExpression&);
+	void visit(IntLiteral&);
+	void visit(FloatLiteral&);
+	void visit(CharLiteral&);
+	void visit(StringLiteral&);
+	void visit(BoolLiteral&);
+	void visit(NullPtrLiteral&);
+	void visit(IdentifierExpression&);
+	void visit(ParenthesizedExpression&);
+	void visit(TernaryExpression&);
+	void visit(SizeOfExpression&);
+	void visit(NameSpaceAcceptExpression&);
 };
\ No newline at end of file
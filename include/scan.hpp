@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+
+// Поиск по длинным участкам исходного текста для лексера.
+// На x86-64 выбираются ядра AVX2 или SSE2 по возможностям процессора при первом вызове,
+// на прочих платформах — посимвольная реализация.
+// Все функции работают на полуинтервале [p, end) и возвращают end, если ничего не нашли.
+namespace scan {
+
+// первый символ, не являющийся пробелом, табуляцией, \v, \f или \r (перевод строки — не пропускается)
+const char* skip_blanks(const char* p, const char* end);
+
+// первый символ, не входящий в [A-Za-z0-9_]
+const char* skip_ident(const char* p, const char* end);
+
+// первый символ, не являющийся десятичной цифрой
+const char* skip_digits(const char* p, const char* end);
+
+// первое вхождение a или b
+const char* find_either(const char* p, const char* end, char a, char b);
+
+// первое вхождение c
+inline const char* find(const char* p, const char* end, char c) { return find_either(p, end, c, c); }
+
+// число вхождений c
+std::size_t count(const char* p, const char* end, char c);
+
+}
@@ -2,11 +2,13 @@
 #include <unordered_map>
 #include <map>
 #include <string>
-#include <any>
+#include <span>
 #include <vector>
+#include <stdexcept>
 #include "type.hpp"
 #include "ast.hpp"
 #include "symbol.hpp"
+#include "name.hpp"
 
 struct Scope {
 public:
@@ -16,19 +18,50 @@ public:
     std::shared_ptr<Scope> get_prev_table();
     std::shared_ptr<Scope> create_new_table(std::shared_ptr<Scope>);
     
-    std::shared_ptr<Symbol> match_global(std::string);
-    std::shared_ptr<Symbol> match_local(std::string);
-    std::vector<std::shared_ptr<Symbol>> match_range(std::string);
-    bool contains_symbol(std::string);
-    std::multimap<std::string, std::shared_ptr<Symbol>> get_symbols() {
+    // поиск без исключения: пустой указатель, если имени нет
+    const std::shared_ptr<Symbol>& find(Name) const;        // по цепочке областей
+    const std::shared_ptr<Symbol>& find_local(Name) const;  // только в этой области
+
+    // то же, но отсутствие имени — std::runtime_error
+    const std::shared_ptr<Symbol>& match_global(Name) const;
+    const std::shared_ptr<Symbol>& match_local(Name) const;
+    std::span<const std::shared_ptr<Symbol>> match_range(Name) const;
+    bool contains_symbol(Name) const;
+    const std::unordered_map<Name, std::shared_ptr<Symbol>>& get_symbols() const {
         return symbolTable;
     }
-    bool contains_symbol_recursive(const std::string& name);
+    bool contains_symbol_recursive(Name name) const;
 
 
     
-    void push_symbol(std::string, std::shared_ptr<Symbol>);
+    // возвращает слот, в который попал символ; slot >= 0 — слот кадра активации
+    int push_symbol(Name, std::shared_ptr<Symbol>, int slot = -1);
+
+    // лексическая адресация: Analyzer заранее вычисляет (depth, slot),
+    // исполнитель обращается к символу без поиска по имени.
+    // depth == 0 — слот кадра активации функции, иначе depth - 1 областей вверх от области функции
+    bool locate(const Symbol* symbol, int& depth, int& slot);
+    void place_symbol(int slot, std::shared_ptr<Symbol> symbol);
+    std::shared_ptr<Symbol> local_slot(int slot);
+
+    const std::shared_ptr<Symbol>& match_slot(int depth, int slot) {
+        Scope* scope = this;
+        while (depth-- > 0) {
+            scope = scope->prev_table.get();
+        }
+        if (static_cast<size_t>(slot) >= scope->slots.size() || !scope->slots[slot]) {
+            throw std::runtime_error("unresolved slot " + std::to_string(slot));
+        }
+        return scope->slots[slot];
+    }
+    // область внутри тела функции: её переменные живут в кадре активации, а не в Scope
+    bool frame = false;
+    // поля и методы структуры вокруг тела её метода: при исполнении их даёт экземпляр, уровнем адреса область не считается
+    bool members = false;
 private:
     std::shared_ptr<Scope>prev_table;
-    std::multimap<std::string, std::shared_ptr<Symbol>> symbolTable;
+    // имя объявлено в области не более одного раза — см. push_symbol
+    std::unordered_map<Name, std::shared_ptr<Symbol>> symbolTable;
+    std::vector<std::shared_ptr<Symbol>> slots;
+    std::unordered_map<const Symbol*, int> slot_index;
 };
\ No newline at end of file
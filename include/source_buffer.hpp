@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Исходный файл целиком в памяти: отображается через mmap, а если это
+// невозможно (пустой файл, канал) — читается за один раз.
+// Токены ссылаются на текст через std::string_view и не должны его пережить.
+class SourceBuffer {
+public:
+    // пустой, не открытый буфер (текст лексера взят не из файла)
+    SourceBuffer() = default;
+    explicit SourceBuffer(const std::string& filename);
+    ~SourceBuffer();
+
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+    bool is_open() const { return opened; }
+    std::string_view text() const { return {data, size}; }
+
+private:
+    const char* data = nullptr;
+    std::size_t size = 0;
+    bool opened = false;
+    bool mapped = false;
+    std::string contents;   // текст, прочитанный без mmap
+};
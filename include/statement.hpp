@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 
@@ -8,53 +9,57 @@
 
 struct VarDeclaration;
 
-using statementseq= std::vector<std::shared_ptr<Statement>>;
+using statementseq= node_list<Statement>;
 
 struct CompoundStatement: public Statement {
+	static constexpr NodeKind node_kind = NodeKind::CompoundStatement;
 	statementseq statements;
 
-	CompoundStatement(const statementseq&);
+	CompoundStatement(statementseq);
 	void accept(Visitor&) override;
 };
 
 struct ConditionalStatement : public Statement {
+	static constexpr NodeKind node_kind = NodeKind::ConditionalStatement;
     ConditionalStatement(
-        const std::pair<std::shared_ptr<Expression>, std::shared_ptr<Statement>>& if_branch,
-        const std::shared_ptr<Statement>& else_branch
+        std::pair<Expression*, Statement*> if_branch,
+        Statement* else_branch
     );
-    std::pair<std::shared_ptr<Expression>, std::shared_ptr<Statement>> if_branch;
-    std::shared_ptr<Statement> else_branch; 
+    std::pair<Expression*, Statement*> if_branch;
+    Statement* else_branch = nullptr; 
 
     void accept(Visitor& visitor) override; 
 };
 struct LoopStatement: public Statement {
-	virtual ~LoopStatement() = default;
+	using Statement::Statement;
 	virtual void accept(Visitor&) override = 0;
 };
 
 struct WhileStatement: public LoopStatement {
-	std::shared_ptr<Expression> condition;
-	std::shared_ptr<Statement> statement;
+	static constexpr NodeKind node_kind = NodeKind::WhileStatement;
+	Expression* condition = nullptr;
+	Statement* statement = nullptr;
 
 	WhileStatement(
-		const std::shared_ptr<Expression>&,
-		const std::shared_ptr<Statement>&
+		Expression*,
+		Statement*
 	);
 	void accept(Visitor&) override;
 };
 
 
 struct ForStatement : public LoopStatement {
-    std::shared_ptr<ASTNode> initialization; 
-    std::shared_ptr<Expression> condition;   
-    std::shared_ptr<Expression> increment;   
-    std::shared_ptr<Statement> body;         
+	static constexpr NodeKind node_kind = NodeKind::ForStatement;
+    ASTNode* initialization = nullptr; 
+    Expression* condition = nullptr;   
+    Expression* increment = nullptr;   
+    Statement* body = nullptr;         
 
 	ForStatement(
-        std::shared_ptr<ASTNode> initialization,
-        std::shared_ptr<Expression> condition,
-        std::shared_ptr<Expression> increment,
-        std::shared_ptr<Statement> body
+        ASTNode* initialization,
+        Expression* condition,
+        Expression* increment,
+        Statement* body
     );
 
     void accept(Visitor& visitor) override;
@@ -62,71 +67,82 @@ struct ForStatement : public LoopStatement {
 };
 
 struct JumpStatement: public Statement {
-	virtual ~JumpStatement() = default;
+	using Statement::Statement;
 	virtual void accept(Visitor&) override = 0;
 };
 
 struct ReturnStatement: public JumpStatement {
-	std::shared_ptr<Expression> expression;
+	static constexpr NodeKind node_kind = NodeKind::ReturnStatement;
+	Expression* expression = nullptr;
 
-	ReturnStatement(const std::shared_ptr<Expression>&);
+	ReturnStatement(Expression*);
 	void accept(Visitor&) override;
 };
 
 struct BreakStatement: public JumpStatement {
+	static constexpr NodeKind node_kind = NodeKind::BreakStatement;
+
+	BreakStatement();
 	void accept(Visitor&) override;
 };
 
 struct ContinueStatement: public JumpStatement {
+	static constexpr NodeKind node_kind = NodeKind::ContinueStatement;
+
+	ContinueStatement();
 	void accept(Visitor&) override;
 };
 
 struct DeclarationStatement: public Statement {
-	std::shared_ptr<Declaration> declaration;
+	static constexpr NodeKind node_kind = NodeKind::DeclarationStatement;
+	Declaration* declaration = nullptr;
 
-	DeclarationStatement(const std::shared_ptr<Declaration>&);
+	DeclarationStatement(Declaration*);
 	void accept(Visitor&) override;
 };
 
 struct ExpressionStatement: public Statement {
-	std::shared_ptr<Expression> expression;
+	static constexpr NodeKind node_kind = NodeKind::ExpressionStatement;
+	Expression* expression = nullptr;
 
-	ExpressionStatement(const std::shared_ptr<Expression>&);
+	ExpressionStatement(Expression*);
 	void accept(Visitor&) override;
 };
 
 struct DoWhileStatement : public LoopStatement{
-	std::shared_ptr<Statement> statement;
-	std::shared_ptr<Expression> condition;
+	static constexpr NodeKind node_kind = NodeKind::DoWhileStatement;
+	Statement* statement = nullptr;
+	Expression* condition = nullptr;
 	DoWhileStatement(
-		const std::shared_ptr<Statement>&,
-		const std::shared_ptr<Expression>&
+		Statement*,
+		Expression*
 	);
 	void accept(Visitor&) override;
 };
 
 struct StaticAssertStatement : public Statement {
-	std::shared_ptr<Expression> condition;
-	std::string msg;
+	static constexpr NodeKind node_kind = NodeKind::StaticAssertStatement;
+	Expression* condition = nullptr;
+	std::string_view msg; // текст в арене
 
-	StaticAssertStatement(const std::shared_ptr<Expression>&, const std::string&);
+	StaticAssertStatement(Expression*, std::string_view);
 
 	void accept(Visitor&) override;
 };
 
 
-using statement = std::shared_ptr<Statement>;
-using compound_statement = std::shared_ptr<CompoundStatement>;
-using conditional_statement = std::shared_ptr<ConditionalStatement>;
-using loop_statement = std::shared_ptr<LoopStatement>;
-using while_statement = std::shared_ptr<WhileStatement>;
-using for_statement = std::shared_ptr<ForStatement>;
-using jump_statement = std::shared_ptr<JumpStatement>;
-using break_statement = std::shared_ptr<BreakStatement>;
-using continue_statement = std::shared_ptr<ContinueStatement>;
-using return_statement = std::shared_ptr<ReturnStatement>;
-using declaration_statement = std::shared_ptr<DeclarationStatement>;
-using expression_statement = std::shared_ptr<ExpressionStatement>;
-using do_while_statement = std::shared_ptr<DoWhileStatement>;
-using stat_assert = std::shared_ptr<StaticAssertStatement>;
+using statement = Statement*;
+using compound_statement = CompoundStatement*;
+using conditional_statement = ConditionalStatement*;
+using loop_statement = LoopStatement*;
+using while_statement = WhileStatement*;
+using for_statement = ForStatement*;
+using jump_statement = JumpStatement*;
+using break_statement = BreakStatement*;
+using continue_statement = ContinueStatement*;
+using return_statement = ReturnStatement*;
+using declaration_statement = DeclarationStatement*;
+using expression_statement = ExpressionStatement*;
+using do_while_statement = DoWhileStatement*;
+using stat_assert = StaticAssertStatement*;
 
@@ -4,7 +4,8 @@
 #include <string>
 #include <unordered_map>
 #include <vector>
-#include <any>
+#include "value.hpp"
+#include "name.hpp"
 
 // ——— Форвард-объявления: эти классы определяются в type.hpp/scope.hpp, 
 //    но нам нужно знание их имён уже здесь.
@@ -26,12 +27,47 @@ struct VarSymbol : Symbol {
     VarSymbol(std::shared_ptr<Type> t)
       : Symbol(std::move(t)) {}
 
-    VarSymbol(std::shared_ptr<Type> t, std::any v)
-      : Symbol(std::move(t)), value(std::move(v)) {}
+    VarSymbol(std::shared_ptr<Type> t, Value v)
+      : Symbol(std::move(t)), value(v) {}
 
-    std::any value;
+    Value value;
+    ArrayStorage elements;                     // хранилище массива
+    std::shared_ptr<StructSymbol> instance;    // экземпляр структуры, которым владеет переменная
 };
 
+// Ссылка на ячейку: сама переменная (index < 0) или элемент её массива.
+// Значимый тип без владения — индексация и разыменование ничего не выделяют.
+struct Ref {
+    VarSymbol* target = nullptr;
+    std::int32_t index = -1;
+
+    explicit operator bool() const { return target != nullptr; }
+    void reset() { target = nullptr; index = -1; }
+
+    Value get() const {
+        return index < 0 ? target->value : target->elements.get(index);
+    }
+    // запись с преобразованием к типу ячейки
+    void set(const Value& v) const {
+        if (index < 0) {
+            store(target->value, v);
+        } else {
+            target->elements.set(index, v);
+        }
+    }
+    // значение указателя на эту ячейку
+    Value address() const { return Value::pointer(target, index < 0 ? 0 : index); }
+    // тег ячейки: у элемента — тип элемента массива
+    ValueKind kind() const {
+        return index < 0 ? kind_of(target->type) : target->elements.element_kind();
+    }
+};
+
+// ячейка, на которую указывает указатель (с проверкой границ)
+Ref dereference(const Value& p);
+// присваивание структур: поля from копируются в поля to, вложенные структуры — так же по значению
+void copy_record(StructSymbol& to, const StructSymbol& from);
+
 struct FuncSymbol : Symbol {
     std::vector<std::shared_ptr<Type>> params;
     bool isConstMethod = false;
@@ -50,10 +86,10 @@ struct FuncSymbol : Symbol {
 };
 
 struct RecordSymbol : Symbol {
-    std::unordered_map<std::string, std::shared_ptr<Symbol>> members;
+    std::unordered_map<Name, std::shared_ptr<Symbol>> members;
 
     RecordSymbol(std::shared_ptr<RecordType> rt,
-                 std::unordered_map<std::string, std::shared_ptr<Symbol>> m)
+                 std::unordered_map<Name, std::shared_ptr<Symbol>> m)
       : Symbol(std::static_pointer_cast<Type>(std::move(rt)))
       , members(std::move(m))
     {}
@@ -62,7 +98,7 @@ struct RecordSymbol : Symbol {
 };
 struct StructSymbol : RecordSymbol {
     StructSymbol(std::shared_ptr<StructType> st,
-                 std::unordered_map<std::string, std::shared_ptr<Symbol>> m)
+                 std::unordered_map<Name, std::shared_ptr<Symbol>> m)
       : RecordSymbol(std::static_pointer_cast<RecordType>(std::move(st)), std::move(m))
     {}
 
@@ -80,16 +116,3 @@ struct NamespaceSymbol : RecordSymbol {
 
     NamespaceSymbol() : RecordSymbol(), scope(nullptr) {}
 };
-
-struct ArrayElementSymbol : VarSymbol {
-    std::shared_ptr<VarSymbol> parentArray;
-    int index;
-    ArrayElementSymbol(std::shared_ptr<Type> elemType,
-                       const std::any &elemValue,
-                       std::shared_ptr<VarSymbol> parent,
-                       int idx)
-      : VarSymbol(elemType, elemValue),
-        parentArray(std::move(parent)),
-        index(idx)
-    {}
-};
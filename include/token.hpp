@@ -1,6 +1,9 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <iostream>
+#include "name.hpp"
 
 enum class TokenType {
      
@@ -97,9 +100,13 @@ enum class TokenType {
         END
 };
 
+// Лексема — вид на текст исходного буфера (SourceBuffer) и её позиция в нём.
 struct Token {
     TokenType type;
-    std::string value;
+    std::string_view value;
+    std::uint32_t line = 0;     // с единицы; 0 — позиция неизвестна
+    std::uint32_t column = 0;
+    Name name;                  // у идентификаторов и типов — интернированный текст
 
     bool operator== (const TokenType type) {
         return this->type == type;
@@ -109,11 +116,14 @@ struct Token {
         return !(*this == type);
     }
 
-    Token(const Token& other) : type(other.type), value(other.value) {}
-
-    Token(Token&& other) noexcept : type(other.type), value(std::move(other.value)) {}
-
+    Token() : type(TokenType::END) {}
     Token(TokenType type) : type(type) {}
 
-    Token(TokenType type, std::string value) : type(type), value(value) {}
+    Token(TokenType type, std::string_view value, std::uint32_t line = 0, std::uint32_t column = 0)
+        : type(type), value(value), line(line), column(column) {}
+
+    // «строка:столбец» для сообщений об ошибках
+    std::string position() const {
+        return std::to_string(line) + ":" + std::to_string(column);
+    }
 };
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include "lexer.hpp"
+#include "token.hpp"
+
+// Лексемы для парсера по требованию: лексер вызывается по мере продвижения,
+// в памяти только кольцо из последней пройденной лексемы и окна просмотра вперёд.
+// Второй источник — готовый отрезок лексем (кусок файла при параллельном разборе).
+class TokenStream {
+public:
+    explicit TokenStream(Lexer& lexer) : lexer(&lexer) {}
+    // за последней лексемой отрезка поток отдаёт end (лексему END с позицией конца куска)
+    TokenStream(std::span<const Token> tokens, const Token& end) : chunk(tokens), end(end) {}
+
+    // самый дальний допустимый просмотр вперёд
+    static constexpr std::size_t max_lookahead = 14;
+
+    // лексема через lookahead позиций от текущей; за концом файла — END
+    const Token& peek(std::size_t lookahead = 0);
+    // последняя пройденная лексема
+    const Token& previous() const;
+
+    void advance();
+    // текущая лексема с переходом к следующей
+    Token consume();
+    // сколько лексем пройдено от начала
+    std::size_t consumed() const { return position; }
+
+private:
+    static constexpr std::size_t capacity = 16;     // степень двойки: номер в кольце — маска
+    static_assert(max_lookahead + 2 <= capacity);
+
+    const Token& slot(std::size_t index) const { return ring[index & (capacity - 1)]; }
+
+    Lexer* lexer = nullptr;     // nullptr — читаем из chunk
+    std::array<Token, capacity> ring{};
+    std::size_t position = 0;   // номер текущей лексемы от начала файла
+    std::size_t lexed = 0;      // сколько лексем уже получено от лексера
+    bool finished = false;      // последняя полученная лексема — END
+
+    std::span<const Token> chunk;
+    Token end;
+};
@@ -2,11 +2,12 @@
 #include <vector>
 #include <unordered_map>
 #include <string>
-#include <any>
+#include <cstdint>
 #include <memory>
 #include <iostream>
 #include "expression.hpp"
 #include "symbol.hpp"
+#include "name.hpp"
 
 /*
 Type
@@ -31,155 +32,304 @@ Type
     └─ ArrayType
 */
 
+// Вид типа: проверка категории — сравнение тега или switch, без dynamic_cast.
+enum class TypeKind : std::uint8_t {
+    Void,
+    NullPtr,
+    Bool,
+    Char,
+    Integer,
+    Float,
+    String,
+    Func,
+    Struct,
+    Pointer,
+    LValue,
+    RValue,
+    Array,
+    Const
+};
+
+constexpr bool is_integral(TypeKind kind) {
+    return kind == TypeKind::Bool || kind == TypeKind::Char || kind == TypeKind::Integer;
+}
+
+constexpr bool is_arithmetic(TypeKind kind) {
+    return is_integral(kind) || kind == TypeKind::Float;
+}
+
 struct Type {
+    TypeKind kind;
+
+    explicit Type(TypeKind kind) : kind(kind) {}
     virtual ~Type();
     virtual bool equals(const std::shared_ptr<Type>& other) const = 0;
     virtual void print();
 };
 
+// dynamic_cast по тегу вида: T::matches говорит, какие виды относятся к классу T
+template<typename T>
+T* type_cast(Type* type) {
+    return type && T::matches(type->kind) ? static_cast<T*>(type) : nullptr;
+}
+
+template<typename T>
+const T* type_cast(const Type* type) {
+    return type && T::matches(type->kind) ? static_cast<const T*>(type) : nullptr;
+}
+
+template<typename T>
+std::shared_ptr<T> type_pointer_cast(const std::shared_ptr<Type>& type) {
+    return type && T::matches(type->kind) ? std::static_pointer_cast<T>(type) : nullptr;
+}
+
+// Типы без составляющих и типы, собранные из других (указатель, const, ссылка, функция),
+// каноничны: их выдаёт TypeContext, по одному объекту на тип, и equals сравнивает указатели.
+// Массив и структура создаются по своему объявлению.
+
 // ---------------------------
 // Фундаментальные типы
 // ---------------------------
-struct Fundamental : Type {};
+struct Fundamental : Type {
+    using Type::Type;
+};
 
 struct VoidType : Fundamental {
+    static bool matches(TypeKind kind) { return kind == TypeKind::Void; }
     bool equals(const std::shared_ptr<Type>& other) const override;
     void print() override;
+private:
+    friend class TypeContext;
+    VoidType() : Fundamental(TypeKind::Void) {}
 };
 
 struct NullPtrType : Fundamental {
+    static bool matches(TypeKind kind) { return kind == TypeKind::NullPtr; }
     bool equals(const std::shared_ptr<Type>& other) const override;
     void print() override;
+private:
+    friend class TypeContext;
+    NullPtrType() : Fundamental(TypeKind::NullPtr) {}
 };
 
 struct Arithmetic : Fundamental {
-    explicit Arithmetic(std::any value);
-    virtual ~Arithmetic();                      
-    std::any get_any_value() const;
+    static bool matches(TypeKind kind) { return is_arithmetic(kind); }
+    using Fundamental::Fundamental;
+    virtual ~Arithmetic();
     void print() override;
-protected:
-    std::any value;
 };
 
 struct Integral : Arithmetic {
-    explicit Integral(std::any value);
-    virtual ~Integral();                       
+    static bool matches(TypeKind kind) { return is_integral(kind); }
+    using Arithmetic::Arithmetic;
+    virtual ~Integral();
     void print() override;
 };
 
 struct BoolType : Integral {
-    explicit BoolType(std::any value = false);
+    static bool matches(TypeKind kind) { return kind == TypeKind::Bool; }
     bool equals(const std::shared_ptr<Type>& other) const override;
     void print() override;
+private:
+    friend class TypeContext;
+    BoolType() : Integral(TypeKind::Bool) {}
 };
 
 struct CharType : Integral {
-    explicit CharType(std::any value = u'\0');
+    static bool matches(TypeKind kind) { return kind == TypeKind::Char; }
     bool equals(const std::shared_ptr<Type>& other) const override;
     void print() override;
+private:
+    friend class TypeContext;
+    CharType() : Integral(TypeKind::Char) {}
 };
 
 struct IntegerType : Integral {
-    explicit IntegerType(std::any value = int8_t(0));
+    static bool matches(TypeKind kind) { return kind == TypeKind::Integer; }
     bool equals(const std::shared_ptr<Type>& other) const override;
     void print() override;
-    std::any value;
+private:
+    friend class TypeContext;
+    IntegerType() : Integral(TypeKind::Integer) {}
 };
 
 struct FloatType : Arithmetic {
-    explicit FloatType(std::any value = 0.0);
+    static bool matches(TypeKind kind) { return kind == TypeKind::Float; }
     bool equals(const std::shared_ptr<Type>& other) const override;
     void print() override;
+private:
+    friend class TypeContext;
+    FloatType() : Arithmetic(TypeKind::Float) {}
 };
 
 struct StringType : Fundamental {
-    explicit StringType(std::string value = "");
-    std::string get_value() const;
+    static bool matches(TypeKind kind) { return kind == TypeKind::String; }
     bool equals(const std::shared_ptr<Type>& other) const override;
     void print() override;
 private:
-    std::string value;
+    friend class TypeContext;
+    StringType() : Fundamental(TypeKind::String) {}
 };
 
 // ---------------------------
 // Составные типы
 // ---------------------------
-struct Composite : Type {}; 
+struct Composite : Type {
+    using Type::Type;
+};
 
 struct FuncType : Composite {
-    explicit FuncType(std::shared_ptr<Type> return_type,
-                      std::vector<std::shared_ptr<Type>> args,
-                      bool is_method_c = false);
-    std::shared_ptr<Type> get_returnable_type() const;
-    std::vector<std::shared_ptr<Type>> get_args() const;
+    static bool matches(TypeKind kind) { return kind == TypeKind::Func; }
+    const std::shared_ptr<Type>& get_returnable_type() const;
+    const std::vector<std::shared_ptr<Type>>& get_args() const;
     bool is_method_const() const;
     bool equals(const std::shared_ptr<Type>& other) const override;
     void print() override;
 private:
+    friend class TypeContext;
+    FuncType(std::shared_ptr<Type> return_type,
+             std::vector<std::shared_ptr<Type>> args,
+             bool is_method_c);
+
     std::shared_ptr<Type> returnable_type;
     std::vector<std::shared_ptr<Type>> args;
     bool is_method_c;
 };
 
-struct RecordType : Composite {};
+struct RecordType : Composite {
+    static bool matches(TypeKind kind) { return kind == TypeKind::Struct; }
+    using Composite::Composite;
+};
 
 struct StructType : RecordType {
-    explicit StructType(const std::unordered_map<std::string, std::shared_ptr<Type>>& members,
-                        const std::unordered_map<std::string, std::shared_ptr<FuncType>>& methods);
-    std::unordered_map<std::string, std::shared_ptr<Type>> get_members() const;
-    std::unordered_map<std::string, std::shared_ptr<FuncType>> get_methods() const;
+    static bool matches(TypeKind kind) { return kind == TypeKind::Struct; }
+    explicit StructType(const std::unordered_map<Name, std::shared_ptr<Type>>& members,
+                        const std::unordered_map<Name, std::shared_ptr<FuncType>>& methods);
+    const std::unordered_map<Name, std::shared_ptr<Type>>& get_members() const;
+    const std::unordered_map<Name, std::shared_ptr<FuncType>>& get_methods() const;
+    // тип поля (метода) или пустой указатель, если его нет
+    const std::shared_ptr<Type>& find_member(Name) const;
+    const std::shared_ptr<FuncType>& find_method(Name) const;
     bool equals(const std::shared_ptr<Type>& other) const override;
     void print() override;
 private:
-    std::unordered_map<std::string, std::shared_ptr<Type>> members;
-    std::unordered_map<std::string, std::shared_ptr<FuncType>> methods;
+    std::unordered_map<Name, std::shared_ptr<Type>> members;
+    std::unordered_map<Name, std::shared_ptr<FuncType>> methods;
 };
 
 struct PointerType : Composite {
-    explicit PointerType(std::shared_ptr<Type> base = nullptr);
-    std::shared_ptr<Type> get_base() const;
+    static bool matches(TypeKind kind) { return kind == TypeKind::Pointer; }
+    const std::shared_ptr<Type>& get_base() const;
     bool equals(const std::shared_ptr<Type>& other) const override;
     void print() override;
 private:
+    friend class TypeContext;
+    explicit PointerType(std::shared_ptr<Type> base);
     std::shared_ptr<Type> base;
 };
 
-struct RefType : Composite {};
+struct RefType : Composite {
+    static bool matches(TypeKind kind) { return kind == TypeKind::LValue || kind == TypeKind::RValue; }
+    using Composite::Composite;
+};
 
 struct LValueType : RefType {
-    explicit LValueType(std::shared_ptr<Type> ref_to);
-    std::shared_ptr<Type> get_referenced_type() const;
+    static bool matches(TypeKind kind) { return kind == TypeKind::LValue; }
+    const std::shared_ptr<Type>& get_referenced_type() const;
     bool equals(const std::shared_ptr<Type>& other) const override;
     void print() override;
 private:
+    friend class TypeContext;
+    explicit LValueType(std::shared_ptr<Type> ref_to);
     std::shared_ptr<Type> ref_to;
 };
 
 struct RValueType : RefType {
-    explicit RValueType(std::shared_ptr<Type> ref_to);
-    std::shared_ptr<Type> get_referenced_type() const;
+    static bool matches(TypeKind kind) { return kind == TypeKind::RValue; }
+    const std::shared_ptr<Type>& get_referenced_type() const;
     bool equals(const std::shared_ptr<Type>& other) const override;
     void print() override;
 private:
+    friend class TypeContext;
+    explicit RValueType(std::shared_ptr<Type> ref_to);
     std::shared_ptr<Type> ref_to;
 };
 
+// размер в тип не входит: массивы с одинаковым типом элемента имеют один тип
 struct ArrayType : Composite {
-    explicit ArrayType(std::shared_ptr<Type> base, std::shared_ptr<Expression> size);
-    std::shared_ptr<Type> get_base_type() const;
-    expression get_size() const; // rework in int 
+    static bool matches(TypeKind kind) { return kind == TypeKind::Array; }
+    const std::shared_ptr<Type>& get_base_type() const;
     bool equals(const std::shared_ptr<Type>& other) const override;
     void print() override;
 private:
+    friend class TypeContext;
+    explicit ArrayType(std::shared_ptr<Type> base);
     std::shared_ptr<Type> base;
-    std::shared_ptr<Expression> size;
 };
 
 struct ConstType : Type {
-    explicit ConstType(std::shared_ptr<Type> base);
-    std::shared_ptr<Type> get_base() const;
+    static bool matches(TypeKind kind) { return kind == TypeKind::Const; }
+    const std::shared_ptr<Type>& get_base() const;
     bool equals(const std::shared_ptr<Type>& other) const override;
     void print() override;
 private:
+    friend class TypeContext;
+    explicit ConstType(std::shared_ptr<Type> base);
     std::shared_ptr<Type> base;
 };
+
+// Таблица каноничных типов: один int, один указатель на int и так далее.
+// Составной тип ищется по виду и указателям составляющих, поэтому построение
+// уже известного типа не выделяет памяти. Типы живут до конца программы.
+// Не синхронизирована: типы строят анализатор, компилятор и исполнитель в одном потоке.
+class TypeContext {
+public:
+    static TypeContext& global();
+
+    const std::shared_ptr<Type>& void_type() const     { return void_t; }
+    const std::shared_ptr<Type>& nullptr_type() const  { return nullptr_t; }
+    const std::shared_ptr<Type>& bool_type() const     { return bool_t; }
+    const std::shared_ptr<Type>& char_type() const     { return char_t; }
+    const std::shared_ptr<Type>& int_type() const      { return int_t; }
+    const std::shared_ptr<Type>& float_type() const    { return float_t; }
+    const std::shared_ptr<Type>& string_type() const   { return string_t; }
+
+    std::shared_ptr<Type> pointer_to(const std::shared_ptr<Type>& base);
+    std::shared_ptr<Type> const_of(const std::shared_ptr<Type>& base);
+    std::shared_ptr<Type> lvalue_of(const std::shared_ptr<Type>& base);
+    std::shared_ptr<Type> rvalue_of(const std::shared_ptr<Type>& base);
+    std::shared_ptr<Type> array_of(const std::shared_ptr<Type>& element);
+    std::shared_ptr<FuncType> function(const std::shared_ptr<Type>& returns,
+                                       const std::vector<std::shared_ptr<Type>>& args,
+                                       bool is_method_const = false);
+
+private:
+    TypeContext();
+
+    struct DerivedKey {
+        TypeKind kind;
+        const Type* base;
+        bool operator==(const DerivedKey&) const = default;
+    };
+    struct DerivedHash {
+        std::size_t operator()(const DerivedKey& key) const noexcept {
+            return std::hash<const Type*>()(key.base) * 31 + static_cast<std::size_t>(key.kind);
+        }
+    };
+    struct FuncKey {
+        const Type* returns;
+        std::vector<const Type*> args;
+        bool is_method_const;
+        bool operator==(const FuncKey&) const = default;
+    };
+    struct FuncHash {
+        std::size_t operator()(const FuncKey& key) const noexcept;
+    };
+
+    template<typename T>
+    std::shared_ptr<Type> derived(TypeKind kind, const std::shared_ptr<Type>& base);
+
+    std::shared_ptr<Type> void_t, nullptr_t, bool_t, char_t, int_t, float_t, string_t;
+    std::unordered_map<DerivedKey, std::shared_ptr<Type>, DerivedHash> derived_types;
+    std::unordered_map<FuncKey, std::shared_ptr<FuncType>, FuncHash> function_types;
+};
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <iostream>
+#include <vector>
+#include <type_traits>
+
+#include "operator.hpp"
+
+struct Type;
+struct VarSymbol;
+struct StructSymbol;
+
+// Тег значения времени выполнения
+enum class ValueKind : std::uint8_t {
+    Void,
+    Int,
+    Float,
+    Char,
+    Bool,
+    Null,
+    Pointer,
+    Struct,
+    String
+};
+
+// Компактное значение интерпретатора (без кучи и RTTI).
+// Указатель хранится как пара (переменная, индекс элемента):
+// для обычной переменной index == 0, для массива — номер элемента.
+struct Value {
+    ValueKind kind;
+    std::int32_t index;
+    union {
+        int i;
+        double f;
+        char c;
+        bool b;
+        VarSymbol* target;
+        StructSymbol* record;
+        const std::string_view* str;
+    };
+
+    Value() : kind(ValueKind::Void), index(0), target(nullptr) {}
+
+    static Value from_int(int v)     { Value r; r.kind = ValueKind::Int;   r.i = v; return r; }
+    static Value from_float(double v){ Value r; r.kind = ValueKind::Float; r.f = v; return r; }
+    static Value from_char(char v)   { Value r; r.kind = ValueKind::Char;  r.c = v; return r; }
+    static Value from_bool(bool v)   { Value r; r.kind = ValueKind::Bool;  r.b = v; return r; }
+    static Value null()              { Value r; r.kind = ValueKind::Null;  return r; }
+    static Value pointer(VarSymbol* t, std::int32_t idx = 0) {
+        Value r; r.kind = ValueKind::Pointer; r.target = t; r.index = idx; return r;
+    }
+    static Value from_record(StructSymbol* s) {
+        Value r; r.kind = ValueKind::Struct; r.record = s; return r;
+    }
+    static Value from_string(const std::string_view* s) {
+        Value r; r.kind = ValueKind::String; r.str = s; return r;
+    }
+
+    bool is_arithmetic() const {
+        return kind == ValueKind::Int || kind == ValueKind::Float
+            || kind == ValueKind::Char || kind == ValueKind::Bool;
+    }
+    bool is_pointer() const { return kind == ValueKind::Pointer; }
+
+    int as_int() const {
+        switch (kind) {
+            case ValueKind::Int:   return i;
+            case ValueKind::Float: return static_cast<int>(f);
+            case ValueKind::Char:  return c;
+            case ValueKind::Bool:  return b ? 1 : 0;
+            default:               return 0;
+        }
+    }
+    double as_float() const {
+        switch (kind) {
+            case ValueKind::Int:   return i;
+            case ValueKind::Float: return f;
+            case ValueKind::Char:  return c;
+            case ValueKind::Bool:  return b ? 1.0 : 0.0;
+            default:               return 0.0;
+        }
+    }
+    bool as_bool() const {
+        switch (kind) {
+            case ValueKind::Int:     return i != 0;
+            case ValueKind::Float:   return f != 0.0;
+            case ValueKind::Char:    return c != 0;
+            case ValueKind::Bool:    return b;
+            case ValueKind::Pointer: return target != nullptr;
+            default:                 return false;
+        }
+    }
+
+    // приведение арифметического значения к другому арифметическому тегу
+    Value cast(ValueKind to) const;
+};
+
+static_assert(sizeof(Value) <= 16, "Value must stay compact");
+static_assert(std::is_trivially_copyable_v<Value>, "Value is stored in raw array buffers");
+
+// Непрерывное хранилище массива. Элементы фундаментальных типов лежат без тега
+// (int — 4 байта, float — 8, char и bool — 1), тип элемента записан один раз;
+// указатели, строки и структуры хранятся как Value.
+class ArrayStorage {
+public:
+    // count элементов, равных init; тип элемента — тег init
+    void assign(std::size_t count, const Value& init);
+    void clear();
+
+    bool empty() const { return count == 0; }
+    std::size_t size() const { return count; }
+    ValueKind element_kind() const { return element; }
+
+    Value get(std::size_t i) const;
+    // запись с неявным преобразованием к типу элемента
+    void set(std::size_t i, const Value& v);
+
+private:
+    ValueKind element = ValueKind::Void;
+    std::size_t width = 0;
+    std::size_t count = 0;
+    std::vector<unsigned char> bytes;
+};
+
+// тег, соответствующий статическому типу (int -> Int, T* -> Pointer, ...)
+ValueKind kind_of(const std::shared_ptr<Type>& type);
+// значение по умолчанию для переменной данного типа
+Value default_value(const std::shared_ptr<Type>& type);
+// запись с неявным арифметическим преобразованием к типу слота;
+// в слот-структуру копируются значения полей, экземпляр остаётся прежним
+void store(Value& slot, const Value& v);
+
+// семантика операторов над значениями, общая для всех исполнителей;
+// + - * и унарный - над int при переполнении дают результат по модулю 2^32
+Value binary_operation(const Value& lhs, Operator op, const Value& rhs);
+Value unary_operation(const Value& v, Operator op);
+// результат операции над int не помещается в int: до исполнения такое выражение не вычисляется
+bool overflows(const Value& lhs, Operator op, const Value& rhs);
+bool overflows(const Value& v, Operator op);
+// чтение и запись ячейки, на которую указывает указатель (с проверкой границ)
+Value pointee(const Value& p);
+void assign_pointee(const Value& p, const Value& v);
+
+std::ostream& operator<<(std::ostream& out, const Value& v);
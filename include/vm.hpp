@@ -0,0 +1,35 @@
+#pragma once
+
+#include "bytecode.hpp"
+
+#include <vector>
+#include <memory>
+
+// Исполняет байткод, построенный Compiler: цикл выборки команд над окнами регистров.
+class VM {
+public:
+    VM();
+    ~VM();
+
+    // возвращает код завершения main
+    int run(const Program& program);
+
+private:
+    struct Frame {
+        const Function* function;
+        const Instruction* pc;
+        std::size_t base;       // начало окна регистров в stack
+        std::size_t box_base;   // начало переменных функции в boxes
+    };
+
+    std::shared_ptr<StructSymbol> instantiate(const StructSymbol& tmpl);
+
+    std::vector<Value> stack;
+    std::vector<Frame> frames;
+    // переменные вне регистров: массивы, структуры и те, чей адрес берут
+    std::vector<std::shared_ptr<VarSymbol>> boxes;
+    // владелец структуры, возвращённой из функции, пока вызывающий её не скопирует
+    std::shared_ptr<VarSymbol> returned;
+
+    static constexpr std::size_t max_depth = 100000;
+};
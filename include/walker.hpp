@@ -0,0 +1,108 @@
+#pragma once
+
+#include <utility>
+
+#include "ast.hpp"
+#include "declaration.hpp"
+#include "statement.hpp"
+#include "expression.hpp"
+
+// Обход дерева без двойной диспетчеризации: обработчик выбирается switch'ем по node.kind,
+// Derived::visit вызывается напрямую и может встраиваться (CRTP).
+// Derived объявляет visit для каждого конкретного вида узла, как в Visitor, но без virtual.
+template<typename Derived>
+class Walker {
+public:
+	void walk(ASTNode& node) {
+		auto& self = static_cast<Derived&>(*this);
+		switch (node.kind) {
+		case NodeKind::TranslationUnit:              return (void)self.visit(static_cast<TranslationUnit&>(node));
+
+		case NodeKind::VarDeclaration:               return (void)self.visit(static_cast<VarDeclaration&>(node));
+		case NodeKind::ParameterDeclaration:         return (void)self.visit(static_cast<ParameterDeclaration&>(node));
+		case NodeKind::FuncDeclaration:              return (void)self.visit(static_cast<FuncDeclaration&>(node));
+		case NodeKind::StructDeclaration:            return (void)self.visit(static_cast<StructDeclaration&>(node));
+		case NodeKind::ArrayDeclaration:             return (void)self.visit(static_cast<ArrayDeclaration&>(node));
+		case NodeKind::NameSpaceDeclaration:         return (void)self.visit(static_cast<NameSpaceDeclaration&>(node));
+
+		case NodeKind::CompoundStatement:            return (void)self.visit(static_cast<CompoundStatement&>(node));
+		case NodeKind::DeclarationStatement:         return (void)self.visit(static_cast<DeclarationStatement&>(node));
+		case NodeKind::ExpressionStatement:          return (void)self.visit(static_cast<ExpressionStatement&>(node));
+		case NodeKind::ConditionalStatement:         return (void)self.visit(static_cast<ConditionalStatement&>(node));
+		case NodeKind::WhileStatement:               return (void)self.visit(static_cast<WhileStatement&>(node));
+		case NodeKind::DoWhileStatement:             return (void)self.visit(static_cast<DoWhileStatement&>(node));
+		case NodeKind::ForStatement:                 return (void)self.visit(static_cast<ForStatement&>(node));
+		case NodeKind::ReturnStatement:              return (void)self.visit(static_cast<ReturnStatement&>(node));
+		case NodeKind::BreakStatement:               return (void)self.visit(static_cast<BreakStatement&>(node));
+		case NodeKind::ContinueStatement:            return (void)self.visit(static_cast<ContinueStatement&>(node));
+		case NodeKind::StaticAssertStatement:        return (void)self.visit(static_cast<StaticAssertStatement&>(node));
+
+		case NodeKind::BinaryOperation:              return (void)self.visit(static_cast<BinaryOperation&>(node));
+		case NodeKind::PrefixExpression:             return (void)self.visit(static_cast<PrefixExpression&>(node));
+		case NodeKind::PostfixIncrementExpression:   return (void)self.visit(static_cast<PostfixIncrementExpression&>(node));
+		case NodeKind::PostfixDecrementExpression:   return (void)self.visit(static_cast<PostfixDecrementExpression&>(node));
+		case NodeKind::FunctionCallExpression:       return (void)self.visit(static_cast<FunctionCallExpression&>(node));
+		case NodeKind::SubscriptExpression:          return (void)self.visit(static_cast<SubscriptExpression&>(node));
+		case NodeKind::StructMemberAccessExpression: return (void)self.visit(static_cast<StructMemberAccessExpression&>(node));
+		case NodeKind::IdentifierExpression:         return (void)self.visit(static_cast<IdentifierExpression&>(node));
+		case NodeKind::IntLiteral:                   return (void)self.visit(static_cast<IntLiteral&>(node));
+		case NodeKind::FloatLiteral:                 return (void)self.visit(static_cast<FloatLiteral&>(node));
+		case NodeKind::CharLiteral:                  return (void)self.visit(static_cast<CharLiteral&>(node));
+		case NodeKind::StringLiteral:                return (void)self.visit(static_cast<StringLiteral&>(node));
+		case NodeKind::BoolLiteral:                  return (void)self.visit(static_cast<BoolLiteral&>(node));
+		case NodeKind::NullPtrLiteral:               return (void)self.visit(static_cast<NullPtrLiteral&>(node));
+		case NodeKind::ParenthesizedExpression:      return (void)self.visit(static_cast<ParenthesizedExpression&>(node));
+		case NodeKind::TernaryExpression:            return (void)self.visit(static_cast<TernaryExpression&>(node));
+		case NodeKind::SizeOfExpression:             return (void)self.visit(static_cast<SizeOfExpression&>(node));
+		case NodeKind::NameSpaceAcceptExpression:    return (void)self.visit(static_cast<NameSpaceAcceptExpression&>(node));
+
+		// деклараторы не являются ASTNode и обходятся через walk(Declarator&)
+		case NodeKind::SimpleDeclarator:
+		case NodeKind::PtrDeclarator:
+			break;
+		}
+		self.visit(node);
+	}
+
+	// значение выражения: у обходчиков, вычисляющих выражения (Execute), visit выражения
+	// возвращает результат, и walk передаёт его вызывающему; у остальных это void
+	decltype(auto) walk(Expression& node) {
+		auto& self = static_cast<Derived&>(*this);
+		switch (node.kind) {
+		case NodeKind::BinaryOperation:              return self.visit(static_cast<BinaryOperation&>(node));
+		case NodeKind::PrefixExpression:             return self.visit(static_cast<PrefixExpression&>(node));
+		case NodeKind::PostfixIncrementExpression:   return self.visit(static_cast<PostfixIncrementExpression&>(node));
+		case NodeKind::PostfixDecrementExpression:   return self.visit(static_cast<PostfixDecrementExpression&>(node));
+		case NodeKind::FunctionCallExpression:       return self.visit(static_cast<FunctionCallExpression&>(node));
+		case NodeKind::SubscriptExpression:          return self.visit(static_cast<SubscriptExpression&>(node));
+		case NodeKind::StructMemberAccessExpression: return self.visit(static_cast<StructMemberAccessExpression&>(node));
+		case NodeKind::IdentifierExpression:         return self.visit(static_cast<IdentifierExpression&>(node));
+		case NodeKind::IntLiteral:                   return self.visit(static_cast<IntLiteral&>(node));
+		case NodeKind::FloatLiteral:                 return self.visit(static_cast<FloatLiteral&>(node));
+		case NodeKind::CharLiteral:                  return self.visit(static_cast<CharLiteral&>(node));
+		case NodeKind::StringLiteral:                return self.visit(static_cast<StringLiteral&>(node));
+		case NodeKind::BoolLiteral:                  return self.visit(static_cast<BoolLiteral&>(node));
+		case NodeKind::NullPtrLiteral:               return self.visit(static_cast<NullPtrLiteral&>(node));
+		case NodeKind::ParenthesizedExpression:      return self.visit(static_cast<ParenthesizedExpression&>(node));
+		case NodeKind::TernaryExpression:            return self.visit(static_cast<TernaryExpression&>(node));
+		case NodeKind::SizeOfExpression:             return self.visit(static_cast<SizeOfExpression&>(node));
+		case NodeKind::NameSpaceAcceptExpression:    return self.visit(static_cast<NameSpaceAcceptExpression&>(node));
+		default:
+			break;
+		}
+		// все виды выражений перечислены выше
+		std::unreachable();
+	}
+
+	void walk(Declaration::Declarator& declarator) {
+		auto& self = static_cast<Derived&>(*this);
+		if (auto ptr = node_cast<Declaration::PtrDeclarator>(&declarator)) {
+			return self.visit(*ptr);
+		}
+		self.visit(static_cast<Declaration::SimpleDeclarator&>(declarator));
+	}
+
+	void walk(Declaration::InitDeclarator& declarator) {
+		static_cast<Derived&>(*this).visit(declarator);
+	}
+};
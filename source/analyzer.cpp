@@ -3,12 +3,22 @@
 #include "semantic_exception.hpp"
 #include "type.hpp"
 
+// значение const-переменной в выражении — обычное значение её базового типа
+std::shared_ptr<Type> strip_const(const std::shared_ptr<Type>& type) {
+    if (auto cp = type_cast<ConstType>(type.get())) {
+        return cp->get_base();
+    }
+    return type;
+}
+
 int getTypeRank(const Type& type) {
-    if (dynamic_cast<const FloatType*>(&type))    return  3;
-    if (dynamic_cast<const IntegerType*>(&type))  return  2;
-    if (dynamic_cast<const CharType*>(&type))     return  1;
-    if (dynamic_cast<const BoolType*>(&type))     return 0;
-    return -2;
+    switch (type.kind) {
+        case TypeKind::Float:   return 3;
+        case TypeKind::Integer: return 2;
+        case TypeKind::Char:    return 1;
+        case TypeKind::Bool:    return 0;
+        default:                return -2;
+    }
 }
 
 std::shared_ptr<Type> compareRank(const std::shared_ptr<Type>& lhs, const std::shared_ptr<Type>& rhs) {
@@ -33,7 +43,7 @@ std::shared_ptr<Type> compareRank(const std::shared_ptr<Type>& lhs, const std::s
 bool canConvert(const std::shared_ptr<Type>& from,
                 const std::shared_ptr<Type>& to) {
     auto strip = [&](std::shared_ptr<Type> t){
-        if (auto cp = dynamic_cast<ConstType*>(t.get()))
+        if (auto cp = type_cast<ConstType>(t.get()))
             return cp->get_base();
         return t;
     };
@@ -41,8 +51,8 @@ bool canConvert(const std::shared_ptr<Type>& from,
     auto tt = strip(to);
 
     // 0) Array → Pointer
-    if (auto arr = dynamic_cast<ArrayType*>(f.get())) {
-        if (auto pt = dynamic_cast<PointerType*>(tt.get())) {
+    if (auto arr = type_cast<ArrayType>(f.get())) {
+        if (auto pt = type_cast<PointerType>(tt.get())) {
             if (arr->get_base_type()->equals(pt->get_base())) {
                 return true;
             }
@@ -53,23 +63,23 @@ bool canConvert(const std::shared_ptr<Type>& from,
     if (f->equals(tt)) return true;
 
     // 2) Арифметика → арифметика
-    if (dynamic_cast<Arithmetic*>(f.get()) &&
-        dynamic_cast<Arithmetic*>(tt.get()))
+    if (type_cast<Arithmetic>(f.get()) &&
+        type_cast<Arithmetic>(tt.get()))
         return true;
 
     // 3) nullptr → любой указатель
-    if (dynamic_cast<NullPtrType*>(f.get()) &&
-        dynamic_cast<PointerType*>(tt.get()))
+    if (type_cast<NullPtrType>(f.get()) &&
+        type_cast<PointerType>(tt.get()))
         return true;
 
     // 4) T* → T*
-    if (auto pf = dynamic_cast<PointerType*>(f.get())) {
-        if (auto pt = dynamic_cast<PointerType*>(tt.get())) {
+    if (auto pf = type_cast<PointerType>(f.get())) {
+        if (auto pt = type_cast<PointerType>(tt.get())) {
             auto bf = pf->get_base();
             auto bt = pt->get_base();
             if (bf->equals(bt)
-             || dynamic_cast<VoidType*>(bf.get())
-             || dynamic_cast<VoidType*>(bt.get())) {
+             || type_cast<VoidType>(bf.get())
+             || type_cast<VoidType>(bt.get())) {
                 return true;
             }
         }
@@ -79,12 +89,12 @@ bool canConvert(const std::shared_ptr<Type>& from,
 }
 
 
-std::unordered_map<std::string, std::shared_ptr<Type>> Analyzer::default_types = {
-    {"int",    std::make_shared<IntegerType>()},
-    {"float",  std::make_shared<FloatType>()},
-    {"char",   std::make_shared<CharType>()},
-    {"bool",   std::make_shared<BoolType>()},
-    {"void", std::make_shared<VoidType>()}
+std::unordered_map<Name, std::shared_ptr<Type>> Analyzer::default_types = {
+    {"int",    TypeContext::global().int_type()},
+    {"float",  TypeContext::global().float_type()},
+    {"char",   TypeContext::global().char_type()},
+    {"bool",   TypeContext::global().bool_type()},
+    {"void", TypeContext::global().void_type()}
 };
 
 Analyzer::Analyzer()
@@ -105,6 +115,32 @@ void Analyzer::analyze(TranslationUnit& unit) {
     }
 }
 
+// символ внутри функции получает слот кадра активации, вне функции — слот своей области
+int Analyzer::declare(Name name, std::shared_ptr<Symbol> symbol) {
+    if (!scope->frame) {
+        return scope->push_symbol(name, std::move(symbol));
+    }
+    int slot = scope->push_symbol(name, std::move(symbol), frame_top);
+    frame_size = std::max(frame_size, ++frame_top);
+    return slot;
+}
+
+// текущая область становится областью параметров нового кадра
+void Analyzer::open_frame() {
+    scope->frame = true;
+    frame_top = 0;
+    frame_size = 0;
+}
+
+void Analyzer::resolve(const std::shared_ptr<Symbol>& symbol, IdentifierExpression& node) {
+    node.member = member_scope && member_scope->find_local(node.name) == symbol;
+    if (node.member) {
+        node.depth = node.slot = -1;
+    } else {
+        scope->locate(symbol.get(), node.depth, node.slot);
+    }
+}
+
 void Analyzer::visit(TranslationUnit& unit) {
     VISIT_BODY_BEGIN
     for (auto& node : unit.get_nodes()) {
@@ -115,7 +151,7 @@ void Analyzer::visit(TranslationUnit& unit) {
 
 void Analyzer::visit(ASTNode& node) {
     VISIT_BODY_BEGIN
-    node.accept(*this);
+    walk(node);
     VISIT_BODY_END
 }
 
@@ -126,15 +162,15 @@ void Analyzer::visit(Declaration::SimpleDeclarator& node) {
 
 void Analyzer::visit(Declaration::PtrDeclarator& node) {
     VISIT_BODY_BEGIN
-    node.inner->accept(*this);
-    current_type = std::make_shared<PointerType>(current_type);
+    walk(*node.inner);
+    current_type = TypeContext::global().pointer_to(current_type);
     VISIT_BODY_END
 }
 void Analyzer::visit(Declaration::InitDeclarator& node) {
     VISIT_BODY_BEGIN
-    node.declarator->accept(*this);
+    walk(*node.declarator);
     if (node.initializer)
-        node.initializer->accept(*this);
+        walk(*node.initializer);
     VISIT_BODY_END
 }
 
@@ -146,7 +182,7 @@ void Analyzer::visit(VarDeclaration& node) {
     bool deduce_auto = false;
 
     // 1) Если «auto», то находим базовый тип из единственного initializer
-    if (node.type == "auto") {
+    if (node.type == known::auto_type) {
         deduce_auto = true;
 
         // 1.1) Требуем ровно один declarator с initializer
@@ -161,13 +197,13 @@ void Analyzer::visit(VarDeclaration& node) {
 
         // vitaskivaem type
         current_type = nullptr;
-        node.declarator_list.front()->initializer->accept(*this);
+        walk(*node.declarator_list.front()->initializer);
         if (!current_type) {
             throw SemanticException("cannot deduce type for auto");
         }
 
         // 1.3) Если это был ConstType, убираем верхний const
-        if (auto cp = dynamic_cast<ConstType*>(current_type.get())) {
+        if (auto cp = type_cast<ConstType>(current_type.get())) {
             base_t = cp->get_base();
         } else {
             base_t = current_type;
@@ -177,13 +213,13 @@ void Analyzer::visit(VarDeclaration& node) {
     else {
         base_t = get_type(node.type);
         if (node.is_const) {
-            base_t = std::make_shared<ConstType>(base_t);
+            base_t = TypeContext::global().const_of(base_t);
         }
     }
 
     // 3) Перебираем каждый InitDeclarator из списка
     for (auto& decl : node.declarator_list) {
-        const std::string& name = decl->declarator->name;
+        Name name = decl->declarator->name;
 
         // 3.1) Проверяем, нет ли уже такого имени в scope
         if (scope->contains_symbol(name)) {
@@ -198,7 +234,7 @@ void Analyzer::visit(VarDeclaration& node) {
             //         теперь «заходим» в node.declarator, 
             //         который может содержать несколько PtrDeclaratoов подряд
             //         каждый PtrDeclarator-invoke делает current_type = PointerType(current_type).
-            decl->declarator->accept(*this);
+            walk(*decl->declarator);
             //         В current_type сейчас именно тот тип, который напиши в объявлении:
             //          если было «int x;» → var_type == int
             //          если «int *x;» → var_type == int*
@@ -210,14 +246,15 @@ void Analyzer::visit(VarDeclaration& node) {
         }
 
 
-        scope->push_symbol(name, std::make_shared<VarSymbol>(var_type));
+        auto symbol = std::make_shared<VarSymbol>(var_type);
+        decl->slot = declare(name, symbol);
 
 
         if (decl->initializer) {
             // 3.4.1) Для не-auto: надо ещё раз вычислить тип RHS,
             //         потому что current_type уже «занулился» внутри сборки var_type
             if (!deduce_auto) {
-                decl->initializer->accept(*this);
+                walk(*decl->initializer);
             }
             // Сейчас current_type = тип RHS
             if (!canConvert(current_type, var_type)) {
@@ -225,6 +262,18 @@ void Analyzer::visit(VarDeclaration& node) {
                     "cannot initialize variable '" + name + "' with given type"
                 );
             }
+
+            // const-переменная с известным значением сворачивается в местах чтения;
+            // значение приводится к её типу так же, как при исполнении
+            if (type_cast<ConstType>(var_type.get())) {
+                if (auto init = constant_value(*decl->initializer)) {
+                    Value v = default_value(var_type);
+                    store(v, *init);
+                    if (v.is_arithmetic()) {
+                        constant_symbols[symbol] = v;
+                    }
+                }
+            }
         }
     }
 
@@ -240,10 +289,10 @@ void Analyzer::visit(ParameterDeclaration& node) {
     if (scope->contains_symbol(name)) {
         throw SemanticException("parameter already declared: " + name);
     }
-    scope->push_symbol(name, std::make_shared<VarSymbol>(base_t));
+    node.init_declarator->slot = declare(name, std::make_shared<VarSymbol>(base_t));
 
     if (node.init_declarator->initializer) {
-        node.init_declarator->initializer->accept(*this);
+        walk(*node.init_declarator->initializer);
         if (!canConvert(current_type, base_t)) {
             throw SemanticException("cannot initialize parameter '" + name + "' with given type");
         }
@@ -257,7 +306,7 @@ void Analyzer::visit(FuncDeclaration& node) {
 
     std::shared_ptr<Type> ret_t;
 
-    if (node.type == "auto") {
+    if (node.type == known::auto_type) {
 
         auto saved_scope = scope;
         bool saved_flag = is_deducing_return;
@@ -268,6 +317,7 @@ void Analyzer::visit(FuncDeclaration& node) {
 
        
         scope = scope->create_new_table(saved_scope);
+        open_frame();
 
         // регистрируем параметры, чтобы их можно было использовать в return-выражениях
         std::vector<std::shared_ptr<Type>> arg_ts_for_deduce;
@@ -277,11 +327,11 @@ void Analyzer::visit(FuncDeclaration& node) {
         }
         for (size_t i = 0; i < node.args.size(); ++i) {
             const auto& pname = node.args[i]->init_declarator->declarator->name;
-            scope->push_symbol(pname, std::make_shared<VarSymbol>(arg_ts_for_deduce[i]));
+            node.args[i]->init_declarator->slot = declare(pname, std::make_shared<VarSymbol>(arg_ts_for_deduce[i]));
         }
 
         
-        node.body->accept(*this);
+        walk(*node.body);
 
 
         if (!deduced_return_type) {
@@ -300,7 +350,7 @@ void Analyzer::visit(FuncDeclaration& node) {
         
         ret_t = get_type(node.type);
         if (node.is_const) {
-            ret_t = std::make_shared<ConstType>(ret_t);
+            ret_t = TypeContext::global().const_of(ret_t);
         }
     }
 
@@ -315,24 +365,36 @@ void Analyzer::visit(FuncDeclaration& node) {
         throw SemanticException("function already declared: " + fname);
     }
 
-    auto signature = std::make_shared<FuncType>(ret_t, arg_ts, node.is_readonly);
+    auto signature = TypeContext::global().function(ret_t, arg_ts, node.is_readonly);
     auto funcSym   = std::make_shared<FuncSymbol>(signature, arg_ts, node.is_readonly);
     funcSym->declaration = &node;
     scope->push_symbol(fname, funcSym);
 
-    // ======== Второй проход: валидация тела с известным ret_t ========
+    // тело, отложенное парсером, проверяется при первом вызове (analyze_body)
+    if (!node.deferred_body.empty()) {
+        return;
+    }
+    check_body(node, ret_t, arg_ts);
+
+    VISIT_BODY_END
+}
+
+// ======== Второй проход: валидация тела с известным ret_t ========
+void Analyzer::check_body(FuncDeclaration& node, std::shared_ptr<Type> ret_t,
+                          const std::vector<std::shared_ptr<Type>>& arg_ts) {
     return_type_stack.push_back(ret_t);
     auto saved_scope2 = scope;
     scope = scope->create_new_table(saved_scope2);
+    open_frame();
 
     // Регистрируем параметры как локальные переменные
     for (size_t i = 0; i < node.args.size(); ++i) {
         const auto& pname = node.args[i]->init_declarator->declarator->name;
-        scope->push_symbol(pname, std::make_shared<VarSymbol>(arg_ts[i]));
+        node.args[i]->init_declarator->slot = declare(pname, std::make_shared<VarSymbol>(arg_ts[i]));
 
         // Если у параметра есть initializer, проверяем canConvert
         if (node.args[i]->init_declarator->initializer) {
-            node.args[i]->init_declarator->initializer->accept(*this);
+            walk(*node.args[i]->init_declarator->initializer);
             if (!canConvert(current_type, arg_ts[i])) {
                 throw SemanticException(
                     "cannot initialize parameter '" + pname + "' with given type"
@@ -341,15 +403,38 @@ void Analyzer::visit(FuncDeclaration& node) {
         }
     }
 
-  
-    node.body->accept(*this);
-
+    walk(*node.body);
+    node.frame_size = frame_size;
 
     scope = saved_scope2;
     return_type_stack.pop_back();
+}
 
+// Отложенное тело функции верхнего уровня: разбирается, когда analyze уже закончен,
+// поэтому видит всю глобальную область, а не только объявленное выше функции.
+void Analyzer::analyze_body(FuncDeclaration& node) {
+    auto symbol = std::dynamic_pointer_cast<FuncSymbol>(scope->match_local(node.declarator->name));
+    if (!symbol || symbol->declaration != &node) {
+        throw std::runtime_error("function '" + node.declarator->name + "' was not analyzed");
+    }
+    auto signature = std::static_pointer_cast<FuncType>(symbol->type);
 
-    VISIT_BODY_END
+    std::size_t known_errors = errors.size();
+    auto saved_scope = scope;
+    try {
+        check_body(node, signature->get_returnable_type(), symbol->params);
+    } catch (const SemanticException& e) {
+        errors.push_back(e.what());
+    }
+    scope = saved_scope;
+    return_type_stack.clear();
+    if (errors.size() != known_errors) {
+        std::string message = "semantic errors in function '" + node.declarator->name + "':";
+        for (std::size_t i = known_errors; i < errors.size(); ++i) {
+            message += "\n  --> " + errors[i];
+        }
+        throw std::runtime_error(message);
+    }
 }
 
 
@@ -364,14 +449,14 @@ void Analyzer::visit(StructDeclaration& node) {
 
     // 2) Две карты: data_members для типов полей, methods для типов методов,
     //    и одна карта member_symbols для самих VarSymbol/FuncSymbol
-    std::unordered_map<std::string, std::shared_ptr<Type>>    data_members;
-    std::unordered_map<std::string, std::shared_ptr<FuncType>> methods;
-    std::unordered_map<std::string, std::shared_ptr<Symbol>>   member_symbols;
+    std::unordered_map<Name, std::shared_ptr<Type>>    data_members;
+    std::unordered_map<Name, std::shared_ptr<FuncType>> methods;
+    std::unordered_map<Name, std::shared_ptr<Symbol>>   member_symbols;
 
     for (auto& m : node.members) {
-        if (auto fld = dynamic_cast<VarDeclaration*>(m.get())) {
+        if (auto fld = node_cast<VarDeclaration>(m)) {
             // 3.1. Проанализировать поле, чтобы current_type = его тип
-            fld->accept(*this);
+            walk(*fld);
             const auto& fieldName = fld->declarator_list[0]->declarator->name;
 
             if (data_members.count(fieldName)) {
@@ -389,10 +474,10 @@ void Analyzer::visit(StructDeclaration& node) {
         }
 
 
-        else if (auto mtd = dynamic_cast<FuncDeclaration*>(m.get())) {
+        else if (auto mtd = node_cast<FuncDeclaration>(m)) {
             auto m_ret = get_type(mtd->type);
             if (mtd->is_const) {
-                m_ret = std::make_shared<ConstType>(m_ret);
+                m_ret = TypeContext::global().const_of(m_ret);
             }
 
 
@@ -401,7 +486,7 @@ void Analyzer::visit(StructDeclaration& node) {
                 m_args.push_back(get_type(p->type));
             }
 
-            auto m_ft = std::make_shared<FuncType>(m_ret, m_args, mtd->is_readonly);
+            auto m_ft = TypeContext::global().function(m_ret, m_args, mtd->is_readonly);
 
             const auto& methodName = mtd->declarator->name;
            
@@ -439,6 +524,30 @@ void Analyzer::visit(StructDeclaration& node) {
     );
     scope->push_symbol(node.name, structSym);
 
+    // тела методов проверяются как тела функций и получают свой кадр;
+    // поля и другие методы видны через область членов, которую при исполнении заменяет экземпляр
+    auto saved_scope = scope;
+    auto saved_member_scope = member_scope;
+    int saved_top = frame_top;
+    int saved_size = frame_size;
+    member_scope = scope->create_new_table(saved_scope);
+    member_scope->members = true;
+    for (auto& [member_name, member] : structSym->members) {
+        member_scope->push_symbol(member_name, member);
+    }
+    scope = member_scope;
+    for (auto& m : node.members) {
+        if (auto mtd = node_cast<FuncDeclaration>(m)) {
+            auto method = std::dynamic_pointer_cast<FuncSymbol>(structSym->members.at(mtd->declarator->name));
+            auto method_t = std::static_pointer_cast<FuncType>(method->type);
+            check_body(*mtd, method_t->get_returnable_type(), method->params);
+        }
+    }
+    scope = saved_scope;
+    member_scope = saved_member_scope;
+    frame_top = saved_top;
+    frame_size = saved_size;
+
     VISIT_BODY_END
 }
 
@@ -446,15 +555,34 @@ void Analyzer::visit(StructDeclaration& node) {
 void Analyzer::visit(ArrayDeclaration& node) {
     VISIT_BODY_BEGIN
 
-    node.size->accept(*this);
-    if (!dynamic_cast<Integral*>(current_type.get())) {
-        throw SemanticException("array size must be integer");
+    if (node.size) {
+        walk(*node.size);
+        if (!type_cast<Integral>(strip_const(current_type).get())) {
+            throw SemanticException("array size must be integer");
+        }
+        // размер, известный до исполнения, исполнители берут готовым
+        if (auto size = constant_value(*node.size)) {
+            node.length = size->as_int();
+            if (node.length < 0) {
+                throw SemanticException("array size must be non-negative");
+            }
+        }
+    } else {
+        node.length = static_cast<int>(node.initializer_list.size());
     }
 
     auto base_t = get_type(node.type);
-    auto arr_t  = std::make_shared<ArrayType>(base_t, node.size);
+    auto arr_t  = TypeContext::global().array_of(base_t);
+
+    // элементы инициализатора адресуются до объявления массива, как инициализатор переменной
+    for (auto element : node.initializer_list) {
+        walk(*element);
+        if (!canConvert(current_type, base_t)) {
+            throw SemanticException("cannot initialize element of array '" + node.name + "' with given type");
+        }
+    }
 
-    scope->push_symbol(node.name, std::make_shared<VarSymbol>(arr_t));
+    node.slot = declare(node.name, std::make_shared<VarSymbol>(arr_t));
 
     current_type = arr_t;
 
@@ -467,11 +595,15 @@ void Analyzer::visit(CompoundStatement& node) {
 
     auto saved = scope;
     scope = scope->create_new_table(saved);
+    scope->frame = saved->frame;
+    // слоты вложенного блока освобождаются на выходе и достаются соседним блокам
+    int saved_top = frame_top;
 
     for (auto& stmt : node.statements) {
-        stmt->accept(*this);
+        walk(*stmt);
     }
 
+    frame_top = saved_top;
     scope = saved;
 
     VISIT_BODY_END
@@ -485,7 +617,7 @@ void Analyzer::visit(NameSpaceDeclaration& node) {
 
     
     for (auto& decl : node.declarations) {
-        decl->accept(*this);
+        walk(*decl);
     }
 
     scope = saved;
@@ -495,25 +627,25 @@ void Analyzer::visit(NameSpaceDeclaration& node) {
 
 void Analyzer::visit(DeclarationStatement& node) {
     VISIT_BODY_BEGIN
-    node.declaration->accept(*this);
+    walk(*node.declaration);
     VISIT_BODY_END
 }
 
 void Analyzer::visit(ExpressionStatement& node) {
     VISIT_BODY_BEGIN
-    node.expression->accept(*this);
+    walk(*node.expression);
     VISIT_BODY_END
 }
 
 void Analyzer::visit(ConditionalStatement& node) {
     VISIT_BODY_BEGIN
 
-    node.if_branch.first->accept(*this);
-    if (!dynamic_cast<BoolType*>(current_type.get()))
+    walk(*node.if_branch.first);
+    if (!type_cast<BoolType>(current_type.get()))
         throw SemanticException("if condition must be boolean");
-    node.if_branch.second->accept(*this);
+    walk(*node.if_branch.second);
     if (node.else_branch) {
-        node.else_branch->accept(*this);
+        walk(*node.else_branch);
     }
 
     VISIT_BODY_END
@@ -521,11 +653,11 @@ void Analyzer::visit(ConditionalStatement& node) {
 
 void Analyzer::visit(WhileStatement& node) {
     VISIT_BODY_BEGIN
-    node.condition->accept(*this);
-    if (!dynamic_cast<BoolType*>(current_type.get()))
+    walk(*node.condition);
+    if (!type_cast<BoolType>(current_type.get()))
         throw SemanticException("while condition must be boolean");
 
-    node.statement->accept(*this);
+    walk(*node.statement);
     VISIT_BODY_END
 }
 
@@ -533,18 +665,18 @@ void Analyzer::visit(ForStatement& node) {
     VISIT_BODY_BEGIN
 
     if (node.initialization)
-        node.initialization->accept(*this);
+        walk(*node.initialization);
 
     if (node.condition) {
-        node.condition->accept(*this);
-        if (!dynamic_cast<BoolType*>(current_type.get()))
+        walk(*node.condition);
+        if (!type_cast<BoolType>(current_type.get()))
             throw SemanticException("for condition must be boolean");
     }
 
     if (node.increment)
-        node.increment->accept(*this);
+        walk(*node.increment);
 
-    node.body->accept(*this);
+    walk(*node.body);
     VISIT_BODY_END
 }
 
@@ -555,10 +687,10 @@ void Analyzer::visit(ReturnStatement& node) {
     // если мы в режиме дедукции, просто собираем типы и строго проверяем совпадение
     if (is_deducing_return) {
         if (node.expression) {
-            node.expression->accept(*this);
+            walk(*node.expression);
             // Убираем const-обёртку, если есть
             std::shared_ptr<Type> expr_base = current_type;
-            if (auto cp = dynamic_cast<ConstType*>(current_type.get())) {
+            if (auto cp = type_cast<ConstType>(current_type.get())) {
                 expr_base = cp->get_base();
             }
 
@@ -578,7 +710,7 @@ void Analyzer::visit(ReturnStatement& node) {
             if (!deduced_return_type) {
                 deduced_return_type = voidType;
             } else {
-                if (!dynamic_cast<VoidType*>(deduced_return_type.get())) {
+                if (!type_cast<VoidType>(deduced_return_type.get())) {
                     throw SemanticException(
                         "deduced return type conflicts with void in auto-function"
                     );
@@ -595,15 +727,15 @@ void Analyzer::visit(ReturnStatement& node) {
     // ожидаемый тип — верхушка стека
     auto declared = return_type_stack.back();
     std::shared_ptr<Type> declared_base = declared;
-    if (auto cp = dynamic_cast<ConstType*>(declared.get())) {
+    if (auto cp = type_cast<ConstType>(declared.get())) {
         declared_base = cp->get_base();
     }
 
     if (node.expression) {
-        node.expression->accept(*this);
+        walk(*node.expression);
         auto expr_t = current_type;
         std::shared_ptr<Type> expr_base = expr_t;
-        if (auto cp = dynamic_cast<ConstType*>(expr_t.get())) {
+        if (auto cp = type_cast<ConstType>(expr_t.get())) {
             expr_base = cp->get_base();
         }
 
@@ -616,7 +748,7 @@ void Analyzer::visit(ReturnStatement& node) {
         current_type = declared_base;
     } else {
         // «return;» без expr -> только в void-функции
-        if (!dynamic_cast<VoidType*>(declared_base.get())) {
+        if (!type_cast<VoidType>(declared_base.get())) {
             throw SemanticException("non-void function must return a value");
         }
         current_type = declared_base;
@@ -632,20 +764,20 @@ void Analyzer::visit(ContinueStatement& /*node*/) {}
 void Analyzer::visit(BinaryOperation& node) {
     VISIT_BODY_BEGIN
 
-    if (node.op == "=") {
-        node.lhs->accept(*this);
+    if (node.op == Operator::Assign) {
+        walk(*node.lhs);
         auto lhs_t = current_type;
-        if (dynamic_cast<ConstType*>(lhs_t.get())) {
+        if (type_cast<ConstType>(lhs_t.get())) {
             throw SemanticException("assignment to const variable");
         }
-        node.rhs->accept(*this);
+        walk(*node.rhs);
         auto rhs_t = current_type;
 
         if (!rhs_t->equals(lhs_t) &&
-            !(dynamic_cast<Arithmetic*>(rhs_t.get()) &&
-              dynamic_cast<Arithmetic*>(lhs_t.get())) &&
-            !(dynamic_cast<NullPtrType*>(rhs_t.get()) &&
-              dynamic_cast<PointerType*>(lhs_t.get()))) 
+            !(type_cast<Arithmetic>(rhs_t.get()) &&
+              type_cast<Arithmetic>(lhs_t.get())) &&
+            !(type_cast<NullPtrType>(rhs_t.get()) &&
+              type_cast<PointerType>(lhs_t.get()))) 
         {
             throw SemanticException("type mismatch in assignment");
         }
@@ -653,41 +785,66 @@ void Analyzer::visit(BinaryOperation& node) {
         return;
     }
 
+    // «a op= b»: a — изменяемая переменная, op допустим для типов a и b
+    if (is_compound_assignment(node.op)) {
+        walk(*node.lhs);
+        auto lhs_t = current_type;
+        if (type_cast<ConstType>(lhs_t.get())) {
+            throw SemanticException("assignment to const variable");
+        }
+        walk(*node.rhs);
+        auto rhs_t = strip_const(current_type);
+
+        bool ok = is_integral_operation(compound_operation(node.op))
+                ? type_cast<Integral>(lhs_t.get()) && type_cast<Integral>(rhs_t.get())
+                : type_cast<Arithmetic>(lhs_t.get()) && type_cast<Arithmetic>(rhs_t.get());
+        // p += n, p -= n
+        if ((node.op == Operator::AddAssign || node.op == Operator::SubAssign) &&
+            type_cast<PointerType>(lhs_t.get()) && type_cast<IntegerType>(rhs_t.get()))
+        {
+            ok = true;
+        }
+        if (!ok) {
+            throw SemanticException("invalid operands for " + spelling(node.op));
+        }
+        current_type = lhs_t;
+        return;
+    }
 
-    node.lhs->accept(*this);
-    auto leftType  = current_type;
-    node.rhs->accept(*this);
-    auto rightType = current_type;
+    walk(*node.lhs);
+    auto leftType  = strip_const(current_type);
+    walk(*node.rhs);
+    auto rightType = strip_const(current_type);
 
 
     std::shared_ptr<Type> realLeft  = leftType;
     std::shared_ptr<Type> realRight = rightType;
 
-    if (auto arrL = dynamic_cast<ArrayType*>(leftType.get())) {
-        realLeft = std::make_shared<PointerType>(arrL->get_base_type());
+    if (auto arrL = type_cast<ArrayType>(leftType.get())) {
+        realLeft = TypeContext::global().pointer_to(arrL->get_base_type());
     }
-    if (auto arrR = dynamic_cast<ArrayType*>(rightType.get())) {
-        realRight = std::make_shared<PointerType>(arrR->get_base_type());
+    if (auto arrR = type_cast<ArrayType>(rightType.get())) {
+        realRight = TypeContext::global().pointer_to(arrR->get_base_type());
     }
 
     //  указательная арифметика: T* + int, T* - int, T* - T*
-    if ((node.op == "+" || node.op == "-") &&
-         dynamic_cast<PointerType*>(realLeft.get()))
+    if ((node.op == Operator::Add || node.op == Operator::Sub) &&
+         type_cast<PointerType>(realLeft.get()))
     {
-        auto ptrL = std::dynamic_pointer_cast<PointerType>(realLeft);
+        auto ptrL = type_pointer_cast<PointerType>(realLeft);
         auto baseL = ptrL->get_base();
 
         //  «T* + int» или «T* - int» -> результат того же T*
-        if (dynamic_cast<IntegerType*>(realRight.get())) {
+        if (type_cast<IntegerType>(realRight.get())) {
             current_type = realLeft;
             return;
         }
 
         // 3.2) «T* - T*» -> целое (ptrdiff), только для одинаковых базовых T*
-        if (node.op == "-" &&
-            dynamic_cast<PointerType*>(realRight.get()))
+        if (node.op == Operator::Sub &&
+            type_cast<PointerType>(realRight.get()))
         {
-            auto ptrR = std::dynamic_pointer_cast<PointerType>(realRight);
+            auto ptrR = type_pointer_cast<PointerType>(realRight);
             if (!ptrR->get_base()->equals(baseL)) {
                 throw SemanticException("pointer subtraction with mismatched base types");
             }
@@ -697,18 +854,15 @@ void Analyzer::visit(BinaryOperation& node) {
     }
 
     // обычные сравнения (<, >, <=, >=, ==, !=) - для чисел и указателей
-    if (node.op == "<" || node.op == ">" ||
-        node.op == "<=" || node.op == ">=" ||
-        node.op == "==" || node.op == "!=")
-    {
-        bool ok_arith = dynamic_cast<Arithmetic*>(leftType.get()) &&
-                        dynamic_cast<Arithmetic*>(rightType.get());
-        bool ok_ptr   = dynamic_cast<PointerType*>(realLeft.get()) &&
-                        dynamic_cast<PointerType*>(realRight.get());
-        bool ok_nullL = dynamic_cast<NullPtrType*>(leftType.get()) &&
-                        dynamic_cast<PointerType*>(realRight.get());
-        bool ok_nullR = dynamic_cast<PointerType*>(realLeft.get()) &&
-                        dynamic_cast<NullPtrType*>(rightType.get());
+    if (is_comparison(node.op)) {
+        bool ok_arith = type_cast<Arithmetic>(leftType.get()) &&
+                        type_cast<Arithmetic>(rightType.get());
+        bool ok_ptr   = type_cast<PointerType>(realLeft.get()) &&
+                        type_cast<PointerType>(realRight.get());
+        bool ok_nullL = type_cast<NullPtrType>(leftType.get()) &&
+                        type_cast<PointerType>(realRight.get());
+        bool ok_nullR = type_cast<PointerType>(realLeft.get()) &&
+                        type_cast<NullPtrType>(rightType.get());
 
         if (ok_arith || ok_ptr || ok_nullL || ok_nullR) {
             current_type = Analyzer::default_types.at("bool");
@@ -718,9 +872,9 @@ void Analyzer::visit(BinaryOperation& node) {
     }
 
     // логические «&&» и «||» - только bool
-    if (node.op == "&&" || node.op == "||") {
-        if (!dynamic_cast<BoolType*>(leftType.get()) ||
-            !dynamic_cast<BoolType*>(rightType.get()))
+    if (node.op == Operator::And || node.op == Operator::Or) {
+        if (!type_cast<BoolType>(leftType.get()) ||
+            !type_cast<BoolType>(rightType.get()))
         {
             throw SemanticException("logical &&/|| require boolean operands");
         }
@@ -728,12 +882,23 @@ void Analyzer::visit(BinaryOperation& node) {
         return;
     }
 
+    // %, сдвиги и поразрядные - только для целых
+    if (is_integral_operation(node.op)) {
+        if (!type_cast<Integral>(leftType.get()) ||
+            !type_cast<Integral>(rightType.get()))
+        {
+            throw SemanticException("operator " + spelling(node.op) + " requires integral operands");
+        }
+        current_type = compareRank(leftType, rightType);
+        return;
+    }
+
     // обычные арифметические +, -, *, / для чисел
-    if (node.op == "+" || node.op == "-" ||
-        node.op == "*" || node.op == "/")
+    if (node.op == Operator::Add || node.op == Operator::Sub ||
+        node.op == Operator::Mul || node.op == Operator::Div)
     {
-        if (!dynamic_cast<Arithmetic*>(leftType.get()) ||
-            !dynamic_cast<Arithmetic*>(rightType.get()))
+        if (!type_cast<Arithmetic>(leftType.get()) ||
+            !type_cast<Arithmetic>(rightType.get()))
         {
             throw SemanticException("binary arithmetic operation requires arithmetic types");
         }
@@ -746,7 +911,7 @@ void Analyzer::visit(BinaryOperation& node) {
         return;
     }
 
-    throw SemanticException("unsupported binary operator: " + node.op);
+    throw SemanticException("unsupported binary operator: " + spelling(node.op));
 
     VISIT_BODY_END
 }
@@ -755,18 +920,18 @@ void Analyzer::visit(PrefixExpression& node) {
     VISIT_BODY_BEGIN
 
     // сначала вычисляем тип «внутреннего» узла
-    node.base->accept(*this);
+    walk(*node.base);
     auto base_t = current_type;
 
     // оператор «&» просто делаем указатель на base_t
-    if (node.op == "&") {
-        current_type = std::make_shared<PointerType>(base_t);
+    if (node.op == Operator::AddressOf) {
+        current_type = TypeContext::global().pointer_to(base_t);
         return;
     }
 
 
-    if (node.op == "*") {
-        auto pType = dynamic_cast<PointerType*>(base_t.get());
+    if (node.op == Operator::Dereference) {
+        auto pType = type_cast<PointerType>(base_t.get());
         if (!pType) {
             throw SemanticException("cannot dereference non-pointer type");
         }
@@ -775,7 +940,7 @@ void Analyzer::visit(PrefixExpression& node) {
     }
 
 
-    if (dynamic_cast<Arithmetic*>(base_t.get()) == nullptr) {
+    if (type_cast<Arithmetic>(base_t.get()) == nullptr) {
         throw SemanticException("invalid type for prefix operation");
     }
     VISIT_BODY_END
@@ -783,16 +948,16 @@ void Analyzer::visit(PrefixExpression& node) {
 
 void Analyzer::visit(PostfixIncrementExpression& node) {
     VISIT_BODY_BEGIN
-    node.base->accept(*this);
-    if (dynamic_cast<Arithmetic*>(current_type.get()) == nullptr)
+    walk(*node.base);
+    if (type_cast<Arithmetic>(current_type.get()) == nullptr)
         throw SemanticException("invalid type for postfix increment");
     VISIT_BODY_END
 }
 
 void Analyzer::visit(PostfixDecrementExpression& node) {
     VISIT_BODY_BEGIN
-    node.base->accept(*this);
-    if (dynamic_cast<Arithmetic*>(current_type.get()) == nullptr)
+    walk(*node.base);
+    if (type_cast<Arithmetic>(current_type.get()) == nullptr)
         throw SemanticException("invalid type for postfix decrement");
     VISIT_BODY_END
 }
@@ -803,9 +968,9 @@ void Analyzer::visit(FunctionCallExpression& node) {
     // собираем фактические типы аргументов
     std::vector<std::shared_ptr<Type>> arg_types;
     for (auto& arg : node.args) {
-        arg->accept(*this);
+        walk(*arg);
         auto t = current_type;
-        if (auto cp = dynamic_cast<ConstType*>(t.get()))
+        if (auto cp = type_cast<ConstType>(t.get()))
             t = cp->get_base();
         arg_types.push_back(t);
     }
@@ -813,33 +978,33 @@ void Analyzer::visit(FunctionCallExpression& node) {
     std::shared_ptr<FuncType> func_t;
 
     //  вызов метода структуры: obj.method(...)
-    if (auto mexpr = dynamic_cast<StructMemberAccessExpression*>(node.base.get())) {
-        mexpr->accept(*this);
-        func_t = std::dynamic_pointer_cast<FuncType>(current_type);
+    if (auto mexpr = node_cast<StructMemberAccessExpression>(node.base)) {
+        walk(*mexpr);
+        func_t = type_pointer_cast<FuncType>(current_type);
         if (!func_t)
             throw SemanticException("expression is not a method");
 
 
     //  простой свободный вызов: f(...)
-    } else if (auto ident = dynamic_cast<IdentifierExpression*>(node.base.get())) {
-         if (ident->name == "print") {
+    } else if (auto ident = node_cast<IdentifierExpression>(node.base)) {
+         if (ident->name == known::print) {
             
-            auto voidType = std::make_shared<VoidType>();
+            auto voidType = TypeContext::global().void_type();
             current_type = voidType;
 
             
             bool already_registered = true;
             try {
-                scope->match_global("print");
+                scope->match_global(known::print);
             } catch (...) {
                 already_registered = false;
             }
 
             if (!already_registered) {
-                auto printType = std::make_shared<FuncType>(voidType, arg_types, /*readonly=*/false);
+                auto printType = TypeContext::global().function(voidType, arg_types, /*readonly=*/false);
                 auto printSym = std::make_shared<FuncSymbol>(printType, arg_types, /*readonly=*/false);
                 printSym->declaration = nullptr; // у встроенной функции нет AST-тела
-                scope->push_symbol("print", printSym);
+                scope->push_symbol(known::print, printSym);
             }
 
 
@@ -847,17 +1012,17 @@ void Analyzer::visit(FunctionCallExpression& node) {
         
         }
 
-        if (ident->name == "read") {
+        if (ident->name == known::read) {
             
             if (arg_types.size() != 1) {
                 throw SemanticException("read() requires exactly one argument");
             }
             auto paramType = arg_types[0].get();
             bool okType = false;
-            if (dynamic_cast<Arithmetic*>(paramType)) okType = true;
-            if (dynamic_cast<CharType*>(paramType))     okType = true;
-            if (dynamic_cast<BoolType*>(paramType))     okType = true;
-            if (dynamic_cast<StringType*>(paramType))   okType = true;
+            if (type_cast<Arithmetic>(paramType)) okType = true;
+            if (type_cast<CharType>(paramType))     okType = true;
+            if (type_cast<BoolType>(paramType))     okType = true;
+            if (type_cast<StringType>(paramType))   okType = true;
             if (!okType) {
                 throw SemanticException(
                     "read(): unsupported type—only int/float/char/bool/string are allowed"
@@ -870,17 +1035,17 @@ void Analyzer::visit(FunctionCallExpression& node) {
             
             bool already_registered = true;
             try {
-                scope->match_global("read");
+                scope->match_global(known::read);
             } catch (...) {
                 already_registered = false;
             }
 
             if (!already_registered) {
                 std::vector<std::shared_ptr<Type>> params = { arg_types[0] };
-                auto readType = std::make_shared<FuncType>( arg_types[0], params, /*readonly=*/false );
+                auto readType = TypeContext::global().function( arg_types[0], params, /*readonly=*/false );
                 auto readSym  = std::make_shared<FuncSymbol>( readType, params, /*readonly=*/false );
                 readSym->declaration = nullptr;
-                scope->push_symbol("read", readSym);
+                scope->push_symbol(known::read, readSym);
             }
 
             return;
@@ -892,7 +1057,7 @@ void Analyzer::visit(FunctionCallExpression& node) {
             if (!fs) continue;
 
             // явно приводим к FuncType
-            auto ftype = std::dynamic_pointer_cast<FuncType>(fs->type);
+            auto ftype = type_pointer_cast<FuncType>(fs->type);
             if (!ftype) continue;
 
             // проверяем параметры
@@ -909,6 +1074,10 @@ void Analyzer::visit(FunctionCallExpression& node) {
             }
             if (match) {
                 func_t = ftype;
+                resolve(sym, *ident);
+                if (fs->declaration) {
+                    callees[&node] = fs->declaration;
+                }
                 break;
             }
         }
@@ -917,8 +1086,8 @@ void Analyzer::visit(FunctionCallExpression& node) {
 
     //  вызов через выражение: (expr)(...)
     } else {
-        node.base->accept(*this);
-        func_t = std::dynamic_pointer_cast<FuncType>(current_type);
+        walk(*node.base);
+        func_t = type_pointer_cast<FuncType>(current_type);
         if (!func_t)
             throw SemanticException("expression is not a function");
 
@@ -939,12 +1108,12 @@ void Analyzer::visit(FunctionCallExpression& node) {
 
 void Analyzer::visit(SubscriptExpression& node) {
     VISIT_BODY_BEGIN
-    node.base->accept(*this);
-    auto arr_t = std::dynamic_pointer_cast<ArrayType>(current_type);
+    walk(*node.base);
+    auto arr_t = type_pointer_cast<ArrayType>(current_type);
     if (!arr_t)
         throw SemanticException("expression is not an array");
-    node.index->accept(*this);
-    if (dynamic_cast<Integral*>(current_type.get()) == nullptr)
+    walk(*node.index);
+    if (type_cast<Integral>(strip_const(current_type).get()) == nullptr)
         throw SemanticException("index must be an integer");
     current_type = arr_t->get_base_type();
     VISIT_BODY_END
@@ -953,11 +1122,8 @@ void Analyzer::visit(SubscriptExpression& node) {
 void Analyzer::visit(IdentifierExpression& node) {
     VISIT_BODY_BEGIN
 
-    std::shared_ptr<Symbol> sym;
-    try {
-        
-        sym = scope->match_global(node.name);
-    } catch (const std::runtime_error&) {
+    const auto& sym = scope->find(node.name);
+    if (!sym) {
         throw SemanticException("undefined variable: " + node.name);
     }
 
@@ -966,6 +1132,10 @@ void Analyzer::visit(IdentifierExpression& node) {
     if (!varSym) {
         throw SemanticException(node.name + " is not a variable");
     }
+    resolve(sym, node);
+    if (auto it = constant_symbols.find(sym); it != constant_symbols.end()) {
+        constants[&node] = it->second;
+    }
 
 
     current_type = varSym->type;
@@ -974,55 +1144,55 @@ void Analyzer::visit(IdentifierExpression& node) {
 }
 void Analyzer::visit(IntLiteral& node){   
     VISIT_BODY_BEGIN
-    current_type = std::make_shared<IntegerType>(static_cast<int8_t>(node.value)); 
+    current_type = TypeContext::global().int_type(); 
     VISIT_BODY_END
 }
 void Analyzer::visit(FloatLiteral& node) { 
     VISIT_BODY_BEGIN
-     current_type = std::make_shared<FloatType>(static_cast<double>(node.value));
+     current_type = TypeContext::global().float_type();
     VISIT_BODY_END
 }
 void Analyzer::visit(CharLiteral& node){ 
     VISIT_BODY_BEGIN
-    current_type = std::make_shared<CharType>(static_cast<char16_t>(node.value)); 
+    current_type = TypeContext::global().char_type(); 
     VISIT_BODY_END
 }
 void Analyzer::visit(StringLiteral& node) { 
     VISIT_BODY_BEGIN
-    current_type = std::make_shared<StringType>(node.value); 
+    current_type = TypeContext::global().string_type(); 
     VISIT_BODY_END
 }
 void Analyzer::visit(BoolLiteral& node) { 
     VISIT_BODY_BEGIN
-    current_type = std::make_shared<BoolType>(node.value); 
+    current_type = TypeContext::global().bool_type(); 
     VISIT_BODY_END
 }
 
 void Analyzer::visit(NullPtrLiteral& /*node*/) {
     VISIT_BODY_BEGIN
-    current_type = std::make_shared<NullPtrType>();
+    current_type = TypeContext::global().nullptr_type();
     VISIT_BODY_END
 }
 
 void Analyzer::visit(ParenthesizedExpression& node) {
     VISIT_BODY_BEGIN
-    node.expression->accept(*this);
+    walk(*node.expression);
     VISIT_BODY_END
 }
 
 void Analyzer::visit(TernaryExpression& node) {
     VISIT_BODY_BEGIN
-    node.condition->accept(*this);
-    if (!dynamic_cast<BoolType*>(current_type.get()))
+    walk(*node.condition);
+    if (!type_cast<BoolType>(current_type.get()))
         throw SemanticException("ternary condition must be boolean");
 
-    node.true_expr->accept(*this);
+    walk(*node.true_expr);
     auto left = current_type;
-    node.false_expr->accept(*this);
+    walk(*node.false_expr);
     auto right = current_type;
 
-    if (dynamic_cast<Arithmetic*>(left.get()) == nullptr
-     || dynamic_cast<Arithmetic*>(right.get()) == nullptr) {
+    if (type_cast<Arithmetic>(left.get()) == nullptr
+     || type_cast<Arithmetic>(right.get()) == nullptr) {
         throw SemanticException("ternary expression requires arithmetic types");
     }
     int rl = getTypeRank(*left);
@@ -1039,35 +1209,30 @@ void Analyzer::visit(StructMemberAccessExpression& node) {
     VISIT_BODY_BEGIN
 
     // сначала получаем тип базового выражения
-    node.base->accept(*this);
+    walk(*node.base);
 
     // распаковываем возможный const-обёртку
     bool obj_const = false;
     std::shared_ptr<Type> obj_t = current_type;
-    if (auto cp = dynamic_cast<ConstType*>(obj_t.get())) {
+    if (auto cp = type_cast<ConstType>(obj_t.get())) {
         obj_const = true;
         obj_t = cp->get_base();
     }
 
     // проверяем, что это действительно StructType
-    auto struct_t = std::dynamic_pointer_cast<StructType>(obj_t);
+    auto struct_t = type_pointer_cast<StructType>(obj_t);
     if (!struct_t) {
         throw SemanticException("expression is not a struct");
     }
 
     // сначала пробуем поле
-    const auto& members = struct_t->get_members();
-    auto fit = members.find(node.member);
-    if (fit != members.end()) {
-        current_type = fit->second;
+    if (const auto& field_t = struct_t->find_member(node.member)) {
+        current_type = field_t;
         return;
     }
 
     // затем пробуем метод
-    const auto& methods = struct_t->get_methods();
-    auto mit = methods.find(node.member);
-    if (mit != methods.end()) {
-        auto func_t = mit->second;
+    if (const auto& func_t = struct_t->find_method(node.member)) {
         // если объект const, метод тоже должен быть const
         if (obj_const && !func_t->is_method_const()) {
             throw SemanticException(
@@ -1088,17 +1253,15 @@ void Analyzer::visit(SizeOfExpression& node) {
     if (node.is_type) {
         current_type = get_type(node.type_name);
     } else {
-        node.expression->accept(*this);
-        current_type = std::make_shared<IntegerType>(sizeof(void*));
+        walk(*node.expression);
+        current_type = TypeContext::global().int_type();
     }
     VISIT_BODY_END
 }
 
-std::shared_ptr<Type> Analyzer::get_type(const std::string& name) {
-    std::shared_ptr<Symbol> sym;
-    try {
-        sym = scope->match_global(name);
-    } catch (const std::runtime_error&) {
+std::shared_ptr<Type> Analyzer::get_type(Name name) {
+    const auto& sym = scope->find(name);
+    if (!sym) {
         //  если не нашли - пробуем встроенные типы
         auto it = default_types.find(name);
         if (it != default_types.end())
@@ -1117,9 +1280,9 @@ std::shared_ptr<Type> Analyzer::get_type(const std::string& name) {
 void Analyzer::visit(DoWhileStatement& node) {
     VISIT_BODY_BEGIN
 
-    node.statement->accept(*this);
-    node.condition->accept(*this);
-    if (!dynamic_cast<BoolType*>(current_type.get()))
+    walk(*node.statement);
+    walk(*node.condition);
+    if (!type_cast<BoolType>(current_type.get()))
         throw SemanticException("do-while condition must be boolean");
 
     VISIT_BODY_END
@@ -1130,14 +1293,12 @@ void Analyzer::visit(DoWhileStatement& node) {
 void Analyzer::visit(NameSpaceAcceptExpression& node) {
     VISIT_BODY_BEGIN
 
-    auto baseId = dynamic_cast<IdentifierExpression*>(node.base.get());
+    auto baseId = node_cast<IdentifierExpression>(node.base);
     if (!baseId)
         throw SemanticException("left side of '::' must be a namespace name");
 
-    std::shared_ptr<Symbol> sym;
-    try {
-        sym = scope->match_global(baseId->name);
-    } catch (const std::runtime_error&) {
+    const auto& sym = scope->find(baseId->name);
+    if (!sym) {
         throw SemanticException("undefined namespace: " + baseId->name);
     }
 
@@ -1150,10 +1311,8 @@ void Analyzer::visit(NameSpaceAcceptExpression& node) {
     scope = nsSym->scope;
 
     
-    std::shared_ptr<Symbol> member;
-    try {
-        member = scope->match_global(node.name);
-    } catch (const std::runtime_error&) {
+    const auto& member = scope->find(node.name);
+    if (!member) {
         throw SemanticException("undefined symbol: " + node.name +
                                 " in namespace " + baseId->name);
     }
@@ -1178,43 +1337,20 @@ void Analyzer::visit(NameSpaceAcceptExpression& node) {
 
 void Analyzer::visit(StaticAssertStatement& node) {
     VISIT_BODY_BEGIN
-    node.condition->accept(*this);
-    if (!dynamic_cast<BoolType*>(current_type.get()) &&
-        !dynamic_cast<Integral*>(current_type.get()))
+    walk(*node.condition);
+    if (!type_cast<BoolType>(current_type.get()) &&
+        !type_cast<Integral>(current_type.get()))
         throw SemanticException("static_assert requires constant boolean/integral");
-    if (!evaluateConstant(node.condition.get()))
-        throw SemanticException("static assertion failed: " + node.msg);
+    auto condition = constant_value(*node.condition);
+    if (!condition)
+        throw SemanticException("static_assert requires compile-time constant expression");
+    if (!condition->as_bool())
+        throw SemanticException("static assertion failed: " + std::string(node.msg));
     VISIT_BODY_END
 }
 
-bool Analyzer::evaluateConstant(ASTNode* expr) {
-    if (auto b = dynamic_cast<BoolLiteral*>(expr)) {
-        return b->value;
-    }
-    if (auto i = dynamic_cast<IntLiteral*>(expr)) {
-        return i->value != 0;
-    }
-    if (auto bin = dynamic_cast<BinaryOperation*>(expr)) {
-        bool l = evaluateConstant(bin->lhs.get());
-        bool r = evaluateConstant(bin->rhs.get());
-        
-        if (bin->op == "+")        return l + r;
-        else if (bin->op == "-")   return l - r;
-        else if (bin->op == "*")   return l * r;
-        else if (bin->op == "/")   return r ? (l / r) : false;
-        
-        else if (bin->op == "<")   return l < r;
-        else if (bin->op == ">")   return l > r;
-        else if (bin->op == "<=")  return l <= r;
-        else if (bin->op == ">=")  return l >= r;
-        else if (bin->op == "==")  return l == r;
-        else if (bin->op == "!=")  return l != r;
-
-        else if (bin->op == "&&")  return l && r;
-        else if (bin->op == "||")  return l || r;
-
-        throw SemanticException("unsupported operator in static_assert: " + bin->op);
-    }
-    throw SemanticException("static_assert requires compile-time constant expression");
+std::optional<Value> Analyzer::constant_value(Expression& expression) {
+    return ConstantFolder(constants, callees).evaluate(expression);
 }
 
+
@@ -0,0 +1,24 @@
+#include "arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+void* Arena::allocate(std::size_t size, std::size_t align) {
+    auto address = reinterpret_cast<std::uintptr_t>(cursor);
+    std::size_t padding = (align - address % align) % align;
+
+    if (!cursor || padding + size > static_cast<std::size_t>(limit - cursor)) {
+        // крупный объект получает собственный блок
+        std::size_t capacity = std::max(block_size, size + align);
+        blocks.push_back(std::make_unique_for_overwrite<std::byte[]>(capacity));
+        cursor = blocks.back().get();
+        limit = cursor + capacity;
+        address = reinterpret_cast<std::uintptr_t>(cursor);
+        padding = (align - address % align) % align;
+    }
+
+    void* place = cursor + padding;
+    cursor += padding + size;
+    bytes += size;
+    return place;
+}
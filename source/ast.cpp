@@ -1,10 +1,10 @@
 #include "ast.hpp"
 #include "visitor.hpp"
 
-TranslationUnit::TranslationUnit(const std::vector<std::shared_ptr<ASTNode>>& declarations)
-    : declarations(declarations) {}
+TranslationUnit::TranslationUnit(node_list<ASTNode> declarations, std::unique_ptr<Arena> arena)
+    : ASTNode(node_kind), declarations(declarations), arena(std::move(arena)) {}
 
-std::vector<std::shared_ptr<ASTNode>>& TranslationUnit::get_nodes(){
+node_list<ASTNode>& TranslationUnit::get_nodes(){
     return this->declarations;
 }
 void TranslationUnit::accept(Visitor& visitor) {
@@ -0,0 +1,721 @@
+#include "ast_cache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <unistd.h>
+
+#include "source_buffer.hpp"
+#include "visitor.hpp"
+
+namespace {
+
+// AST_BUILD_ID — хеш исходников интерпретатора, его передаёт makefile; при любом изменении
+// разбора у пересобранного интерпретатора другой ключ, и старые записи перестают находиться
+#ifndef AST_BUILD_ID
+#error "AST_BUILD_ID is not defined: build with the makefile"
+#endif
+
+// меняется вместе с форматом файла
+constexpr std::uint32_t format_version = 2;
+constexpr std::string_view interpreter_version = "cpp-interpreter ast " AST_BUILD_ID;
+constexpr char magic[8] = {'C', 'P', 'P', 'A', 'S', 'T', '\0', '\0'};
+
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t name_count;
+    std::uint64_t source_hash;
+    std::uint64_t source_size;
+};
+
+// FNV-1a по 64 битам
+std::uint64_t hash_bytes(std::string_view text, std::uint64_t hash = 0xcbf29ce484222325ull) {
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+std::uint64_t cache_key(std::string_view source) {
+    return hash_bytes(interpreter_version, hash_bytes(source));
+}
+
+// метка узла в потоке; Null — отсутствующий необязательный ребёнок
+enum class Tag : std::uint8_t {
+    Null,
+    SimpleDeclarator,
+    PtrDeclarator,
+    VarDeclaration,
+    ParameterDeclaration,
+    FuncDeclaration,
+    StructDeclaration,
+    ArrayDeclaration,
+    NameSpaceDeclaration,
+    CompoundStatement,
+    DeclarationStatement,
+    ExpressionStatement,
+    ConditionalStatement,
+    WhileStatement,
+    ForStatement,
+    ReturnStatement,
+    BreakStatement,
+    ContinueStatement,
+    DoWhileStatement,
+    StaticAssertStatement,
+    BinaryOperation,
+    PrefixExpression,
+    PostfixIncrementExpression,
+    PostfixDecrementExpression,
+    FunctionCallExpression,
+    SubscriptExpression,
+    IntLiteral,
+    FloatLiteral,
+    CharLiteral,
+    StringLiteral,
+    BoolLiteral,
+    NullPtrLiteral,
+    IdentifierExpression,
+    ParenthesizedExpression,
+    TernaryExpression,
+    SizeOfExpression,
+    StructMemberAccessExpression,
+    NameSpaceAcceptExpression
+};
+
+
+// Запись: узлы в прямом порядке обхода, имена — номерами в таблице файла.
+class Writer : public Visitor {
+public:
+    std::string bytes;
+    std::vector<Name> names;
+
+    template<typename T>
+    void put(T value) {
+        bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void put_tag(Tag tag) { put(static_cast<std::uint8_t>(tag)); }
+
+    void put_name(Name name) {
+        auto [it, inserted] = indices.try_emplace(name, static_cast<std::uint32_t>(names.size()));
+        if (inserted) {
+            names.push_back(name);
+        }
+        put(it->second);
+    }
+
+    void put_string(std::string_view text) {
+        put(static_cast<std::uint32_t>(text.size()));
+        bytes.append(text);
+    }
+
+    template<typename T>
+    void put_node(T* node) {
+        if (node) {
+            node->accept(*this);
+        } else {
+            put_tag(Tag::Null);
+        }
+    }
+
+    template<typename T>
+    void put_list(std::span<T*> nodes) {
+        put(static_cast<std::uint32_t>(nodes.size()));
+        for (auto* node : nodes) {
+            put_node(node);
+        }
+    }
+
+    void visit(ASTNode&) override {
+        throw std::runtime_error("AstCache: unknown node");
+    }
+
+    void visit(TranslationUnit& node) override {
+        put_list(node.declarations);
+    }
+
+    void visit(Declaration::SimpleDeclarator& node) override {
+        put_tag(Tag::SimpleDeclarator);
+        put_name(node.name);
+    }
+
+    void visit(Declaration::PtrDeclarator& node) override {
+        put_tag(Tag::PtrDeclarator);
+        put_node(node.inner);
+    }
+
+    void visit(Declaration::InitDeclarator& node) override {
+        put_node(node.declarator);
+        put_node(node.initializer);
+    }
+
+    void visit(VarDeclaration& node) override {
+        put_tag(Tag::VarDeclaration);
+        put<std::uint8_t>(node.is_const);
+        put_name(node.type);
+        put(static_cast<std::uint32_t>(node.declarator_list.size()));
+        for (auto* init : node.declarator_list) {
+            visit(*init);
+        }
+    }
+
+    void visit(ParameterDeclaration& node) override {
+        put_tag(Tag::ParameterDeclaration);
+        put_name(node.type);
+        visit(*node.init_declarator);
+    }
+
+    void visit(FuncDeclaration& node) override {
+        // лексемы отложенного тела ссылаются на текст файла — такое дерево не сохраняется
+        if (!node.deferred_body.empty()) {
+            throw std::runtime_error("AstCache: function body is not parsed");
+        }
+        put_tag(Tag::FuncDeclaration);
+        put<std::uint8_t>(node.is_const);
+        put_name(node.type);
+        put_node(node.declarator);
+        put<std::uint8_t>(node.is_readonly);
+        put<std::uint8_t>(node.is_constexpr);
+        put_list(node.args);
+        put_node(node.body);
+    }
+
+    void visit(StructDeclaration& node) override {
+        put_tag(Tag::StructDeclaration);
+        put_name(node.name);
+        put_list(node.members);
+    }
+
+    void visit(ArrayDeclaration& node) override {
+        put_tag(Tag::ArrayDeclaration);
+        put_name(node.type);
+        put_name(node.name);
+        put_node(node.size);
+        put_list(node.initializer_list);
+    }
+
+    void visit(NameSpaceDeclaration& node) override {
+        put_tag(Tag::NameSpaceDeclaration);
+        put_name(node.name);
+        put_list(node.declarations);
+    }
+
+    void visit(CompoundStatement& node) override {
+        put_tag(Tag::CompoundStatement);
+        put_list(node.statements);
+    }
+
+    void visit(DeclarationStatement& node) override {
+        put_tag(Tag::DeclarationStatement);
+        put_node(node.declaration);
+    }
+
+    void visit(ExpressionStatement& node) override {
+        put_tag(Tag::ExpressionStatement);
+        put_node(node.expression);
+    }
+
+    void visit(ConditionalStatement& node) override {
+        put_tag(Tag::ConditionalStatement);
+        put_node(node.if_branch.first);
+        put_node(node.if_branch.second);
+        put_node(node.else_branch);
+    }
+
+    void visit(WhileStatement& node) override {
+        put_tag(Tag::WhileStatement);
+        put_node(node.condition);
+        put_node(node.statement);
+    }
+
+    void visit(ForStatement& node) override {
+        put_tag(Tag::ForStatement);
+        put_node(node.initialization);
+        put_node(node.condition);
+        put_node(node.increment);
+        put_node(node.body);
+    }
+
+    void visit(ReturnStatement& node) override {
+        put_tag(Tag::ReturnStatement);
+        put_node(node.expression);
+    }
+
+    void visit(BreakStatement&) override { put_tag(Tag::BreakStatement); }
+    void visit(ContinueStatement&) override { put_tag(Tag::ContinueStatement); }
+
+    void visit(DoWhileStatement& node) override {
+        put_tag(Tag::DoWhileStatement);
+        put_node(node.statement);
+        put_node(node.condition);
+    }
+
+    void visit(StaticAssertStatement& node) override {
+        put_tag(Tag::StaticAssertStatement);
+        put_node(node.condition);
+        put_string(node.msg);
+    }
+
+    void visit(BinaryOperation& node) override {
+        put_tag(Tag::BinaryOperation);
+        put(node.op);
+        put_node(node.lhs);
+        put_node(node.rhs);
+    }
+
+    void visit(PrefixExpression& node) override {
+        put_tag(Tag::PrefixExpression);
+        put(node.op);
+        put_node(node.base);
+    }
+
+    void visit(PostfixIncrementExpression& node) override {
+        put_tag(Tag::PostfixIncrementExpression);
+        put_node(node.base);
+    }
+
+    void visit(PostfixDecrementExpression& node) override {
+        put_tag(Tag::PostfixDecrementExpression);
+        put_node(node.base);
+    }
+
+    void visit(FunctionCallExpression& node) override {
+        put_tag(Tag::FunctionCallExpression);
+        put_node(node.base);
+        put_list(node.args);
+    }
+
+    void visit(SubscriptExpression& node) override {
+        put_tag(Tag::SubscriptExpression);
+        put_node(node.base);
+        put_node(node.index);
+    }
+
+    void visit(IntLiteral& node) override {
+        put_tag(Tag::IntLiteral);
+        put(node.value);
+    }
+
+    void visit(FloatLiteral& node) override {
+        put_tag(Tag::FloatLiteral);
+        put(node.value);
+    }
+
+    void visit(CharLiteral& node) override {
+        put_tag(Tag::CharLiteral);
+        put(node.value);
+    }
+
+    void visit(StringLiteral& node) override {
+        put_tag(Tag::StringLiteral);
+        put_string(node.value);
+    }
+
+    void visit(BoolLiteral& node) override {
+        put_tag(Tag::BoolLiteral);
+        put<std::uint8_t>(node.value);
+    }
+
+    void visit(NullPtrLiteral&) override { put_tag(Tag::NullPtrLiteral); }
+
+    void visit(IdentifierExpression& node) override {
+        put_tag(Tag::IdentifierExpression);
+        put_name(node.name);
+    }
+
+    void visit(ParenthesizedExpression& node) override {
+        put_tag(Tag::ParenthesizedExpression);
+        put_node(node.expression);
+    }
+
+    void visit(TernaryExpression& node) override {
+        put_tag(Tag::TernaryExpression);
+        put_node(node.condition);
+        put_node(node.true_expr);
+        put_node(node.false_expr);
+    }
+
+    void visit(SizeOfExpression& node) override {
+        put_tag(Tag::SizeOfExpression);
+        put<std::uint8_t>(node.is_type);
+        put_name(node.type_name);
+        put_node(node.expression);
+    }
+
+    void visit(StructMemberAccessExpression& node) override {
+        put_tag(Tag::StructMemberAccessExpression);
+        put_node(node.base);
+        put_name(node.member);
+    }
+
+    void visit(NameSpaceAcceptExpression& node) override {
+        put_tag(Tag::NameSpaceAcceptExpression);
+        put_node(node.base);
+        put_name(node.name);
+    }
+
+private:
+    std::unordered_map<Name, std::uint32_t> indices;
+};
+
+
+// Чтение: каждый узел создаётся в арене сразу после своих детей.
+// Любой выход за границы или неожиданная метка — std::runtime_error, load() считает это промахом.
+class Reader {
+public:
+    Reader(std::string_view bytes, Arena& arena) : p(bytes.data()), end(bytes.data() + bytes.size()), arena(arena) {}
+
+    std::vector<Name> names;
+
+    template<typename T>
+    T get() {
+        if (static_cast<std::size_t>(end - p) < sizeof(T)) {
+            throw std::runtime_error("AstCache: truncated entry");
+        }
+        T value;
+        std::memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return value;
+    }
+
+    std::string get_string() {
+        auto size = get<std::uint32_t>();
+        if (static_cast<std::size_t>(end - p) < size) {
+            throw std::runtime_error("AstCache: truncated entry");
+        }
+        std::string text(p, size);
+        p += size;
+        return text;
+    }
+
+    Name get_name() {
+        auto index = get<std::uint32_t>();
+        if (index >= names.size()) {
+            throw std::runtime_error("AstCache: bad name index");
+        }
+        return names[index];
+    }
+
+    bool at_end() const { return p == end; }
+
+    // узел ожидаемого вида или nullptr на месте Null
+    template<typename T>
+    T* get_node() {
+        auto tag = static_cast<Tag>(get<std::uint8_t>());
+        if (tag == Tag::Null) {
+            return nullptr;
+        }
+        if (tag == Tag::SimpleDeclarator || tag == Tag::PtrDeclarator) {
+            if constexpr (std::is_same_v<T, Declaration::Declarator>) {
+                return get_declarator(tag);
+            }
+            throw std::runtime_error("AstCache: unexpected declarator");
+        }
+        if constexpr (std::is_same_v<T, Declaration::Declarator>) {
+            throw std::runtime_error("AstCache: declarator expected");
+        } else {
+            auto typed = dynamic_cast<T*>(make_node(tag));
+            if (!typed) {
+                throw std::runtime_error("AstCache: unexpected node kind");
+            }
+            return typed;
+        }
+    }
+
+    template<typename T>
+    T* get_required() {
+        T* node = get_node<T>();
+        if (!node) {
+            throw std::runtime_error("AstCache: missing node");
+        }
+        return node;
+    }
+
+    template<typename T>
+    node_list<T> get_list() {
+        auto count = get<std::uint32_t>();
+        std::vector<T*> nodes;
+        nodes.reserve(std::min<std::size_t>(count, end - p));
+        for (std::uint32_t i = 0; i < count; ++i) {
+            nodes.push_back(get_node<T>());
+        }
+        return arena.copy(nodes);
+    }
+
+private:
+    Declaration::Declarator* get_declarator(Tag tag) {
+        if (tag == Tag::SimpleDeclarator) {
+            return arena.make<Declaration::SimpleDeclarator>(get_name());
+        }
+        return arena.make<Declaration::PtrDeclarator>(get_required<Declaration::Declarator>());
+    }
+
+    Declaration::InitDeclarator* get_init_declarator() {
+        auto declarator = get_required<Declaration::Declarator>();
+        auto initializer = get_node<Expression>();
+        return arena.make<Declaration::InitDeclarator>(declarator, initializer);
+    }
+
+    ASTNode* make_node(Tag tag) {
+        switch (tag) {
+            case Tag::VarDeclaration: {
+                bool is_const = get<std::uint8_t>();
+                Name type = get_name();
+                auto count = get<std::uint32_t>();
+                std::vector<Declaration::InitDeclarator*> list;
+                for (std::uint32_t i = 0; i < count; ++i) {
+                    list.push_back(get_init_declarator());
+                }
+                return arena.make<VarDeclaration>(is_const, type, arena.copy(list));
+            }
+            case Tag::ParameterDeclaration: {
+                Name type = get_name();
+                return arena.make<ParameterDeclaration>(type, get_init_declarator());
+            }
+            case Tag::FuncDeclaration: {
+                bool is_const = get<std::uint8_t>();
+                Name type = get_name();
+                auto declarator = get_required<Declaration::Declarator>();
+                bool is_readonly = get<std::uint8_t>();
+                bool is_constexpr = get<std::uint8_t>();
+                auto args = get_list<ParameterDeclaration>();
+                auto body = get_node<CompoundStatement>();
+                auto function = arena.make<FuncDeclaration>(is_const, type, declarator, is_readonly, args, body);
+                function->is_constexpr = is_constexpr;
+                return function;
+            }
+            case Tag::StructDeclaration: {
+                Name name = get_name();
+                return arena.make<StructDeclaration>(name, get_list<Declaration>());
+            }
+            case Tag::ArrayDeclaration: {
+                Name type = get_name();
+                Name name = get_name();
+                auto size = get_node<Expression>();
+                return arena.make<ArrayDeclaration>(type, name, size, get_list<Expression>());
+            }
+            case Tag::NameSpaceDeclaration: {
+                Name name = get_name();
+                return arena.make<NameSpaceDeclaration>(name, get_list<Declaration>());
+            }
+
+            case Tag::CompoundStatement:
+                return arena.make<CompoundStatement>(get_list<Statement>());
+            case Tag::DeclarationStatement:
+                return arena.make<DeclarationStatement>(get_required<Declaration>());
+            case Tag::ExpressionStatement:
+                return arena.make<ExpressionStatement>(get_node<Expression>());
+            case Tag::ConditionalStatement: {
+                auto condition = get_required<Expression>();
+                auto then_branch = get_required<Statement>();
+                auto else_branch = get_node<Statement>();
+                return arena.make<ConditionalStatement>(std::make_pair(condition, then_branch), else_branch);
+            }
+            case Tag::WhileStatement: {
+                auto condition = get_required<Expression>();
+                return arena.make<WhileStatement>(condition, get_required<Statement>());
+            }
+            case Tag::ForStatement: {
+                auto initialization = get_node<ASTNode>();
+                auto condition = get_node<Expression>();
+                auto increment = get_node<Expression>();
+                return arena.make<ForStatement>(initialization, condition, increment, get_required<Statement>());
+            }
+            case Tag::ReturnStatement:
+                return arena.make<ReturnStatement>(get_node<Expression>());
+            case Tag::BreakStatement:
+                return arena.make<BreakStatement>();
+            case Tag::ContinueStatement:
+                return arena.make<ContinueStatement>();
+            case Tag::DoWhileStatement: {
+                auto body = get_required<Statement>();
+                return arena.make<DoWhileStatement>(body, get_required<Expression>());
+            }
+            case Tag::StaticAssertStatement: {
+                auto condition = get_required<Expression>();
+                return arena.make<StaticAssertStatement>(condition, arena.copy(get_string()));
+            }
+
+            case Tag::BinaryOperation: {
+                auto op = get<Operator>();
+                auto lhs = get_required<Expression>();
+                return arena.make<BinaryOperation>(op, lhs, get_required<Expression>());
+            }
+            case Tag::PrefixExpression: {
+                auto op = get<Operator>();
+                return arena.make<PrefixExpression>(op, get_required<Expression>());
+            }
+            case Tag::PostfixIncrementExpression:
+                return arena.make<PostfixIncrementExpression>(get_required<Expression>());
+            case Tag::PostfixDecrementExpression:
+                return arena.make<PostfixDecrementExpression>(get_required<Expression>());
+            case Tag::FunctionCallExpression: {
+                auto base = get_required<Expression>();
+                return arena.make<FunctionCallExpression>(base, get_list<Expression>());
+            }
+            case Tag::SubscriptExpression: {
+                auto base = get_required<Expression>();
+                return arena.make<SubscriptExpression>(base, get_required<Expression>());
+            }
+            case Tag::IntLiteral:
+                return arena.make<IntLiteral>(get<int>());
+            case Tag::FloatLiteral:
+                return arena.make<FloatLiteral>(get<double>());
+            case Tag::CharLiteral:
+                return arena.make<CharLiteral>(get<char>());
+            case Tag::StringLiteral:
+                return arena.make<StringLiteral>(arena.copy(get_string()));
+            case Tag::BoolLiteral:
+                return arena.make<BoolLiteral>(static_cast<bool>(get<std::uint8_t>()));
+            case Tag::NullPtrLiteral:
+                return arena.make<NullPtrLiteral>();
+            case Tag::IdentifierExpression:
+                return arena.make<IdentifierExpression>(get_name());
+            case Tag::ParenthesizedExpression:
+                return arena.make<ParenthesizedExpression>(get_required<Expression>());
+            case Tag::TernaryExpression: {
+                auto condition = get_required<Expression>();
+                auto true_expr = get_required<Expression>();
+                return arena.make<TernaryExpression>(condition, true_expr, get_required<Expression>());
+            }
+            case Tag::SizeOfExpression: {
+                bool is_type = get<std::uint8_t>();
+                Name type_name = get_name();
+                auto expression = get_node<Expression>();
+                return is_type ? arena.make<SizeOfExpression>(type_name)
+                               : arena.make<SizeOfExpression>(expression);
+            }
+            case Tag::StructMemberAccessExpression: {
+                auto base = get_required<Expression>();
+                return arena.make<StructMemberAccessExpression>(base, get_name());
+            }
+            case Tag::NameSpaceAcceptExpression: {
+                auto base = get_required<Expression>();
+                return arena.make<NameSpaceAcceptExpression>(base, get_name());
+            }
+
+            default:
+                throw std::runtime_error("AstCache: bad node tag");
+        }
+    }
+
+    const char* p;
+    const char* end;
+    Arena& arena;
+};
+
+}
+
+
+std::filesystem::path AstCache::default_directory() {
+    if (const char* dir = std::getenv("CPP_INTERPRETER_CACHE"); dir && *dir) {
+        return dir;
+    }
+    if (const char* dir = std::getenv("XDG_CACHE_HOME"); dir && *dir) {
+        return std::filesystem::path(dir) / "cpp-interpreter";
+    }
+    if (const char* home = std::getenv("HOME"); home && *home) {
+        return std::filesystem::path(home) / ".cache" / "cpp-interpreter";
+    }
+    return {};
+}
+
+AstCache::AstCache(std::filesystem::path directory) : directory(std::move(directory)) {}
+
+std::filesystem::path AstCache::entry(std::uint64_t key) const {
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx.ast", static_cast<unsigned long long>(key));
+    return directory / name;
+}
+
+std::unique_ptr<TranslationUnit> AstCache::load(std::string_view source) const {
+    if (directory.empty()) {
+        return nullptr;
+    }
+    SourceBuffer file(entry(cache_key(source)).string());
+    std::string_view bytes = file.text();
+    if (!file.is_open() || bytes.size() < sizeof(Header)) {
+        return nullptr;
+    }
+
+    Header header;
+    std::memcpy(&header, bytes.data(), sizeof(Header));
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != format_version ||
+        header.source_hash != hash_bytes(source) || header.source_size != source.size()) {
+        return nullptr;
+    }
+
+    try {
+        auto arena = std::make_unique<Arena>();
+        Reader reader(bytes.substr(sizeof(Header)), *arena);
+        reader.names.reserve(header.name_count);
+        for (std::uint32_t i = 0; i < header.name_count; ++i) {
+            reader.names.push_back(Name(reader.get_string()));
+        }
+        auto declarations = reader.get_list<ASTNode>();
+        if (!reader.at_end()) {
+            return nullptr;
+        }
+        return std::make_unique<TranslationUnit>(declarations, std::move(arena));
+    } catch (const std::runtime_error&) {
+        return nullptr;
+    }
+}
+
+void AstCache::store(std::string_view source, TranslationUnit& unit) const {
+    if (directory.empty()) {
+        return;
+    }
+    Writer writer;
+    try {
+        unit.accept(writer);
+    } catch (const std::runtime_error&) {
+        return;
+    }
+
+    Header header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = format_version;
+    header.name_count = static_cast<std::uint32_t>(writer.names.size());
+    header.source_hash = hash_bytes(source);
+    header.source_size = source.size();
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        return;
+    }
+
+    // запись во временный файл и переименование: другой процесс не увидит половину записи
+    auto path = entry(cache_key(source));
+    auto temporary = path;
+    temporary += "." + std::to_string(::getpid()) + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const Name& name : writer.names) {
+            const std::string& text = name.str();
+            auto size = static_cast<std::uint32_t>(text.size());
+            out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+            out.write(text.data(), text.size());
+        }
+        out.write(writer.bytes.data(), writer.bytes.size());
+        if (!out) {
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+    }
+}
@@ -0,0 +1,1271 @@
+#include "compiler.hpp"
+#include <stdexcept>
+
+namespace {
+
+const std::unordered_map<Name, std::shared_ptr<Type>> builtin_types = {
+    {"int",    TypeContext::global().int_type()},
+    {"float",  TypeContext::global().float_type()},
+    {"char",   TypeContext::global().char_type()},
+    {"bool",   TypeContext::global().bool_type()},
+    {"void",   TypeContext::global().void_type()}
+};
+
+OpCode binary_opcode(Operator op) {
+    switch (op) {
+        case Operator::Add:          return OpCode::Add;
+        case Operator::Sub:          return OpCode::Sub;
+        case Operator::Mul:          return OpCode::Mul;
+        case Operator::Div:          return OpCode::Div;
+        case Operator::Mod:          return OpCode::Mod;
+        case Operator::ShiftLeft:    return OpCode::ShiftLeft;
+        case Operator::ShiftRight:   return OpCode::ShiftRight;
+        case Operator::BitAnd:       return OpCode::BitAnd;
+        case Operator::BitOr:        return OpCode::BitOr;
+        case Operator::BitXor:       return OpCode::BitXor;
+        case Operator::Equal:        return OpCode::Equal;
+        case Operator::NotEqual:     return OpCode::NotEqual;
+        case Operator::Less:         return OpCode::Less;
+        case Operator::LessEqual:    return OpCode::LessEqual;
+        case Operator::Greater:      return OpCode::Greater;
+        case Operator::GreaterEqual: return OpCode::GreaterEqual;
+        default:
+            throw std::runtime_error("unsupported binary operator: " + spelling(op));
+    }
+}
+
+std::shared_ptr<Type> strip_const(const std::shared_ptr<Type>& type) {
+    if (auto cp = type_pointer_cast<ConstType>(type)) {
+        return cp->get_base();
+    }
+    return type;
+}
+
+// тип результата арифметики: float, если есть float-операнд, иначе int
+std::shared_ptr<Type> arithmetic_result(const std::shared_ptr<Type>& lhs, const std::shared_ptr<Type>& rhs) {
+    ValueKind l = kind_of(lhs), r = kind_of(rhs);
+    if (l == ValueKind::Pointer) return strip_const(lhs);
+    if (l == ValueKind::Void || l == ValueKind::Struct || l == ValueKind::String ||
+        r == ValueKind::Void || r == ValueKind::Struct || r == ValueKind::String) {
+        return nullptr;
+    }
+    if (l == ValueKind::Float || r == ValueKind::Float) return builtin_types.at("float");
+    return builtin_types.at("int");
+}
+
+// тип элемента, на который указывает указатель или массив
+std::shared_ptr<Type> pointee_type(const std::shared_ptr<Type>& type) {
+    auto t = strip_const(type);
+    if (auto pt = type_pointer_cast<PointerType>(t)) return pt->get_base();
+    if (auto at = type_pointer_cast<ArrayType>(t))   return at->get_base_type();
+    return nullptr;
+}
+
+// имена переменных, адрес которых где-либо берётся: такие переменные живут вне регистров
+void collect_address_taken(ASTNode* node, std::unordered_set<Name>& names) {
+    if (!node) return;
+
+    if (auto unit = node_cast<TranslationUnit>(node)) {
+        for (auto& n : unit->get_nodes()) collect_address_taken(n, names);
+    }
+    else if (auto var = node_cast<VarDeclaration>(node)) {
+        for (auto& d : var->declarator_list) collect_address_taken(d->initializer, names);
+    }
+    else if (auto func = node_cast<FuncDeclaration>(node)) {
+        collect_address_taken(func->body, names);
+    }
+    else if (auto st = node_cast<StructDeclaration>(node)) {
+        for (auto& m : st->members) collect_address_taken(m, names);
+    }
+    else if (auto arr = node_cast<ArrayDeclaration>(node)) {
+        collect_address_taken(arr->size, names);
+        for (auto& e : arr->initializer_list) collect_address_taken(e, names);
+    }
+    else if (auto ns = node_cast<NameSpaceDeclaration>(node)) {
+        for (auto& d : ns->declarations) collect_address_taken(d, names);
+    }
+    else if (auto block = node_cast<CompoundStatement>(node)) {
+        for (auto& s : block->statements) collect_address_taken(s, names);
+    }
+    else if (auto decl = node_cast<DeclarationStatement>(node)) {
+        collect_address_taken(decl->declaration, names);
+    }
+    else if (auto expr = node_cast<ExpressionStatement>(node)) {
+        collect_address_taken(expr->expression, names);
+    }
+    else if (auto cond = node_cast<ConditionalStatement>(node)) {
+        collect_address_taken(cond->if_branch.first, names);
+        collect_address_taken(cond->if_branch.second, names);
+        collect_address_taken(cond->else_branch, names);
+    }
+    else if (auto loop = node_cast<WhileStatement>(node)) {
+        collect_address_taken(loop->condition, names);
+        collect_address_taken(loop->statement, names);
+    }
+    else if (auto loop = node_cast<ForStatement>(node)) {
+        collect_address_taken(loop->initialization, names);
+        collect_address_taken(loop->condition, names);
+        collect_address_taken(loop->increment, names);
+        collect_address_taken(loop->body, names);
+    }
+    else if (auto loop = node_cast<DoWhileStatement>(node)) {
+        collect_address_taken(loop->statement, names);
+        collect_address_taken(loop->condition, names);
+    }
+    else if (auto ret = node_cast<ReturnStatement>(node)) {
+        collect_address_taken(ret->expression, names);
+    }
+    else if (auto bin = node_cast<BinaryOperation>(node)) {
+        collect_address_taken(bin->lhs, names);
+        collect_address_taken(bin->rhs, names);
+    }
+    else if (auto pre = node_cast<PrefixExpression>(node)) {
+        if (pre->op == Operator::AddressOf) {
+            if (auto id = node_cast<IdentifierExpression>(pre->base)) {
+                names.insert(id->name);
+            }
+            else if (auto ns = node_cast<NameSpaceAcceptExpression>(pre->base)) {
+                names.insert(ns->name);
+            }
+        }
+        collect_address_taken(pre->base, names);
+    }
+    else if (auto inc = node_cast<PostfixIncrementExpression>(node)) {
+        collect_address_taken(inc->base, names);
+    }
+    else if (auto dec = node_cast<PostfixDecrementExpression>(node)) {
+        collect_address_taken(dec->base, names);
+    }
+    else if (auto call = node_cast<FunctionCallExpression>(node)) {
+        collect_address_taken(call->base, names);
+        for (auto& a : call->args) collect_address_taken(a, names);
+    }
+    else if (auto sub = node_cast<SubscriptExpression>(node)) {
+        collect_address_taken(sub->base, names);
+        collect_address_taken(sub->index, names);
+    }
+    else if (auto paren = node_cast<ParenthesizedExpression>(node)) {
+        collect_address_taken(paren->expression, names);
+    }
+    else if (auto member = node_cast<StructMemberAccessExpression>(node)) {
+        collect_address_taken(member->base, names);
+    }
+    else if (auto tern = node_cast<TernaryExpression>(node)) {
+        collect_address_taken(tern->condition, names);
+        collect_address_taken(tern->true_expr, names);
+        collect_address_taken(tern->false_expr, names);
+    }
+    else if (auto size = node_cast<SizeOfExpression>(node)) {
+        collect_address_taken(size->expression, names);
+    }
+    else if (auto ns = node_cast<NameSpaceAcceptExpression>(node)) {
+        collect_address_taken(ns->base, names);
+    }
+}
+
+// полное имя из цепочки a::b::c
+Name scoped_name(Expression& node) {
+    if (auto id = node_cast<IdentifierExpression>(&node)) {
+        return id->name;
+    }
+    if (auto ns = node_cast<NameSpaceAcceptExpression>(&node)) {
+        return scoped_name(*ns->base) + "::" + ns->name;
+    }
+    throw std::runtime_error("invalid qualified name");
+}
+
+}
+
+
+Compiler::Compiler() { }
+
+
+Program Compiler::compile(TranslationUnit& unit) {
+    program = Program{};
+    functions.clear();
+    structs.clear();
+    address_taken.clear();
+    collect_address_taken(&unit, address_taken);
+
+    // точка входа: глобальные объявления, затем вызов main
+    root = FunctionState{};
+    root.index = 0;
+    program.functions.push_back(Function{"<entry>"});
+    program.entry = 0;
+    state = &root;
+
+    unit.accept(*this);
+
+    auto mainFunc = find_function(known::main);
+    if (!mainFunc) {
+        throw std::runtime_error("No 'main' function found");
+    }
+    if (!type_cast<IntegerType>(strip_const(mainFunc->returns).get())) {
+        throw std::runtime_error("'main' must return int");
+    }
+    if (!mainFunc->params.empty()) {
+        throw std::runtime_error("'main' should not take parameters");
+    }
+    int base = temp();
+    emit(OpCode::Call, base, mainFunc->index, 0);
+    emit(OpCode::Return, base);
+
+    state = nullptr;
+    return std::move(program);
+}
+
+
+Function& Compiler::current() {
+    return program.functions[state->index];
+}
+
+int Compiler::emit(OpCode op, int a, int b, int c) {
+    auto& code = current().code;
+    code.push_back(Instruction{op, a, b, c});
+    return static_cast<int>(code.size()) - 1;
+}
+
+int Compiler::here() {
+    return static_cast<int>(current().code.size());
+}
+
+void Compiler::patch(int at, int target) {
+    auto& in = current().code[at];
+    if (in.op == OpCode::Jump) {
+        in.a = target;
+    } else {
+        in.b = target;
+    }
+}
+
+int Compiler::temp() {
+    int reg = state->next_reg++;
+    auto& fn = current();
+    fn.num_registers = std::max(fn.num_registers, state->next_reg);
+    return reg;
+}
+
+// временные регистры живут до конца оператора
+void Compiler::release() {
+    state->next_reg = state->locals_top;
+}
+
+int Compiler::constant(const Value& v) {
+    program.constants.push_back(v);
+    return static_cast<int>(program.constants.size()) - 1;
+}
+
+int Compiler::name_index(Name name) {
+    for (size_t i = 0; i < program.names.size(); ++i) {
+        if (program.names[i] == name) return static_cast<int>(i);
+    }
+    program.names.push_back(name);
+    return static_cast<int>(program.names.size()) - 1;
+}
+
+void Compiler::declare(Name name, int reg, const std::shared_ptr<Type>& type, bool boxed, bool array) {
+    state->locals.push_back(Local{name, reg, type, boxed, array});
+    state->locals_top = reg + 1;
+    state->next_reg = state->locals_top;
+}
+
+int Compiler::box_slot(const std::shared_ptr<Type>& type, const Value& init) {
+    program.boxes.push_back(BoxInfo{type, init});
+    return static_cast<int>(program.boxes.size()) - 1;
+}
+
+const Compiler::Local* Compiler::find_local(const FunctionState& scope, Name name) const {
+    for (auto it = scope.locals.rbegin(); it != scope.locals.rend(); ++it) {
+        if (it->name == name) return &*it;
+    }
+    return nullptr;
+}
+
+Name Compiler::qualified(Name name) const {
+    return ns_prefix.empty() ? name : Name(ns_prefix + name);
+}
+
+const Compiler::FunctionInfo* Compiler::find_function(Name name) const {
+    auto it = functions.find(qualified(name));
+    if (it == functions.end()) it = functions.find(name);
+    return it == functions.end() ? nullptr : &it->second;
+}
+
+Compiler::StructInfo* Compiler::find_struct(const std::shared_ptr<Type>& type) {
+    auto st = type_pointer_cast<StructType>(strip_const(type));
+    if (!st) return nullptr;
+    for (auto& kv : structs) {
+        if (kv.second.type == st) return &kv.second;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<Type> Compiler::resolve_type(Name name, Declaration::Declarator* declarator) {
+    std::shared_ptr<Type> type;
+    auto bt = builtin_types.find(name);
+    if (bt != builtin_types.end()) {
+        type = bt->second;
+    } else {
+        auto st = structs.find(qualified(name));
+        if (st == structs.end()) st = structs.find(name);
+        if (st == structs.end()) {
+            throw std::runtime_error("Symbol or type '" + name + "' not found");
+        }
+        type = st->second.type;
+    }
+
+    // каждый PtrDeclarator добавляет уровень указателя
+    auto d = declarator;
+    while (auto ptr = node_cast<Declaration::PtrDeclarator>(d)) {
+        type = TypeContext::global().pointer_to(type);
+        d = ptr->inner;
+    }
+    return type;
+}
+
+
+int Compiler::compile_expr(Expression& node, int want) {
+    int saved = target;
+    target = want;
+    result_reg = -1;
+    result_type = nullptr;
+    node.accept(*this);
+    target = saved;
+    if (result_reg < 0) {
+        throw std::runtime_error("expression has no value");
+    }
+    return result_reg;
+}
+
+Compiler::LValue Compiler::compile_lvalue(Expression& node) {
+    if (auto id = node_cast<IdentifierExpression>(&node)) {
+        return variable(id->name, false);
+    }
+    if (node_cast<NameSpaceAcceptExpression>(&node)) {
+        return variable(scoped_name(node), true);
+    }
+    if (auto paren = node_cast<ParenthesizedExpression>(&node)) {
+        return compile_lvalue(*paren->expression);
+    }
+    if (auto member = node_cast<StructMemberAccessExpression>(&node)) {
+        std::shared_ptr<Type> type;
+        int addr = field_address(*member->base, member->member, type);
+        return LValue{LValue::Pointer, addr, type};
+    }
+    if (auto sub = node_cast<SubscriptExpression>(&node)) {
+        int base = compile_expr(*sub->base);
+        auto elem = pointee_type(result_type);
+        int index = compile_expr(*sub->index);
+        int addr = temp();
+        emit(OpCode::Add, addr, base, index);
+        return LValue{LValue::Pointer, addr, elem};
+    }
+    if (auto pre = node_cast<PrefixExpression>(&node)) {
+        if (pre->op == Operator::Dereference) {
+            int addr = compile_expr(*pre->base);
+            return LValue{LValue::Pointer, addr, pointee_type(result_type)};
+        }
+    }
+    throw std::runtime_error("expression is not assignable");
+}
+
+// локальная переменная, поле текущей структуры или глобальная переменная
+Compiler::LValue Compiler::variable(Name name, bool scoped) {
+    if (!scoped && state != &root) {
+        if (auto local = find_local(*state, name)) {
+            if (local->array) {
+                return LValue{LValue::Register, local->reg, TypeContext::global().pointer_to(pointee_type(local->type))};
+            }
+            return LValue{local->boxed ? LValue::Pointer : LValue::Register, local->reg, local->type};
+        }
+        if (current_struct) {
+            if (const auto& field_type = current_struct->type->find_member(name)) {
+                int addr = temp();
+                emit(OpCode::Field, addr, 0, name_index(name));
+                return LValue{LValue::Pointer, addr, field_type};
+            }
+        }
+    }
+
+    const Local* global = scoped ? find_local(root, name) : nullptr;
+    if (!global) global = find_local(root, qualified(name));
+    if (!global) global = find_local(root, name);
+    if (!global) {
+        throw std::runtime_error("Undefined variable: " + name);
+    }
+
+    auto type = global->array
+              ? TypeContext::global().pointer_to(pointee_type(global->type))
+              : global->type;
+    if (state == &root) {
+        return LValue{global->boxed ? LValue::Pointer : LValue::Register, global->reg, type};
+    }
+    if (global->boxed || global->array) {
+        int reg = temp();
+        emit(OpCode::GetGlobal, reg, global->reg);
+        return LValue{global->boxed ? LValue::Pointer : LValue::Register, reg, type};
+    }
+    return LValue{LValue::Global, global->reg, type};
+}
+
+int Compiler::load(const LValue& lv, int want) {
+    switch (lv.kind) {
+        case LValue::Register:
+            if (want >= 0 && want != lv.index) {
+                emit(OpCode::Move, want, lv.index);
+                return want;
+            }
+            return lv.index;
+        case LValue::Global: {
+            int reg = want >= 0 ? want : temp();
+            emit(OpCode::GetGlobal, reg, lv.index);
+            return reg;
+        }
+        default: {
+            int reg = want >= 0 ? want : temp();
+            emit(OpCode::Load, reg, lv.index);
+            return reg;
+        }
+    }
+}
+
+// запись значения с преобразованием к типу переменной; возвращает регистр записанного значения
+int Compiler::store(const LValue& lv, int reg, const std::shared_ptr<Type>& from) {
+    // структуры копируются поле за полем
+    if (find_struct(lv.type)) {
+        int dst = load(lv);
+        emit(OpCode::CopyStruct, dst, reg);
+        return dst;
+    }
+    switch (lv.kind) {
+        case LValue::Register:
+            return convert(reg, from, lv.type, lv.index);
+        case LValue::Global: {
+            int value = convert(reg, from, lv.type, -1);
+            emit(OpCode::SetGlobal, lv.index, value);
+            return value;
+        }
+        default:
+            emit(OpCode::Store, lv.index, reg);
+            return reg;
+    }
+}
+
+int Compiler::convert(int reg, const std::shared_ptr<Type>& from, const std::shared_ptr<Type>& to, int want) {
+    ValueKind to_kind = kind_of(to);
+    bool arithmetic = to_kind == ValueKind::Int || to_kind == ValueKind::Float ||
+                      to_kind == ValueKind::Char || to_kind == ValueKind::Bool;
+    if (arithmetic && kind_of(from) != to_kind) {
+        int dst = want >= 0 ? want : temp();
+        emit(OpCode::Convert, dst, reg, static_cast<int>(to_kind));
+        return dst;
+    }
+    if (want >= 0 && want != reg) {
+        emit(OpCode::Move, want, reg);
+        return want;
+    }
+    return reg;
+}
+
+int Compiler::field_address(Expression& base, Name member, std::shared_ptr<Type>& type) {
+    int object = compile_expr(base);
+    auto info = find_struct(result_type);
+    if (!info) {
+        throw std::runtime_error("member access on non-struct value");
+    }
+    type = info->type->find_member(member);
+    if (!type) {
+        throw std::runtime_error("no such member: " + member);
+    }
+    int addr = temp();
+    emit(OpCode::Field, addr, object, name_index(member));
+    return addr;
+}
+
+
+void Compiler::push_block() {
+    state->blocks.push_back(state->locals.size());
+}
+
+void Compiler::pop_block() {
+    state->locals.resize(state->blocks.back());
+    state->blocks.pop_back();
+    state->locals_top = state->locals.empty() ? 0 : state->locals.back().reg + 1;
+    state->next_reg = state->locals_top;
+}
+
+
+void Compiler::visit(ASTNode&) {
+}
+
+void Compiler::visit(TranslationUnit& unit) {
+    for (auto& node : unit.get_nodes()) {
+        node->accept(*this);
+        release();
+    }
+}
+
+void Compiler::visit(Declaration::SimpleDeclarator&) {
+}
+
+void Compiler::visit(Declaration::PtrDeclarator&) {
+}
+
+void Compiler::visit(Declaration::InitDeclarator&) {
+}
+
+void Compiler::visit(VarDeclaration& node) {
+    for (auto& initDecl : node.declarator_list) {
+        release();
+        const auto& name = initDecl->declarator->name;
+        // глобальные переменные пространства имён получают полное имя
+        Name fullName = state == &root ? qualified(name) : name;
+        bool boxed = address_taken.count(name) > 0;
+        int reg = temp();
+
+        std::shared_ptr<Type> type;
+        std::shared_ptr<Type> from;
+        int init = -1;
+        if (node.type == known::auto_type) {
+            if (!initDecl->initializer) {
+                throw std::runtime_error("auto‐declaration requires an initializer");
+            }
+            init = compile_expr(*initDecl->initializer);
+            from = result_type;
+            type = strip_const(result_type);
+            if (!type) type = builtin_types.at("void");
+        } else {
+            type = resolve_type(node.type, initDecl->declarator);
+        }
+
+        if (auto info = find_struct(type)) {
+            // новый экземпляр: шаблон, инициализаторы полей, затем копия инициализатора
+            int slot = current().num_boxes++;
+            emit(OpCode::NewStruct, reg, slot, info->index);
+            for (auto& m : info->declaration->members) {
+                auto fld = node_cast<VarDeclaration>(m);
+                if (!fld) continue;
+                for (auto& f : fld->declarator_list) {
+                    if (!f->initializer) continue;
+                    int value = compile_expr(*f->initializer);
+                    int addr = temp();
+                    emit(OpCode::Field, addr, reg, name_index(f->declarator->name));
+                    emit(OpCode::Store, addr, value);
+                    state->next_reg = std::max(reg + 1, init + 1);
+                }
+            }
+            if (initDecl->initializer && init < 0) {
+                init = compile_expr(*initDecl->initializer);
+            }
+            if (init >= 0) {
+                emit(OpCode::CopyStruct, reg, init);
+            }
+            if (boxed) {
+                emit(OpCode::Address, reg, slot);
+            }
+        }
+        else if (boxed) {
+            if (initDecl->initializer && init < 0) {
+                init = compile_expr(*initDecl->initializer);
+            }
+            int slot = current().num_boxes++;
+            emit(OpCode::Box, reg, slot, box_slot(type, default_value(type)));
+            if (init >= 0) {
+                emit(OpCode::Store, reg, init);
+            }
+        }
+        else if (init >= 0) {
+            convert(init, from, type, reg);
+        }
+        else if (initDecl->initializer) {
+            compile_expr(*initDecl->initializer, reg);
+            convert(reg, result_type, type, reg);
+        }
+        else {
+            emit(OpCode::LoadConst, reg, constant(default_value(type)));
+        }
+
+        declare(fullName, reg, type, boxed, false);
+    }
+}
+
+void Compiler::visit(ParameterDeclaration&) {
+}
+
+void Compiler::compile_function(FuncDeclaration& node, const FunctionInfo& info, StructInfo* owner) {
+    FunctionState fs;
+    fs.index = info.index;
+    auto savedState = state;
+    auto savedStruct = current_struct;
+    state = &fs;
+    current_struct = owner;
+
+    // метод получает экземпляр в регистре 0
+    if (owner) {
+        declare(known::self, temp(), owner->type, false, false);
+    }
+    for (size_t i = 0; i < node.args.size(); ++i) {
+        const auto& pname = node.args[i]->init_declarator->declarator->name;
+        declare(pname, temp(), info.params[i], address_taken.count(pname) > 0, false);
+    }
+    current().num_params = static_cast<int>(fs.locals.size());
+
+    // пролог: приведение аргументов к типам параметров, вынос в память взятых по адресу
+    for (auto& param : fs.locals) {
+        if (param.name == known::self && owner) continue;
+        int value = convert(param.reg, nullptr, param.type, param.reg);
+        if (param.boxed) {
+            int saved = temp();
+            emit(OpCode::Move, saved, value);
+            int slot = current().num_boxes++;
+            emit(OpCode::Box, param.reg, slot, box_slot(param.type, default_value(param.type)));
+            emit(OpCode::Store, param.reg, saved);
+            release();
+        }
+    }
+
+    if (node.body) {
+        node.body->accept(*this);
+    }
+    emit(OpCode::Return, -1);
+
+    state = savedState;
+    current_struct = savedStruct;
+}
+
+void Compiler::visit(FuncDeclaration& node) {
+    Name name = qualified(node.declarator->name);
+    if (functions.count(name)) {
+        throw std::runtime_error("function already declared: " + name);
+    }
+
+    FunctionInfo info;
+    info.index = static_cast<int>(program.functions.size());
+    info.returns = node.type == known::auto_type ? nullptr : resolve_type(node.type, node.declarator);
+    for (auto& p : node.args) {
+        info.params.push_back(resolve_type(p->type, p->init_declarator->declarator));
+    }
+    program.functions.push_back(Function{name});
+    functions[name] = info;
+
+    compile_function(node, info, nullptr);
+}
+
+void Compiler::visit(StructDeclaration& node) {
+    Name name = qualified(node.name);
+    if (structs.count(name)) {
+        throw std::runtime_error("struct already declared: " + name);
+    }
+
+    std::unordered_map<Name, std::shared_ptr<Type>>     data_members;
+    std::unordered_map<Name, std::shared_ptr<FuncType>> methods;
+    std::unordered_map<Name, std::shared_ptr<Symbol>>   member_symbols;
+
+    // тип структуры нужен полям-указателям и методам, поэтому регистрируем её заранее
+    auto& info = structs[name];
+    info.name = name;
+    info.declaration = &node;
+    info.index = static_cast<int>(program.structs.size());
+    info.type = std::make_shared<StructType>(data_members, methods);
+
+    std::vector<std::pair<FuncDeclaration*, FunctionInfo>> bodies;
+    for (auto& m : node.members) {
+        if (auto fld = node_cast<VarDeclaration>(m)) {
+            for (auto& d : fld->declarator_list) {
+                auto type = resolve_type(fld->type, d->declarator);
+                data_members[d->declarator->name] = type;
+                member_symbols[d->declarator->name] = std::make_shared<VarSymbol>(type, default_value(type));
+            }
+        }
+        else if (auto mtd = node_cast<FuncDeclaration>(m)) {
+            FunctionInfo fi;
+            fi.index = static_cast<int>(program.functions.size());
+            fi.returns = resolve_type(mtd->type, mtd->declarator);
+            for (auto& p : mtd->args) {
+                fi.params.push_back(resolve_type(p->type, p->init_declarator->declarator));
+            }
+            program.functions.push_back(Function{name + "::" + mtd->declarator->name});
+
+            auto ft = TypeContext::global().function(fi.returns, fi.params, mtd->is_readonly);
+            methods[mtd->declarator->name] = ft;
+            auto fsym = std::make_shared<FuncSymbol>(ft, fi.params, mtd->is_readonly);
+            fsym->declaration = mtd;
+            member_symbols[mtd->declarator->name] = fsym;
+
+            info.methods[mtd->declarator->name] = fi.index;
+            functions[name + "::" + mtd->declarator->name] = fi;
+            bodies.emplace_back(mtd, fi);
+        }
+        else {
+            throw std::runtime_error("invalid struct member declaration in struct " + name);
+        }
+    }
+
+    // окончательный тип: указатели на саму структуру в полях остаются на предварительный тип
+    auto finalType = std::make_shared<StructType>(data_members, methods);
+    *info.type = *finalType;
+    program.structs.push_back(std::make_shared<StructSymbol>(info.type, std::move(member_symbols)));
+
+    for (auto& [mtd, fi] : bodies) {
+        compile_function(*mtd, fi, &info);
+    }
+}
+
+void Compiler::visit(ArrayDeclaration& node) {
+    release();
+    int reg = temp();
+    auto elemType = resolve_type(node.type, nullptr);
+
+    if (node.length >= 0) {
+        emit(OpCode::LoadConst, reg, constant(Value::from_int(node.length)));
+    } else if (node.size) {
+        compile_expr(*node.size, reg);
+    } else {
+        emit(OpCode::LoadConst, reg, constant(Value::from_int(static_cast<int>(node.initializer_list.size()))));
+    }
+    auto arrayType = TypeContext::global().array_of(elemType);
+    int slot = current().num_boxes++;
+    emit(OpCode::Array, reg, slot, box_slot(arrayType, default_value(elemType)));
+
+    for (size_t i = 0; i < node.initializer_list.size(); ++i) {
+        int value = compile_expr(*node.initializer_list[i]);
+        int index = temp();
+        emit(OpCode::LoadConst, index, constant(Value::from_int(static_cast<int>(i))));
+        int addr = temp();
+        emit(OpCode::Add, addr, reg, index);
+        emit(OpCode::Store, addr, value);
+        state->next_reg = reg + 1;
+    }
+
+    declare(state == &root ? qualified(node.name) : node.name, reg, arrayType, false, true);
+}
+
+void Compiler::visit(NameSpaceDeclaration& node) {
+    auto saved = ns_prefix;
+    ns_prefix += node.name + "::";
+    for (auto& decl : node.declarations) {
+        decl->accept(*this);
+        release();
+    }
+    ns_prefix = saved;
+}
+
+
+void Compiler::visit(CompoundStatement& node) {
+    push_block();
+    for (auto& stmt : node.statements) {
+        stmt->accept(*this);
+        release();
+    }
+    pop_block();
+}
+
+void Compiler::visit(DeclarationStatement& node) {
+    node.declaration->accept(*this);
+}
+
+void Compiler::visit(ExpressionStatement& node) {
+    compile_expr(*node.expression);
+}
+
+void Compiler::visit(ConditionalStatement& node) {
+    int cond = compile_expr(*node.if_branch.first);
+    int toElse = emit(OpCode::JumpIfFalse, cond, 0);
+    release();
+    node.if_branch.second->accept(*this);
+    release();
+    if (node.else_branch) {
+        int toEnd = emit(OpCode::Jump, 0);
+        patch(toElse, here());
+        node.else_branch->accept(*this);
+        release();
+        patch(toEnd, here());
+    } else {
+        patch(toElse, here());
+    }
+}
+
+// условие цикла проверяется в конце тела: один переход на итерацию
+void Compiler::visit(WhileStatement& node) {
+    int toCond = emit(OpCode::Jump, 0);
+    int body = here();
+    state->loops.push_back(Loop{});
+    node.statement->accept(*this);
+    release();
+
+    int condAt = here();
+    patch(toCond, condAt);
+    int cond = compile_expr(*node.condition);
+    emit(OpCode::JumpIfTrue, cond, body);
+    release();
+
+    auto loop = std::move(state->loops.back());
+    state->loops.pop_back();
+    for (int at : loop.continues) patch(at, condAt);
+    for (int at : loop.breaks)    patch(at, here());
+}
+
+void Compiler::visit(ForStatement& node) {
+    push_block();
+    if (node.initialization) {
+        if (auto expr = dynamic_cast<Expression*>(node.initialization)) {
+            compile_expr(*expr);
+        } else {
+            node.initialization->accept(*this);
+        }
+        release();
+    }
+
+    int toCond = emit(OpCode::Jump, 0);
+    int body = here();
+    state->loops.push_back(Loop{});
+    node.body->accept(*this);
+    release();
+
+    int incrementAt = here();
+    if (node.increment) {
+        compile_expr(*node.increment);
+        release();
+    }
+    patch(toCond, here());
+    if (node.condition) {
+        int cond = compile_expr(*node.condition);
+        emit(OpCode::JumpIfTrue, cond, body);
+        release();
+    } else {
+        emit(OpCode::Jump, body);
+    }
+
+    auto loop = std::move(state->loops.back());
+    state->loops.pop_back();
+    for (int at : loop.continues) patch(at, incrementAt);
+    for (int at : loop.breaks)    patch(at, here());
+    pop_block();
+}
+
+void Compiler::visit(DoWhileStatement& node) {
+    int body = here();
+    state->loops.push_back(Loop{});
+    node.statement->accept(*this);
+    release();
+
+    int condAt = here();
+    int cond = compile_expr(*node.condition);
+    emit(OpCode::JumpIfTrue, cond, body);
+    release();
+
+    auto loop = std::move(state->loops.back());
+    state->loops.pop_back();
+    for (int at : loop.continues) patch(at, condAt);
+    for (int at : loop.breaks)    patch(at, here());
+}
+
+void Compiler::visit(ReturnStatement& node) {
+    if (node.expression) {
+        emit(OpCode::Return, compile_expr(*node.expression));
+    } else {
+        emit(OpCode::Return, -1);
+    }
+}
+
+void Compiler::visit(BreakStatement&) {
+    if (state->loops.empty()) {
+        throw std::runtime_error("break outside of a loop");
+    }
+    state->loops.back().breaks.push_back(emit(OpCode::Jump, 0));
+}
+
+void Compiler::visit(ContinueStatement&) {
+    if (state->loops.empty()) {
+        throw std::runtime_error("continue outside of a loop");
+    }
+    state->loops.back().continues.push_back(emit(OpCode::Jump, 0));
+}
+
+void Compiler::visit(StaticAssertStatement&) {
+}
+
+
+void Compiler::visit(StructMemberAccessExpression& node) {
+    int want = target;
+    std::shared_ptr<Type> type;
+    int addr = field_address(*node.base, node.member, type);
+    int reg = want >= 0 ? want : addr;
+    emit(OpCode::Load, reg, addr);
+    result_reg = reg;
+    result_type = type;
+}
+
+void Compiler::visit(BinaryOperation& node) {
+    int want = target;
+
+    // присваивание: пишем в переменную левой части
+    if (node.op == Operator::Assign) {
+        auto lv = compile_lvalue(*node.lhs);
+        if (lv.kind == LValue::Register && !find_struct(lv.type)) {
+            compile_expr(*node.rhs, lv.index);
+            convert(lv.index, result_type, lv.type, lv.index);
+            result_reg = lv.index;
+        } else {
+            int value = compile_expr(*node.rhs);
+            result_reg = store(lv, value, result_type);
+        }
+        result_type = lv.type;
+        if (want >= 0 && want != result_reg) {
+            emit(OpCode::Move, want, result_reg);
+            result_reg = want;
+        }
+        return;
+    }
+
+    //  композитные "+=, -=, *=, /="
+    if (is_compound_assignment(node.op)) {
+        OpCode op = binary_opcode(compound_operation(node.op));
+        auto lv = compile_lvalue(*node.lhs);
+        int current = load(lv);
+        int value = compile_expr(*node.rhs);
+        auto type = arithmetic_result(lv.type, result_type);
+        if (lv.kind == LValue::Register) {
+            emit(op, lv.index, current, value);
+            result_reg = convert(lv.index, type, lv.type, lv.index);
+        } else {
+            emit(op, current, current, value);
+            result_reg = store(lv, current, type);
+        }
+        result_type = lv.type;
+        if (want >= 0 && want != result_reg) {
+            emit(OpCode::Move, want, result_reg);
+            result_reg = want;
+        }
+        return;
+    }
+
+    // логические операции вычисляются по короткой схеме
+    if (node.op == Operator::And || node.op == Operator::Or) {
+        int reg = temp();
+        compile_expr(*node.lhs, reg);
+        emit(OpCode::Test, reg, reg);
+        int skip = emit(node.op == Operator::And ? OpCode::JumpIfFalse : OpCode::JumpIfTrue, reg, 0);
+        compile_expr(*node.rhs, reg);
+        emit(OpCode::Test, reg, reg);
+        patch(skip, here());
+        if (want >= 0) {
+            emit(OpCode::Move, want, reg);
+            reg = want;
+        }
+        result_reg = reg;
+        result_type = builtin_types.at("bool");
+        return;
+    }
+
+    OpCode op = binary_opcode(node.op);
+    int lhs = compile_expr(*node.lhs);
+    auto lhsType = result_type;
+    int rhs = compile_expr(*node.rhs);
+    auto rhsType = result_type;
+
+    int reg = want >= 0 ? want : temp();
+    emit(op, reg, lhs, rhs);
+    result_reg = reg;
+    if (is_comparison(node.op)) {
+        result_type = builtin_types.at("bool");
+    } else if (kind_of(lhsType) == ValueKind::Pointer && kind_of(rhsType) == ValueKind::Pointer) {
+        result_type = builtin_types.at("int");
+    } else {
+        result_type = arithmetic_result(lhsType, rhsType);
+    }
+}
+
+void Compiler::visit(PrefixExpression& node) {
+    int want = target;
+
+    if (node.op == Operator::AddressOf) {
+        auto lv = compile_lvalue(*node.base);
+        if (lv.kind != LValue::Pointer) {
+            throw std::runtime_error("cannot take the address of this expression");
+        }
+        result_reg = lv.index;
+        if (want >= 0 && want != lv.index) {
+            emit(OpCode::Move, want, lv.index);
+            result_reg = want;
+        }
+        result_type = TypeContext::global().pointer_to(lv.type);
+        return;
+    }
+
+    if (node.op == Operator::Dereference) {
+        int addr = compile_expr(*node.base);
+        auto type = pointee_type(result_type);
+        int reg = want >= 0 ? want : temp();
+        emit(OpCode::Load, reg, addr);
+        result_reg = reg;
+        result_type = type;
+        return;
+    }
+
+    if (node.op == Operator::Increment || node.op == Operator::Decrement) {
+        increment(*node.base, true, node.op == Operator::Increment ? OpCode::Increment : OpCode::Decrement);
+        return;
+    }
+
+    if (node.op == Operator::Plus || node.op == Operator::Minus || node.op == Operator::Not) {
+        int value = compile_expr(*node.base);
+        auto type = result_type;
+        int reg = want >= 0 ? want : temp();
+        if (node.op == Operator::Not) {
+            emit(OpCode::Not, reg, value);
+            result_type = builtin_types.at("bool");
+        } else {
+            emit(node.op == Operator::Minus ? OpCode::Negate : OpCode::Plus, reg, value);
+            result_type = arithmetic_result(type, builtin_types.at("int"));
+        }
+        result_reg = reg;
+        return;
+    }
+
+    throw std::runtime_error("unsupported prefix operator: " + spelling(node.op));
+}
+
+void Compiler::increment(Expression& base, bool prefix, OpCode op) {
+    int want = target;
+    auto lv = compile_lvalue(base);
+
+    if (lv.kind == LValue::Register) {
+        int old = -1;
+        if (!prefix) {
+            old = want >= 0 ? want : temp();
+            emit(OpCode::Move, old, lv.index);
+        }
+        emit(op, lv.index);
+        result_reg = prefix ? load(lv, want) : old;
+    } else {
+        int value = load(lv);
+        int old = -1;
+        if (!prefix) {
+            old = want >= 0 ? want : temp();
+            emit(OpCode::Move, old, value);
+        }
+        emit(op, value);
+        store(lv, value, lv.type);
+        result_reg = prefix ? value : old;
+        if (prefix && want >= 0) {
+            emit(OpCode::Move, want, value);
+            result_reg = want;
+        }
+    }
+    result_type = lv.type;
+}
+
+void Compiler::visit(PostfixIncrementExpression& node) {
+    increment(*node.base, false, OpCode::Increment);
+}
+
+void Compiler::visit(PostfixDecrementExpression& node) {
+    increment(*node.base, false, OpCode::Decrement);
+}
+
+// аргументы кладутся в подряд идущие регистры над всеми занятыми
+void Compiler::call(const FunctionInfo& func, node_list<Expression> args, int self) {
+    int want = target;
+    if (args.size() != func.params.size()) {
+        throw std::runtime_error("argument count mismatch");
+    }
+
+    int base = state->next_reg;
+    int count = 0;
+    if (self >= 0) {
+        emit(OpCode::Move, temp(), self);
+        ++count;
+    }
+    for (auto& arg : args) {
+        int reg = temp();
+        compile_expr(*arg, reg);
+        state->next_reg = reg + 1;
+        ++count;
+    }
+    if (count == 0) {
+        temp();
+    }
+    emit(OpCode::Call, base, func.index, count);
+    state->next_reg = base + 1;
+
+    result_reg = base;
+    if (want >= 0) {
+        emit(OpCode::Move, want, base);
+        result_reg = want;
+    }
+    result_type = func.returns;
+}
+
+void Compiler::visit(FunctionCallExpression& node) {
+    int want = target;
+
+    if (auto ident = node_cast<IdentifierExpression>(node.base)) {
+        if (ident->name == known::print) {
+            int base = state->next_reg;
+            for (auto& arg : node.args) {
+                int reg = temp();
+                compile_expr(*arg, reg);
+                state->next_reg = reg + 1;
+            }
+            if (node.args.empty()) {
+                temp();
+            }
+            emit(OpCode::Print, base, static_cast<int>(node.args.size()));
+            state->next_reg = base + 1;
+            result_reg = load(LValue{LValue::Register, base, nullptr}, want);
+            result_type = builtin_types.at("int");
+            return;
+        }
+
+        if (ident->name == known::read) {
+            if (node.args.size() != 1) {
+                throw std::runtime_error("read() requires exactly one argument");
+            }
+            auto lv = compile_lvalue(*node.args[0]);
+            ValueKind kind = kind_of(lv.type);
+            if (kind != ValueKind::Int && kind != ValueKind::Float &&
+                kind != ValueKind::Char && kind != ValueKind::Bool) {
+                throw std::runtime_error("read(): unsupported variable type");
+            }
+            int reg = want >= 0 ? want : temp();
+            emit(OpCode::Read, reg, static_cast<int>(kind));
+            store(lv, reg, lv.type);
+            result_reg = reg;
+            result_type = lv.type;
+            return;
+        }
+
+        // метод, вызванный из другого метода той же структуры
+        if (current_struct) {
+            auto it = current_struct->methods.find(ident->name);
+            if (it != current_struct->methods.end()) {
+                call(functions.at(current_struct->name + "::" + ident->name), node.args, 0);
+                return;
+            }
+        }
+
+        auto func = find_function(ident->name);
+        if (!func) {
+            throw std::runtime_error("Undefined function: " + ident->name);
+        }
+        call(*func, node.args, -1);
+        return;
+    }
+
+    // вызов метода структуры
+    if (auto mexpr = node_cast<StructMemberAccessExpression>(node.base)) {
+        int object = compile_expr(*mexpr->base);
+        auto info = find_struct(result_type);
+        if (!info) {
+            throw std::runtime_error("method call on non-struct value");
+        }
+        if (!info->methods.count(mexpr->member)) {
+            throw std::runtime_error("expression is not a method");
+        }
+        call(functions.at(info->name + "::" + mexpr->member), node.args, object);
+        return;
+    }
+
+    // например, ns::f(...)
+    if (node_cast<NameSpaceAcceptExpression>(node.base)) {
+        auto name = scoped_name(*node.base);
+        auto it = functions.find(name);
+        if (it == functions.end()) {
+            throw std::runtime_error("Undefined function: " + name);
+        }
+        call(it->second, node.args, -1);
+        return;
+    }
+
+    throw std::runtime_error("FunctionCallExpression: base is not a function");
+}
+
+void Compiler::visit(SubscriptExpression& node) {
+    int want = target;
+    auto lv = compile_lvalue(node);
+    result_reg = load(lv, want);
+    result_type = lv.type;
+}
+
+void Compiler::visit(IntLiteral& node) {
+    int reg = target >= 0 ? target : temp();
+    emit(OpCode::LoadConst, reg, constant(Value::from_int(node.value)));
+    result_reg = reg;
+    result_type = builtin_types.at("int");
+}
+
+void Compiler::visit(FloatLiteral& node) {
+    int reg = target >= 0 ? target : temp();
+    emit(OpCode::LoadConst, reg, constant(Value::from_float(node.value)));
+    result_reg = reg;
+    result_type = builtin_types.at("float");
+}
+
+void Compiler::visit(CharLiteral& node) {
+    int reg = target >= 0 ? target : temp();
+    emit(OpCode::LoadConst, reg, constant(Value::from_char(node.value)));
+    result_reg = reg;
+    result_type = builtin_types.at("char");
+}
+
+void Compiler::visit(StringLiteral& node) {
+    int reg = target >= 0 ? target : temp();
+    emit(OpCode::LoadConst, reg, constant(Value::from_string(&node.value)));
+    result_reg = reg;
+    result_type = TypeContext::global().string_type();
+}
+
+void Compiler::visit(BoolLiteral& node) {
+    int reg = target >= 0 ? target : temp();
+    emit(OpCode::LoadConst, reg, constant(Value::from_bool(node.value)));
+    result_reg = reg;
+    result_type = builtin_types.at("bool");
+}
+
+void Compiler::visit(NullPtrLiteral&) {
+    int reg = target >= 0 ? target : temp();
+    emit(OpCode::LoadConst, reg, constant(Value::null()));
+    result_reg = reg;
+    result_type = TypeContext::global().nullptr_type();
+}
+
+void Compiler::visit(IdentifierExpression& node) {
+    int want = target;
+    auto lv = variable(node.name, false);
+    result_reg = load(lv, want);
+    result_type = lv.type;
+}
+
+void Compiler::visit(ParenthesizedExpression& node) {
+    compile_expr(*node.expression, target);
+}
+
+void Compiler::visit(TernaryExpression& node) {
+    int want = target;
+    int cond = compile_expr(*node.condition);
+    int toFalse = emit(OpCode::JumpIfFalse, cond, 0);
+    int reg = want >= 0 ? want : temp();
+    compile_expr(*node.true_expr, reg);
+    auto type = result_type;
+    int toEnd = emit(OpCode::Jump, 0);
+    patch(toFalse, here());
+    compile_expr(*node.false_expr, reg);
+    patch(toEnd, here());
+    result_reg = reg;
+    result_type = type;
+}
+
+void Compiler::visit(SizeOfExpression&) {
+    int reg = target >= 0 ? target : temp();
+    emit(OpCode::LoadConst, reg, constant(Value::from_int(sizeof(void*))));
+    result_reg = reg;
+    result_type = builtin_types.at("int");
+}
+
+void Compiler::visit(NameSpaceAcceptExpression& node) {
+    int want = target;
+    auto lv = variable(scoped_name(node), true);
+    result_reg = load(lv, want);
+    result_type = lv.type;
+}
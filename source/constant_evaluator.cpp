@@ -0,0 +1,348 @@
+#include "constant_evaluator.hpp"
+#include "type.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// constexpr-функция вычисляется всегда, когда это возможно; остальные — пробно,
+// и неудачная попытка не должна заметно замедлять загрузку
+constexpr std::size_t constexpr_steps = 1'000'000;
+constexpr std::size_t inferred_steps = 10'000;
+constexpr std::size_t max_depth = 256;
+
+const std::unordered_map<Name, std::shared_ptr<Type>> builtin_types = {
+    {"int",    TypeContext::global().int_type()},
+    {"float",  TypeContext::global().float_type()},
+    {"char",   TypeContext::global().char_type()},
+    {"bool",   TypeContext::global().bool_type()}
+};
+
+// как binary_operation, но переполнение int, как и в ConstantFolder, оставляется исполнителю
+Value checked_operation(const Value& lhs, Operator op, const Value& rhs) {
+    if (overflows(lhs, op, rhs)) {
+        throw std::runtime_error("integer overflow");
+    }
+    return binary_operation(lhs, op, rhs);
+}
+
+// значение переменной объявленного типа до инициализации, как у Execute
+Value initial_value(Name type, const Declaration::Declarator* declarator) {
+    auto it = builtin_types.find(type);
+    if (it == builtin_types.end() || node_cast<Declaration::PtrDeclarator>(declarator)) {
+        throw std::runtime_error("not a constant type: " + type);
+    }
+    return default_value(it->second);
+}
+
+}
+
+ConstantEvaluator::ConstantEvaluator(const ConstantNames& names, const ConstantCalls& calls)
+    : names(names), calls(calls) {}
+
+std::optional<Value> ConstantEvaluator::call(const FuncDeclaration& function, const std::vector<Value>& args) {
+    budget = function.is_constexpr ? constexpr_steps : inferred_steps;
+    steps = 0;
+    depth = 0;
+    frame = nullptr;
+    completion = Completion::Normal;
+    try {
+        Value value = invoke(function, args);
+        if (value.is_arithmetic()) {
+            return value;
+        }
+    } catch (const std::runtime_error&) {}
+    return std::nullopt;
+}
+
+// исключение прерывает всё вычисление, поэтому состояние восстанавливается только при возврате
+Value ConstantEvaluator::invoke(const FuncDeclaration& function, const std::vector<Value>& args) {
+    if (!function.body || function.frame_size < 0 || function.args.size() != args.size()) {
+        throw std::runtime_error("function body is not analyzed");
+    }
+    if (node_cast<Declaration::PtrDeclarator>(function.declarator)) {
+        throw std::runtime_error("pointer result is not a constant");
+    }
+    if (++depth > max_depth) {
+        throw std::runtime_error("constant evaluation is too deep");
+    }
+
+    std::vector<Value> locals(function.frame_size);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        auto parameter = function.args[i]->init_declarator;
+        Value value = initial_value(function.args[i]->type, parameter->declarator);
+        store(value, args[i]);
+        locals.at(parameter->slot) = value;
+    }
+
+    auto saved = std::exchange(frame, &locals);
+    walk(*function.body);
+    frame = saved;
+    --depth;
+
+    // как у Execute: возвращается значение return без преобразования
+    Value value = completion == Completion::Return ? return_value : Value{};
+    completion = Completion::Normal;
+    return value;
+}
+
+Value ConstantEvaluator::evaluate(Expression& expression) {
+    step();
+    walk(expression);
+    return result;
+}
+
+Value& ConstantEvaluator::local(Expression& expression) {
+    if (auto parenthesized = node_cast<ParenthesizedExpression>(&expression)) {
+        return local(*parenthesized->expression);
+    }
+    auto identifier = node_cast<IdentifierExpression>(&expression);
+    if (!identifier || identifier->depth != 0 || !frame) {
+        throw std::runtime_error("only local variables can be changed");
+    }
+    return frame->at(identifier->slot);
+}
+
+bool ConstantEvaluator::leave_loop() {
+    switch (completion) {
+        case Completion::Continue:
+            completion = Completion::Normal;
+            return false;
+        case Completion::Break:
+            completion = Completion::Normal;
+            return true;
+        case Completion::Return:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void ConstantEvaluator::step() {
+    if (++steps > budget) {
+        throw std::runtime_error("constant evaluation step limit exceeded");
+    }
+}
+
+
+void ConstantEvaluator::visit(ASTNode&) {
+    throw std::runtime_error("not a constant expression");
+}
+
+void ConstantEvaluator::visit(VarDeclaration& node) {
+    for (auto declarator : node.declarator_list) {
+        Value value;
+        if (node.type == known::auto_type) {
+            if (!declarator->initializer) {
+                throw std::runtime_error("auto declaration requires an initializer");
+            }
+            value = evaluate(*declarator->initializer);
+        } else {
+            value = initial_value(node.type, declarator->declarator);
+            if (declarator->initializer) {
+                store(value, evaluate(*declarator->initializer));
+            }
+        }
+        frame->at(declarator->slot) = value;
+    }
+}
+
+// ---------------------------
+// Операторы
+// ---------------------------
+
+void ConstantEvaluator::visit(CompoundStatement& node) {
+    step();
+    for (auto statement : node.statements) {
+        walk(*statement);
+        if (completion != Completion::Normal) {
+            break;
+        }
+    }
+}
+
+void ConstantEvaluator::visit(DeclarationStatement& node) {
+    walk(*node.declaration);
+}
+
+void ConstantEvaluator::visit(ExpressionStatement& node) {
+    evaluate(*node.expression);
+}
+
+void ConstantEvaluator::visit(ConditionalStatement& node) {
+    if (evaluate(*node.if_branch.first).as_bool()) {
+        walk(*node.if_branch.second);
+    } else if (node.else_branch) {
+        walk(*node.else_branch);
+    }
+}
+
+void ConstantEvaluator::visit(WhileStatement& node) {
+    while (evaluate(*node.condition).as_bool()) {
+        walk(*node.statement);
+        if (leave_loop()) {
+            break;
+        }
+    }
+}
+
+void ConstantEvaluator::visit(DoWhileStatement& node) {
+    do {
+        step();
+        walk(*node.statement);
+        if (leave_loop()) {
+            break;
+        }
+    } while (evaluate(*node.condition).as_bool());
+}
+
+void ConstantEvaluator::visit(ForStatement& node) {
+    if (node.initialization) {
+        walk(*node.initialization);
+    }
+    while (true) {
+        step();
+        if (node.condition && !evaluate(*node.condition).as_bool()) {
+            break;
+        }
+        walk(*node.body);
+        if (leave_loop()) {
+            break;
+        }
+        if (node.increment) {
+            evaluate(*node.increment);
+        }
+    }
+}
+
+void ConstantEvaluator::visit(ReturnStatement& node) {
+    return_value = node.expression ? evaluate(*node.expression) : Value{};
+    completion = Completion::Return;
+}
+
+void ConstantEvaluator::visit(BreakStatement&) {
+    completion = Completion::Break;
+}
+
+void ConstantEvaluator::visit(ContinueStatement&) {
+    completion = Completion::Continue;
+}
+
+// ---------------------------
+// Выражения
+// ---------------------------
+
+void ConstantEvaluator::visit(BinaryOperation& node) {
+    if (node.op == Operator::Assign || is_compound_assignment(node.op)) {
+        Value& cell = local(*node.lhs);
+        Value rhs = evaluate(*node.rhs);
+        if (node.op == Operator::Assign) {
+            store(cell, rhs);
+        } else {
+            store(cell, checked_operation(cell, compound_operation(node.op), rhs));
+        }
+        result = cell;
+        return;
+    }
+
+    if (node.op == Operator::And) {
+        bool lhs = evaluate(*node.lhs).as_bool();
+        result = Value::from_bool(lhs && evaluate(*node.rhs).as_bool());
+        return;
+    }
+    if (node.op == Operator::Or) {
+        bool lhs = evaluate(*node.lhs).as_bool();
+        result = Value::from_bool(lhs || evaluate(*node.rhs).as_bool());
+        return;
+    }
+
+    Value lhs = evaluate(*node.lhs);
+    Value rhs = evaluate(*node.rhs);
+    result = checked_operation(lhs, node.op, rhs);
+}
+
+void ConstantEvaluator::visit(PrefixExpression& node) {
+    if (node.op == Operator::Increment || node.op == Operator::Decrement) {
+        Value& cell = local(*node.base);
+        store(cell, checked_operation(cell, node.op == Operator::Increment ? Operator::Add : Operator::Sub, Value::from_int(1)));
+        result = cell;
+        return;
+    }
+    if (node.op == Operator::Plus || node.op == Operator::Minus || node.op == Operator::Not) {
+        Value base = evaluate(*node.base);
+        if (overflows(base, node.op)) {
+            throw std::runtime_error("integer overflow");
+        }
+        result = unary_operation(base, node.op);
+        return;
+    }
+    // & и * работают с ячейками памяти, которых до исполнения нет
+    throw std::runtime_error("not a constant expression: " + spelling(node.op));
+}
+
+void ConstantEvaluator::visit(PostfixIncrementExpression& node) {
+    Value& cell = local(*node.base);
+    result = cell;
+    store(cell, checked_operation(cell, Operator::Add, Value::from_int(1)));
+}
+
+void ConstantEvaluator::visit(PostfixDecrementExpression& node) {
+    Value& cell = local(*node.base);
+    result = cell;
+    store(cell, checked_operation(cell, Operator::Sub, Value::from_int(1)));
+}
+
+// print, read, методы и функции без разобранного тела в calls не попадают
+void ConstantEvaluator::visit(FunctionCallExpression& node) {
+    auto it = calls.find(&node);
+    if (it == calls.end()) {
+        throw std::runtime_error("call is not a constant expression");
+    }
+    std::vector<Value> args;
+    args.reserve(node.args.size());
+    for (auto argument : node.args) {
+        args.push_back(evaluate(*argument));
+    }
+    result = invoke(*it->second, args);
+}
+
+void ConstantEvaluator::visit(IdentifierExpression& node) {
+    if (node.depth == 0 && frame) {
+        result = frame->at(node.slot);
+        return;
+    }
+    auto it = names.find(&node);
+    if (it == names.end()) {
+        throw std::runtime_error("not a constant: " + node.name);
+    }
+    result = it->second;
+}
+
+void ConstantEvaluator::visit(IntLiteral& node) {
+    result = Value::from_int(node.value);
+}
+
+void ConstantEvaluator::visit(FloatLiteral& node) {
+    result = Value::from_float(node.value);
+}
+
+void ConstantEvaluator::visit(CharLiteral& node) {
+    result = Value::from_char(node.value);
+}
+
+void ConstantEvaluator::visit(BoolLiteral& node) {
+    result = Value::from_bool(node.value);
+}
+
+void ConstantEvaluator::visit(ParenthesizedExpression& node) {
+    result = evaluate(*node.expression);
+}
+
+void ConstantEvaluator::visit(TernaryExpression& node) {
+    if (evaluate(*node.condition).as_bool()) {
+        result = evaluate(*node.true_expr);
+    } else {
+        result = evaluate(*node.false_expr);
+    }
+}
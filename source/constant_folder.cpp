@@ -0,0 +1,336 @@
+#include "constant_folder.hpp"
+
+#include <stdexcept>
+
+ConstantFolder::ConstantFolder(const ConstantNames& names, const ConstantCalls& calls, Arena* arena)
+    : names(names), calls(calls), arena(arena) {}
+
+void ConstantFolder::fold(TranslationUnit& unit) {
+    walk(unit);
+}
+
+void ConstantFolder::fold(FuncDeclaration& function) {
+    walk(function);
+}
+
+std::optional<Value> ConstantFolder::evaluate(Expression& expression) {
+    walk(expression);
+    return value;
+}
+
+void ConstantFolder::fold(Expression*& slot) {
+    value.reset();
+    if (!slot) {
+        return;
+    }
+    walk(*slot);
+    if (!value || !arena) {
+        return;
+    }
+    switch (slot->kind) {
+        case NodeKind::IntLiteral:
+        case NodeKind::FloatLiteral:
+        case NodeKind::CharLiteral:
+        case NodeKind::BoolLiteral:
+        case NodeKind::NullPtrLiteral:
+            return;
+        default:
+            break;
+    }
+    if (auto literal = make_literal(*value)) {
+        slot = literal;
+        ++replaced;
+    }
+}
+
+void ConstantFolder::fold_operands(Expression& lvalue) {
+    walk(lvalue);
+    value.reset();
+}
+
+Expression* ConstantFolder::make_literal(const Value& v) {
+    switch (v.kind) {
+        case ValueKind::Int:   return arena->make<IntLiteral>(v.i);
+        case ValueKind::Float: return arena->make<FloatLiteral>(v.f);
+        case ValueKind::Char:  return arena->make<CharLiteral>(v.c);
+        case ValueKind::Bool:  return arena->make<BoolLiteral>(v.b);
+        default:               return nullptr;
+    }
+}
+
+
+void ConstantFolder::visit(ASTNode&) {
+    value.reset();
+}
+
+void ConstantFolder::visit(TranslationUnit& unit) {
+    for (auto node : unit.get_nodes()) {
+        walk(*node);
+    }
+}
+
+// ---------------------------
+// Объявления
+// ---------------------------
+
+void ConstantFolder::visit(VarDeclaration& node) {
+    for (auto declarator : node.declarator_list) {
+        fold(declarator->initializer);
+    }
+}
+
+void ConstantFolder::visit(ParameterDeclaration& node) {
+    fold(node.init_declarator->initializer);
+}
+
+void ConstantFolder::visit(FuncDeclaration& node) {
+    for (auto parameter : node.args) {
+        walk(*parameter);
+    }
+    if (node.body) {
+        walk(*node.body);
+    }
+}
+
+void ConstantFolder::visit(StructDeclaration& node) {
+    for (auto member : node.members) {
+        walk(*member);
+    }
+}
+
+void ConstantFolder::visit(ArrayDeclaration& node) {
+    fold(node.size);
+    for (auto& element : node.initializer_list) {
+        fold(element);
+    }
+}
+
+void ConstantFolder::visit(NameSpaceDeclaration& node) {
+    for (auto declaration : node.declarations) {
+        walk(*declaration);
+    }
+}
+
+// ---------------------------
+// Операторы
+// ---------------------------
+
+void ConstantFolder::visit(CompoundStatement& node) {
+    for (auto statement : node.statements) {
+        walk(*statement);
+    }
+}
+
+void ConstantFolder::visit(DeclarationStatement& node) {
+    walk(*node.declaration);
+}
+
+void ConstantFolder::visit(ExpressionStatement& node) {
+    fold(node.expression);
+}
+
+void ConstantFolder::visit(ConditionalStatement& node) {
+    fold(node.if_branch.first);
+    walk(*node.if_branch.second);
+    if (node.else_branch) {
+        walk(*node.else_branch);
+    }
+}
+
+void ConstantFolder::visit(WhileStatement& node) {
+    fold(node.condition);
+    walk(*node.statement);
+}
+
+void ConstantFolder::visit(DoWhileStatement& node) {
+    walk(*node.statement);
+    fold(node.condition);
+}
+
+void ConstantFolder::visit(ForStatement& node) {
+    if (node.initialization && is_expression(node.initialization->kind)) {
+        auto expression = static_cast<Expression*>(node.initialization);
+        fold(expression);
+        node.initialization = expression;
+    } else if (node.initialization) {
+        walk(*node.initialization);
+    }
+    fold(node.condition);
+    fold(node.increment);
+    walk(*node.body);
+}
+
+void ConstantFolder::visit(ReturnStatement& node) {
+    fold(node.expression);
+}
+
+void ConstantFolder::visit(BreakStatement&) {}
+
+void ConstantFolder::visit(ContinueStatement&) {}
+
+// условие уже проверено Analyzer
+void ConstantFolder::visit(StaticAssertStatement&) {}
+
+// ---------------------------
+// Выражения
+// ---------------------------
+
+void ConstantFolder::visit(BinaryOperation& node) {
+    if (node.op == Operator::Assign || is_compound_assignment(node.op)) {
+        fold_operands(*node.lhs);
+        fold(node.rhs);
+        value.reset();
+        return;
+    }
+
+    fold(node.lhs);
+    auto lhs = value;
+    fold(node.rhs);
+    auto rhs = value;
+
+    // && и || по короткой схеме: правая часть может быть не нужна
+    if (node.op == Operator::And || node.op == Operator::Or) {
+        bool stop = node.op == Operator::Or;
+        if (lhs && lhs->as_bool() == stop) {
+            value = Value::from_bool(stop);
+        } else if (lhs && rhs) {
+            value = Value::from_bool(rhs->as_bool());
+        } else {
+            value.reset();
+        }
+        return;
+    }
+
+    value.reset();
+    // деление на ноль, переполнение int и прочие ошибки остаются исполнителю
+    if (lhs && rhs && !overflows(*lhs, node.op, *rhs)) {
+        try {
+            value = binary_operation(*lhs, node.op, *rhs);
+        } catch (const std::runtime_error&) {}
+    }
+}
+
+void ConstantFolder::visit(PrefixExpression& node) {
+    if (node.op != Operator::Plus && node.op != Operator::Minus && node.op != Operator::Not) {
+        fold_operands(*node.base);
+        return;
+    }
+    fold(node.base);
+    auto base = value;
+    value.reset();
+    if (base && !overflows(*base, node.op)) {
+        try {
+            value = unary_operation(*base, node.op);
+        } catch (const std::runtime_error&) {}
+    }
+}
+
+void ConstantFolder::visit(PostfixIncrementExpression& node) {
+    fold_operands(*node.base);
+}
+
+void ConstantFolder::visit(PostfixDecrementExpression& node) {
+    fold_operands(*node.base);
+}
+
+// вызов свободной функции с константными аргументами вычисляется ConstantEvaluator
+void ConstantFolder::visit(FunctionCallExpression& node) {
+    fold_operands(*node.base);
+    std::vector<Value> args;
+    bool constant = true;
+    for (auto& argument : node.args) {
+        fold(argument);
+        if (value) {
+            args.push_back(*value);
+        } else {
+            constant = false;
+        }
+    }
+    value.reset();
+    auto callee = calls.find(&node);
+    if (constant && callee != calls.end()) {
+        value = ConstantEvaluator(names, calls).call(*callee->second, args);
+    }
+}
+
+void ConstantFolder::visit(SubscriptExpression& node) {
+    fold_operands(*node.base);
+    fold(node.index);
+    value.reset();
+}
+
+void ConstantFolder::visit(StructMemberAccessExpression& node) {
+    fold_operands(*node.base);
+}
+
+void ConstantFolder::visit(IdentifierExpression& node) {
+    auto it = names.find(&node);
+    if (it != names.end()) {
+        value = it->second;
+    } else {
+        value.reset();
+    }
+}
+
+void ConstantFolder::visit(IntLiteral& node) {
+    value = Value::from_int(node.value);
+}
+
+void ConstantFolder::visit(FloatLiteral& node) {
+    value = Value::from_float(node.value);
+}
+
+void ConstantFolder::visit(CharLiteral& node) {
+    value = Value::from_char(node.value);
+}
+
+// строки не сворачиваются: значение строки ссылается на свой узел
+void ConstantFolder::visit(StringLiteral&) {
+    value.reset();
+}
+
+void ConstantFolder::visit(BoolLiteral& node) {
+    value = Value::from_bool(node.value);
+}
+
+void ConstantFolder::visit(NullPtrLiteral&) {
+    value = Value::null();
+}
+
+void ConstantFolder::visit(ParenthesizedExpression& node) {
+    fold(node.expression);
+}
+
+// Исполнитель возвращает значение выбранной ветви как есть, без общего типа ветвей,
+// поэтому выражение сворачивается, только когда обе ветви — константы одного вида.
+void ConstantFolder::visit(TernaryExpression& node) {
+    fold(node.condition);
+    auto condition = value;
+    fold(node.true_expr);
+    auto on_true = value;
+    fold(node.false_expr);
+    auto on_false = value;
+
+    value.reset();
+    if (condition && on_true && on_false && on_true->kind == on_false->kind) {
+        value = condition->as_bool() ? on_true : on_false;
+    }
+}
+
+// sizeof не зависит от типа; операнд-выражение вычисляется исполнителем,
+// поэтому сворачивается только операнд без побочных эффектов
+void ConstantFolder::visit(SizeOfExpression& node) {
+    bool pure = node.is_type;
+    if (!node.is_type) {
+        fold(node.expression);
+        pure = value || node_cast<IdentifierExpression>(node.expression);
+    }
+    value.reset();
+    if (pure) {
+        value = Value::from_int(sizeof(void*));
+    }
+}
+
+void ConstantFolder::visit(NameSpaceAcceptExpression&) {
+    value.reset();
+}
@@ -1,23 +1,28 @@
 #include "visitor.hpp"
 
 Declaration::Declarator::Declarator(
-	const std::string& name
-	) : name(name) {}
+	NodeKind kind,
+	Name name
+	) : kind(kind), name(name) {}
+
+Declaration::SimpleDeclarator::SimpleDeclarator(
+	Name name
+	) : Declarator(node_kind, name) {}
 
 void Declaration::SimpleDeclarator::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
-Declaration::PtrDeclarator::PtrDeclarator(const std::shared_ptr<Declarator>& inner)
-        : Declarator(inner->name), inner(inner) {}
+Declaration::PtrDeclarator::PtrDeclarator(Declarator* inner)
+        : Declarator(node_kind, inner->name), inner(inner) {}
 
 void Declaration::PtrDeclarator::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
 Declaration::InitDeclarator::InitDeclarator(
-	const std::shared_ptr<Declarator>& declarator,
-	const std::shared_ptr<Expression>& initializer
+	Declarator* declarator,
+	Expression* initializer
 	) : declarator(declarator), initializer(initializer) {}
 
 void Declaration::InitDeclarator::accept(Visitor& visitor) {
@@ -26,9 +31,9 @@ void Declaration::InitDeclarator::accept(Visitor& visitor) {
 
 VarDeclaration::VarDeclaration(
 	bool is_const,
-	const std::string& type,
-	const std::vector<std::shared_ptr<InitDeclarator>>& declarator_list
-	) : is_const(is_const), type(type), declarator_list(declarator_list) {}
+	Name type,
+	node_list<InitDeclarator> declarator_list
+	) : Declaration(node_kind), is_const(is_const), type(type), declarator_list(declarator_list) {}
 
 void VarDeclaration::accept(Visitor& visitor) {
 	visitor.visit(*this);
@@ -36,49 +41,49 @@ void VarDeclaration::accept(Visitor& visitor) {
 
 FuncDeclaration::FuncDeclaration(
 	bool is_const,
-	const std::string& type,
-	const std::shared_ptr<Declarator>& declarator,
+	Name type,
+	Declarator* declarator,
 	bool is_readonly,
-	const std::vector<std::shared_ptr<ParameterDeclaration>>& args,
-	const std::shared_ptr<CompoundStatement>& body
-	) : is_const(is_const), type(type), declarator(declarator), is_readonly(is_readonly), args(args), body(body) {}
+	node_list<ParameterDeclaration> args,
+	CompoundStatement* body
+	) : Declaration(node_kind), is_const(is_const), type(type), declarator(declarator), is_readonly(is_readonly), args(args), body(body) {}
 
 void FuncDeclaration::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
 ParameterDeclaration::ParameterDeclaration(
-	const std::string& type,
-	const std::shared_ptr<InitDeclarator>& init_declarator
-	) : type(type), init_declarator(init_declarator) {}
+	Name type,
+	InitDeclarator* init_declarator
+	) : Declaration(node_kind), type(type), init_declarator(init_declarator) {}
 
 void ParameterDeclaration::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
 StructDeclaration:: StructDeclaration 
-    (const std::string& name, 
-                      const std::vector<std::shared_ptr<Declaration>>& members)
-        : name(name), members(members) {}
+    (Name name, 
+                      node_list<Declaration> members)
+        : Declaration(node_kind), name(name), members(members) {}
 
 void StructDeclaration::accept(Visitor& visitor) {
         visitor.visit(*this);
 }
 
 
-ArrayDeclaration::ArrayDeclaration(const std::string& type,
-                                   const std::string& name,
-                                   const std::shared_ptr<Expression>& size,
-								const std::vector<std::shared_ptr<Expression>>& initializer_list)
-	: type(type), name(name), size(size), initializer_list(initializer_list) {}
+ArrayDeclaration::ArrayDeclaration(Name type,
+                                   Name name,
+                                   Expression* size,
+								node_list<Expression> initializer_list)
+	: Declaration(node_kind), type(type), name(name), size(size), initializer_list(initializer_list) {}
 
 void ArrayDeclaration::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
-NameSpaceDeclaration::NameSpaceDeclaration(const std::string& name,
-								const std::vector<std::shared_ptr<Declaration>>& declarations)
-	: name(name), declarations(declarations) {}
+NameSpaceDeclaration::NameSpaceDeclaration(Name name,
+								node_list<Declaration> declarations)
+	: Declaration(node_kind), name(name), declarations(declarations) {}
 void NameSpaceDeclaration::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
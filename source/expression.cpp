@@ -1,52 +1,52 @@
 #include "visitor.hpp"
 
 BinaryOperation::BinaryOperation(
-	std::string op, 
-	std::shared_ptr<Expression> lhs,
-	std::shared_ptr<Expression> rhs
-	) : op(op), lhs(lhs), rhs(rhs) {}
+	Operator op, 
+	Expression* lhs,
+	Expression* rhs
+	) : BinaryExpression(node_kind), op(op), lhs(lhs), rhs(rhs) {}
 
 void BinaryOperation::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
 PrefixExpression::PrefixExpression(
-	std::string op,
-	std::shared_ptr<Expression> base
-	) : op(op), base(base) {}
+	Operator op,
+	Expression* base
+	) : UnaryExpression(node_kind), op(op), base(base) {}
 
 void PrefixExpression::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
 FunctionCallExpression::FunctionCallExpression(
-	std::shared_ptr<Expression> base,
-	const std::vector<std::shared_ptr<Expression>>& args
-	) : base(base), args(args) {}
+	Expression* base,
+	node_list<Expression> args
+	) : PostfixExpression(node_kind), base(base), args(args) {}
 
 void FunctionCallExpression::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
 PostfixIncrementExpression::PostfixIncrementExpression(
-	std::shared_ptr<Expression> base
-	) : base(base) {}
+	Expression* base
+	) : PostfixExpression(node_kind), base(base) {}
 
 void PostfixIncrementExpression::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
 PostfixDecrementExpression::PostfixDecrementExpression(
-	std::shared_ptr<Expression> base
-	) : base(base) {}
+	Expression* base
+	) : PostfixExpression(node_kind), base(base) {}
 
 void PostfixDecrementExpression::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
 IdentifierExpression::IdentifierExpression(
-	const std::string& name
-	) : name(name) {}
+	Name name
+	) : PrimaryExpression(node_kind), name(name) {}
 
 void IdentifierExpression::accept(Visitor& visitor) {
 	visitor.visit(*this);
@@ -54,7 +54,11 @@ void IdentifierExpression::accept(Visitor& visitor) {
 
 IntLiteral::IntLiteral(
 	const std::string& value
-	) : value(std::stoi(value)) {}
+	) : LiteralExpression(node_kind), value(std::stoi(value)) {}
+
+IntLiteral::IntLiteral(
+	int value
+	) : LiteralExpression(node_kind), value(value) {}
 
 void IntLiteral::accept(Visitor& visitor) {
 	visitor.visit(*this);
@@ -62,7 +66,11 @@ void IntLiteral::accept(Visitor& visitor) {
 
 FloatLiteral::FloatLiteral(
 	const std::string& value
-	) : value(std::stof(value)) {}
+	) : LiteralExpression(node_kind), value(std::stof(value)) {}
+
+FloatLiteral::FloatLiteral(
+	double value
+	) : LiteralExpression(node_kind), value(value) {}
 
 void FloatLiteral::accept(Visitor& visitor) {
 	visitor.visit(*this);
@@ -70,15 +78,19 @@ void FloatLiteral::accept(Visitor& visitor) {
 
 CharLiteral::CharLiteral(
 	const std::string& value
-	) : value(value[0]) {}
+	) : LiteralExpression(node_kind), value(value[0]) {}
+
+CharLiteral::CharLiteral(
+	char value
+	) : LiteralExpression(node_kind), value(value) {}
 
 void CharLiteral::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
 StringLiteral::StringLiteral(
-	const std::string& value
-	) : value(value) {}
+	std::string_view value
+	) : LiteralExpression(node_kind), value(value) {}
 
 void StringLiteral::accept(Visitor& visitor) {
 	visitor.visit(*this);
@@ -86,19 +98,25 @@ void StringLiteral::accept(Visitor& visitor) {
 
 BoolLiteral::BoolLiteral(
 	const std::string& value
-	) : value(value == "true" ? true : false) {}
+	) : LiteralExpression(node_kind), value(value == "true" ? true : false) {}
+
+BoolLiteral::BoolLiteral(
+	bool value
+	) : LiteralExpression(node_kind), value(value) {}
 
 void BoolLiteral::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
+NullPtrLiteral::NullPtrLiteral() : LiteralExpression(node_kind) {}
+
 void NullPtrLiteral::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
 ParenthesizedExpression::ParenthesizedExpression(
-	std::shared_ptr<Expression> expression
-	) : expression(expression) {}
+	Expression* expression
+	) : PrimaryExpression(node_kind), expression(expression) {}
 
 void ParenthesizedExpression::accept(Visitor& visitor) {
 	visitor.visit(*this);
@@ -107,17 +125,17 @@ void ParenthesizedExpression::accept(Visitor& visitor) {
 
 StructMemberAccessExpression::StructMemberAccessExpression
 (
-	std::shared_ptr<Expression> base, const std::string& member)
-        : base(base), member(member) {}
+	Expression* base, Name member)
+        : PostfixExpression(node_kind), base(base), member(member) {}
 
 void StructMemberAccessExpression::accept(Visitor& visitor){
         visitor.visit(*this);
     }
 	
 SubscriptExpression::SubscriptExpression(
-	std::shared_ptr<Expression> base,
-	std::shared_ptr<Expression> index
-) : base(base), index(index) {}
+	Expression* base,
+	Expression* index
+) : PostfixExpression(node_kind), base(base), index(index) {}
 
 void SubscriptExpression::accept(Visitor& visitor) {
 		visitor.visit(*this);
@@ -125,22 +143,22 @@ void SubscriptExpression::accept(Visitor& visitor) {
 	
 
 TernaryExpression::TernaryExpression(
-	std::shared_ptr<Expression> condition,
-	std::shared_ptr<Expression> true_expr,
-	std::shared_ptr<Expression> false_expr
-) : condition(condition) , true_expr(true_expr), false_expr(false_expr) {}
+	Expression* condition,
+	Expression* true_expr,
+	Expression* false_expr
+) : Expression(node_kind), condition(condition) , true_expr(true_expr), false_expr(false_expr) {}
 
 void TernaryExpression::accept(Visitor& visitor){
 	visitor.visit(*this);
 }
 
 SizeOfExpression::SizeOfExpression(
-	const std::string& type_name
-) : is_type(true), type_name(type_name), expression(nullptr) {}
+	Name type_name
+) : PostfixExpression(node_kind), is_type(true), type_name(type_name), expression(nullptr) {}
 
 SizeOfExpression::SizeOfExpression(
-	std::shared_ptr<Expression> expression
-) : is_type(false), type_name(""), expression(expression) {}
+	Expression* expression
+) : PostfixExpression(node_kind), is_type(false), type_name(""), expression(expression) {}
 
 void SizeOfExpression::accept(Visitor& visitor){
 	visitor.visit(*this);
@@ -148,9 +166,9 @@ void SizeOfExpression::accept(Visitor& visitor){
 
 
 NameSpaceAcceptExpression::NameSpaceAcceptExpression(
-	std::shared_ptr<Expression> base,
-	const std::string& name
-) : base(base), name(name) {}
+	Expression* base,
+	Name name
+) : PostfixExpression(node_kind), base(base), name(name) {}
 void NameSpaceAcceptExpression::accept(Visitor& visitor){
 	visitor.visit(*this);
 }
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "incremental_parser.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "scan.hpp"
+
+namespace {
+
+// лексема, с которой узел не может начинаться: она продолжает if, do-while или struct
+bool continues(TokenType type) {
+    return type == TokenType::ELSE || type == TokenType::WHILE || type == TokenType::SEMICOLON;
+}
+
+}
+
+
+IncrementalParser::IncrementalParser(std::string filename) : filename(std::move(filename)) {}
+
+// Отрезок [begin, end) лексируется и разбирается отдельно от остального файла.
+// Исключение — отрезок нельзя разобрать без соседей (или в нём настоящая ошибка).
+std::vector<IncrementalParser::Item> IncrementalParser::parse_range(
+    std::size_t begin, std::size_t end, std::unique_ptr<Arena>& arena) const {
+    std::string_view text(source);
+
+    // позиция начала отрезка для сообщений об ошибках
+    std::size_t line_begin = begin == 0 ? 0 : text.rfind('\n', begin - 1) + 1;
+    auto line = static_cast<std::uint32_t>(1 + scan::count(text.data(), text.data() + begin, '\n'));
+    auto column = static_cast<std::uint32_t>(begin - line_begin + 1);
+
+    Lexer lexer(filename, text.substr(begin, end - begin), line, column);
+    auto tokens = lexer.tokenize();
+
+    // Посреди файла отрезок обязан кончаться своей лексемой «;» или «}».
+    // Иначе правка открыла комментарий, строку или скобку, которые тянутся дальше.
+    if (end != source.size()) {
+        const Token* last = tokens.size() >= 2 ? &tokens[tokens.size() - 2] : nullptr;
+        if (!last || (last->type != TokenType::SEMICOLON && last->type != TokenType::BRACE_RIGHT) ||
+            last->value.data() + last->value.size() != text.data() + end) {
+            throw std::runtime_error("IncrementalParser: range does not end at a top-level boundary");
+        }
+    }
+
+    Parser parser(std::span<const Token>(tokens.data(), tokens.size() - 1), tokens.back());
+    std::vector<std::size_t> ends;
+    std::vector<ASTNode*> nodes;
+    // узлы сразу в арену дерева: без нового блока на каждую правку
+    parser.arena.swap(arena);
+    try {
+        nodes = parser.parse_top_level(&ends);
+    } catch (...) {
+        parser.arena.swap(arena);
+        throw;
+    }
+    parser.arena.swap(arena);
+
+    // одни пробелы и комментарии в конце файла достаются предыдущему узлу
+    if (nodes.empty() && begin != 0) {
+        throw std::runtime_error("IncrementalParser: range has no declarations");
+    }
+
+    std::vector<Item> items;
+    std::size_t from = begin;
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        const Token& last = tokens[ends[i] - 1];
+        std::size_t to = i + 1 == nodes.size()
+            ? end
+            : static_cast<std::size_t>(last.value.data() + last.value.size() - text.data());
+        items.push_back({nodes[i], to - from, tokens[i == 0 ? 0 : ends[i - 1]].type});
+        from = to;
+    }
+    return items;
+}
+
+void IncrementalParser::edit(std::size_t begin, std::size_t end, std::string_view replacement) {
+    if (begin > end || end > source.size()) {
+        throw std::runtime_error("IncrementalParser: edit out of range");
+    }
+
+    // начала узлов в прежнем тексте; starts.back() — его длина
+    std::vector<std::size_t> starts{0};
+    for (const Item& item : items) {
+        starts.push_back(starts.back() + item.length);
+    }
+
+    // Задетые узлы [lo, hi): отрезок пересекается с правкой или касается её края,
+    // чтобы лексемы на стыке (вставка вплотную к соседу) тоже перечитывались.
+    std::size_t lo = 0;
+    while (lo < items.size() && starts[lo + 1] < begin) {
+        ++lo;
+    }
+    std::size_t hi = lo;
+    while (hi < items.size() && starts[hi] <= end) {
+        ++hi;
+    }
+
+    source.replace(begin, end - begin, replacement);
+    std::ptrdiff_t delta = static_cast<std::ptrdiff_t>(replacement.size()) - static_cast<std::ptrdiff_t>(end - begin);
+
+    // когда мёртвых узлов в арене больше, чем живых, дерево строится заново в новой арене
+    if (!valid || garbage > source.size()) {
+        lo = 0;
+        hi = items.size();
+    }
+
+    bool spliced = false;
+    while (!spliced && (lo != 0 || hi != items.size())) {
+        // узлы неудачной попытки тоже остаются в арене
+        garbage += starts[hi] - starts[lo];
+        try {
+            auto fresh = parse_range(starts[lo], starts[hi] + delta, tree->arena);
+            bool joined = (!fresh.empty() && continues(fresh.front().first)) ||
+                          (hi < items.size() && continues(items[hi].first));
+            if (!joined) {
+                last_reparsed = fresh.size();
+                items.erase(items.begin() + lo, items.begin() + hi);
+                items.insert(items.begin() + lo, fresh.begin(), fresh.end());
+                spliced = true;
+                break;
+            }
+        } catch (const std::runtime_error&) {
+            // ошибка может исчезнуть вместе с соседями: правка закрыла бы их скобку
+        }
+        std::size_t grow = hi - lo;
+        lo = lo > grow ? lo - grow : 0;
+        hi = std::min(items.size(), hi + grow);
+    }
+
+    // весь файл: настоящая ошибка разбора уходит к вызывающему, дерево остаётся прежним
+    if (!spliced) {
+        valid = false;
+        auto arena = std::make_unique<Arena>();
+        items = parse_range(0, source.size(), arena);
+        tree = std::make_unique<TranslationUnit>(node_list<ASTNode>(), std::move(arena));
+        garbage = 0;
+        last_reparsed = items.size();
+        valid = true;
+    }
+
+    nodes.clear();
+    for (const Item& item : items) {
+        nodes.push_back(item.node);
+    }
+    tree->declarations = nodes;
+}
+
+void IncrementalParser::update(std::string_view text) {
+    if (valid && text == source) {
+        return;
+    }
+    std::size_t common = std::min(source.size(), text.size());
+    std::size_t prefix = std::mismatch(text.begin(), text.begin() + common, source.begin()).first - text.begin();
+    std::size_t suffix = 0;
+    while (suffix < common - prefix && source[source.size() - 1 - suffix] == text[text.size() - 1 - suffix]) {
+        ++suffix;
+    }
+    edit(prefix, source.size() - suffix, text.substr(prefix, text.size() - suffix - prefix));
+}
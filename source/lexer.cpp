@@ -1,197 +1,384 @@
 #include "lexer.hpp"
 #include "token.hpp"
+#include "scan.hpp"
+#include <algorithm>
+#include <array>
 #include <iostream>
-#include <fstream>
+#include <stdexcept>
 #include <cctype>
-#include <unordered_map>
-#include <set>
 
+namespace {
+
+// Классы символов для выбора ветви главного цикла — одна загрузка из таблицы вместо цепочки isxxx.
+enum class CharClass : std::uint8_t { Other, Space, Newline, Digit, Quote, Ident, Operator, Punct };
+
+constexpr std::array<CharClass, 256> make_char_classes() {
+    std::array<CharClass, 256> classes{};
+    for (unsigned c = 0; c < 256; ++c) {
+        if (c == '\n')                                         classes[c] = CharClass::Newline;
+        else if (c == ' ' || (c >= '\t' && c <= '\r'))        classes[c] = CharClass::Space;
+        else if (c >= '0' && c <= '9')                          classes[c] = CharClass::Digit;
+        else if (c == '"' || c == '\'')                         classes[c] = CharClass::Quote;
+        else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_')
+                                                                classes[c] = CharClass::Ident;
+        else if (std::string_view("+-*/%^&|=<>!~?:").find(static_cast<char>(c)) != std::string_view::npos)
+                                                                classes[c] = CharClass::Operator;
+        else if (c >= 0x21 && c <= 0x7e)                        classes[c] = CharClass::Punct;
+    }
+    return classes;
+}
 
-Lexer::Lexer(const std::string& filename) : filename(filename), offset(0) {}
+constexpr auto char_classes = make_char_classes();
 
-std::vector<Token> Lexer::tokenize() {
-    std::vector<Token> tokens;
-    std::ifstream file(filename);
+CharClass char_class(char c) { return char_classes[static_cast<unsigned char>(c)]; }
+bool is_digit(char c)        { return char_class(c) == CharClass::Digit; }
+bool is_ident_char(char c)   { return char_class(c) == CharClass::Ident || char_class(c) == CharClass::Digit; }
 
-    if (!file) {
-        std::cerr << "Error opening file: " << filename << std::endl;
-        return tokens;
-    }
+// длина, до которой имя проще дочитать без векторного поиска
+constexpr std::size_t short_word = 16;
 
-    std::string line;
-    while (std::getline(file, line)) {
-        offset = 0;
-        while (offset < line.size()) {
 
-             if (std::isspace(static_cast<unsigned char>(line[offset]))) {
-                ++offset;
-                continue;
-            }
-            if (line[offset] == '/' 
-                && offset + 1 < line.size() 
-                && line[offset + 1] == '/') 
-            {
-                break;
-            }
-            if (line[offset] == '/' 
-                && offset + 1 < line.size() 
-                && line[offset + 1] == '*') 
-            {
-                offset += 2; 
-                bool closed = false;
-                while (!closed) {
-                    auto pos = line.find("*/", offset);
-                    if (pos != std::string::npos) {
-                        offset = pos + 2;
-                        closed = true;
-                    } else if (std::getline(file, line)) {
-                        offset = 0;
-                    } else {
-                        closed = true;
-                        offset = line.size();
-                    }
-                }
-                continue; 
-            }
-
-            char current = line[offset];
-            if (std::isdigit(current) || current == '"' || current == '\'' || 
-                (current == '-' && offset + 1 < line.size() && std::isdigit(line[offset + 1]))) {
-                tokens.push_back(extract_literal(line));
-            } else if (std::isalpha(current) || current == '_') {
-                tokens.push_back(extract_id(line));
-            } else if (operator_char.find(current) != std::string::npos) {
-                tokens.push_back(extract_operator(line));
-            } else if (std::ispunct(current)) {
-                tokens.push_back(extract_punctuator(line));
-            } else {
-                offset++;
-            }
+struct Entry {
+    std::string_view text;
+    TokenType type;
+};
+
+// Зарезервированные слова: имена встроенных типов и ключевые слова.
+constexpr Entry words[] = {
+    {"int", TokenType::TYPE},
+    {"float", TokenType::TYPE},
+    {"double", TokenType::TYPE},
+    {"char", TokenType::TYPE},
+    {"bool", TokenType::TYPE},
+    {"size_t", TokenType::TYPE},
+    {"void", TokenType::TYPE},
+    {"auto", TokenType::TYPE},
+
+    {"if", TokenType::IF},
+    {"else", TokenType::ELSE},
+    {"for", TokenType::FOR},
+    {"while", TokenType::WHILE},
+    {"struct", TokenType::STRUCT},
+    {"break", TokenType::BREAK},
+    {"continue", TokenType::CONTINUE},
+    {"const", TokenType::CONST},
+    {"do", TokenType::DO},
+    {"false", TokenType::FALSE},
+    {"true", TokenType::TRUE},
+    {"return", TokenType::RETURN},
+    {"sizeof", TokenType::SIZEOF},
+    {"static_assert", TokenType::STATICASSERT},
+    {"namespace", TokenType::NAMESPACE},
+    {"constexpr", TokenType::CONSTEXPR},
+    {"nullptr", TokenType::NULLPTR}
+};
+
+constexpr std::size_t word_min = 2;
+constexpr std::size_t word_max = 13;
+constexpr std::size_t word_table_size = 64;
+
+// Совершенный хеш по первым двум и последнему символам и длине (подобран для words).
+constexpr std::size_t word_hash(std::string_view w) {
+    return (static_cast<unsigned char>(w[0]) + 5 * static_cast<unsigned char>(w[1]) +
+            12 * static_cast<unsigned char>(w.back()) + w.size()) % word_table_size;
+}
+
+constexpr std::array<Entry, word_table_size> make_word_table() {
+    std::array<Entry, word_table_size> table{};
+    for (const auto& word : words) {
+        auto& slot = table[word_hash(word.text)];
+        if (!slot.text.empty()) {
+            throw "word_hash is not perfect for the reserved words";
         }
+        slot = word;
     }
-    tokens.push_back({TokenType::END, ""});
-    return tokens;
+    return table;
 }
 
-Token Lexer::extract_literal(const std::string& line) {
-    if (std::isdigit(line[offset])) {
-        std::size_t size = 0;
+// коллизия в хеше делает вызов неконстантным — сборка упадёт здесь
+constexpr auto word_table = make_word_table();
 
-        while (std::isdigit(line[offset + size])) ++size;
+// слово -> TYPE, ключевое слово или ID: одно вычисление хеша и одно сравнение
+TokenType classify_word(std::string_view word) {
+    if (word.size() < word_min || word.size() > word_max) {
+        return TokenType::ID;
+    }
+    const Entry& slot = word_table[word_hash(word)];
+    return slot.text == word ? slot.type : TokenType::ID;
+}
 
-        if (line[offset + size] == '.') {
-            ++size;
-            while (std::isdigit(line[offset + size])) ++size;
-        }
 
-        std::string value = line.substr(offset, size);
-        offset += size;
-        return {TokenType::LITERAL_NUM, value};
-    }
+// Операторы; для каждого первого символа кандидаты идут от длинных к коротким.
+constexpr Entry operator_list[] = {
+    {"<<=", TokenType::LEFT_SHIFT_ASSIGN},
+    {">>=", TokenType::RIGHT_SHIFT_ASSIGN},
 
-    if (line[offset] == '\'') {
-        if (offset + 2 < line.size() && line[offset + 2] == '\'') {
-            std::string value = line.substr(offset, 3);
-            offset += 3;
-            return {TokenType::LITERAL_CHAR, value};
-        }
-    }
+    {"::", TokenType::SCOPE},
+    {"^^", TokenType::POWER},
+    {"+=", TokenType::PLUS_ASSIGN},
+    {"-=", TokenType::MINUS_ASSIGN},
+    {"*=", TokenType::MULTIPLY_ASSIGN},
+    {"/=", TokenType::DIVIDE_ASSIGN},
+    {"%=", TokenType::MODULO_ASSIGN},
+    {"&=", TokenType::AND_ASSIGN},
+    {"^=", TokenType::XOR_ASSIGN},
+    {"|=", TokenType::OR_ASSIGN},
+    {"==", TokenType::EQUAL},
+    {"!=", TokenType::NOT_EQUAL},
+    {">=", TokenType::GREATER_EQUAL},
+    {"<=", TokenType::LESS_EQUAL},
+    {"&&", TokenType::AND},
+    {"||", TokenType::OR},
+    {"<<", TokenType::LEFT_SHIFT},
+    {">>", TokenType::RIGHT_SHIFT},
+    {"++", TokenType::INCREMENT},
+    {"--", TokenType::DECREMENT},
+    {"->", TokenType::ARROW},
 
-    if (line[offset] == '"') {
-        std::size_t start = offset + 1;
-        std::size_t end = line.find('"', start);
-        if (end != std::string::npos) {
-            std::string value = line.substr(offset, end - offset + 1);
-            offset = end + 1;
-            return {TokenType::LITERAL_STRING, value};
+    {"+", TokenType::PLUS},
+    {"-", TokenType::MINUS},
+    {"*", TokenType::MULTIPLY},
+    {"/", TokenType::DIVIDE},
+    {"%", TokenType::MODULO},
+    {"=", TokenType::ASSIGN},
+    {">", TokenType::GREATER},
+    {"<", TokenType::LESS},
+    {"!", TokenType::NOT},
+    {"?", TokenType::QUESTION},
+    {"&", TokenType::BIT_AND},
+    {"|", TokenType::BIT_OR},
+    {"^", TokenType::BIT_XOR},
+    {"~", TokenType::BIT_NOT},
+    {":", TokenType::COLON}
+};
+
+constexpr std::size_t operator_candidates = 4;
+
+struct OperatorBucket {
+    std::array<Entry, operator_candidates> entries{};
+    std::size_t count = 0;
+};
+
+constexpr std::array<OperatorBucket, 128> make_operator_table() {
+    std::array<OperatorBucket, 128> table{};
+    for (const auto& op : operator_list) {
+        auto& bucket = table[static_cast<unsigned char>(op.text[0])];
+        if (bucket.count == operator_candidates) {
+            throw "too many operators share a first character";
         }
+        // operator_list упорядочен по убыванию длины, поэтому первый совпавший — самый длинный
+        bucket.entries[bucket.count++] = op;
     }
+    return table;
+}
 
-    return {TokenType::END, ""};
+constexpr auto operator_table = make_operator_table();
+
+constexpr std::array<TokenType, 128> make_punctuator_table() {
+    std::array<TokenType, 128> table{};
+    table.fill(TokenType::END);
+    table[','] = TokenType::COMMA;
+    table['.'] = TokenType::DOT;
+    table[':'] = TokenType::COLON;
+    table[';'] = TokenType::SEMICOLON;
+    table['{'] = TokenType::BRACE_LEFT;
+    table['}'] = TokenType::BRACE_RIGHT;
+    table['('] = TokenType::PARENTHESIS_LEFT;
+    table[')'] = TokenType::PARENTHESIS_RIGHT;
+    table['['] = TokenType::INDEX_LEFT;
+    table[']'] = TokenType::INDEX_RIGHT;
+    return table;
 }
 
-Token Lexer::extract_id(const std::string& line) {
-    std::size_t start = offset;
-    while (offset < line.size() && (std::isalnum(line[offset]) || line[offset] == '_')) {
-        offset++;
-    }
+constexpr auto punctuator_table = make_punctuator_table();
 
-    std::string value = line.substr(start, offset - start);
+}
 
- 
-    if (types.find(value) != types.end()) {
-        return {TokenType::TYPE, value};
-    }
 
-   
-    if (keywords.find(value) != keywords.end()) {
-        return {keywords[value], value};
+Lexer::Lexer(const std::string& filename)
+    : filename(filename), buffer(filename), source(buffer.text()), offset(0), line(1), line_start(0) {
+    // неоткрытый файл читается как пустой: next() сразу вернёт END
+    if (!buffer.is_open()) {
+        std::cerr << "Error opening file: " << filename << std::endl;
     }
+}
+
+// столбец считается от line_start, поэтому начало строки сдвигается влево
+// за начало текста (беззнаковое вычитание по модулю даёт верный столбец)
+Lexer::Lexer(const std::string& filename, std::string_view text, std::uint32_t line, std::uint32_t column)
+    : filename(filename), source(text), offset(0), line(line), line_start(std::size_t(0) - (column - 1)) {}
+
+// все лексемы сразу; парсер берёт их по одной через TokenStream
+std::vector<Token> Lexer::tokenize() {
+    std::vector<Token> tokens;
+    // грубая оценка: одна лексема на каждые четыре символа
+    tokens.reserve(source.size() / 4 + 1);
 
-    return {TokenType::ID, value};
+    do {
+        tokens.push_back(next());
+    } while (tokens.back().type != TokenType::END);
+    return tokens;
 }
 
-Token Lexer::extract_operator(const std::string& line) {
-    if (offset + 1 < line.size()) {
-        std::string two_char_op = line.substr(offset, 2);
-        auto it = operators.find(two_char_op);
-        if (it != operators.end()) {
-            offset += 2;  
-            return {it->second, two_char_op};  
+// следующая лексема; текст не копируется, после конца файла — снова END
+Token Lexer::next() {
+    while (offset < source.size()) {
+        char current = source[offset];
+
+        switch (char_class(current)) {
+            case CharClass::Newline:
+                ++offset;
+                ++line;
+                line_start = offset;
+                break;
+            case CharClass::Space:
+                // чаще всего между лексемами один пробел; длинные серии — через scan
+                ++offset;
+                if (offset < source.size() && char_class(source[offset]) == CharClass::Space) {
+                    offset = scan_to(scan::skip_blanks(at(offset), at(source.size())));
+                }
+                break;
+            case CharClass::Digit:
+            case CharClass::Quote:
+                return extract_literal();
+            case CharClass::Ident:
+                return extract_id();
+            case CharClass::Operator:
+                if (current == '/' && offset + 1 < source.size()) {
+                    if (source[offset + 1] == '/') {
+                        offset = scan_to(scan::find(at(offset + 2), at(source.size()), '\n'));
+                        break;
+                    }
+                    if (source[offset + 1] == '*') {
+                        skip_block_comment();
+                        break;
+                    }
+                }
+                return extract_operator();
+            case CharClass::Punct:
+                return extract_punctuator();
+            case CharClass::Other:
+                offset++;
+                break;
         }
     }
+    return make_token(TokenType::END, offset);
+}
 
-    if (offset < line.size()) {
-        std::string one_char_op(1, line[offset]);
-        auto it = operators.find(one_char_op);
-        if (it != operators.end()) {
-            offset++;  
-            return {it->second, one_char_op};  
+// незакрытый комментарий тянется до конца файла
+void Lexer::skip_block_comment() {
+    const char* end = at(source.size());
+    const char* from = at(offset);
+    const char* p = at(offset + 2);
+    while (true) {
+        p = scan::find(p, end, '*');
+        if (p == end || (p + 1 < end && p[1] == '/')) {
+            break;
         }
+        ++p;
     }
-    offset++;  
-    return {TokenType::END, ""};  
+    const char* close = p == end ? end : p + 2;
+
+    // строки внутри комментария учитываются одним подсчётом
+    if (std::size_t newlines = scan::count(from, close, '\n')) {
+        line += newlines;
+        line_start = source.rfind('\n', scan_to(close) - 1) + 1;
+    }
+    offset = scan_to(close);
 }
 
+const char* Lexer::at(std::size_t pos) const {
+    return source.data() + pos;
+}
 
-Token Lexer::extract_punctuator(const std::string& line) {
-    for (const auto& punct : punctuators) {
-        if (line.compare(offset, punct.first.size(), punct.first) == 0) {
-            offset += punct.first.size();
-            return {punct.second, punct.first};
-        }
-    }
+std::size_t Lexer::scan_to(const char* p) const {
+    return static_cast<std::size_t>(p - source.data());
+}
+
+// лексема от start до текущего смещения
+Token Lexer::make_token(TokenType type, std::size_t start) {
+    return Token(type, source.substr(start, offset - start),
+                 line, static_cast<std::uint32_t>(start - line_start + 1));
+}
 
-    offset++;
-    return {TokenType::END, ""};
+void Lexer::error(const std::string& message, std::size_t at) {
+    throw std::runtime_error(filename + ":" + std::to_string(line) + ":" +
+                             std::to_string(at - line_start + 1) + ": " + message);
 }
 
-Token Lexer::extract_keyword(const std::string& line) {
+Token Lexer::extract_literal() {
     std::size_t start = offset;
-    while (offset < line.size() && (std::isalnum(line[offset]) || line[offset] == '_')) {
-        offset++;
+
+    if (is_digit(source[offset])) {
+        offset = scan_to(scan::skip_digits(at(offset), at(source.size())));
+
+        if (offset < source.size() && source[offset] == '.') {
+            offset = scan_to(scan::skip_digits(at(offset + 1), at(source.size())));
+        }
+        return make_token(TokenType::LITERAL_NUM, start);
     }
 
-    std::string value = line.substr(start, offset - start);
-    if (keywords.find(value) != keywords.end()) {
-        return {keywords[value], value};
+    if (source[offset] == '\'') {
+        if (offset + 2 < source.size() && source[offset + 2] == '\'') {
+            offset += 3;
+            return make_token(TokenType::LITERAL_CHAR, start);
+        }
+        error("malformed character literal", start);
     }
 
-    return {TokenType::ID, value};
+    // строковый литерал не переносится на следующую строку
+    std::size_t end = scan_to(scan::find_either(at(offset + 1), at(source.size()), '"', '\n'));
+    if (end == source.size() || source[end] != '"') {
+        error("unterminated string literal", start);
+    }
+    offset = end + 1;
+    return make_token(TokenType::LITERAL_STRING, start);
 }
 
-Token Lexer::extract_type(const std::string& line) {
+Token Lexer::extract_id() {
     std::size_t start = offset;
-    while (offset < line.size() && (std::isalnum(line[offset]) || line[offset] == '_')) {
+    // короткие имена дочитываются по таблице, длинные — через scan
+    std::size_t limit = std::min(source.size(), offset + short_word);
+    while (offset < limit && is_ident_char(source[offset])) {
         offset++;
     }
+    if (offset == limit && limit < source.size()) {
+        offset = scan_to(scan::skip_ident(at(offset), at(source.size())));
+    }
 
-    std::string value = line.substr(start, offset - start);
-    if (types.find(value) != types.end()) {
-        return {TokenType::TYPE, value};
+    std::string_view value = source.substr(start, offset - start);
+    TokenType type = classify_word(value);
+    Token token = make_token(type, start);
+    // идентификаторы и имена типов интернируются здесь, дальше сравниваются номера
+    if (type == TokenType::ID || type == TokenType::TYPE) {
+        token.name = Name(value);
     }
+    return token;
+}
 
-    return {TokenType::ID, value};
+// самое длинное совпадение среди операторов с тем же первым символом
+Token Lexer::extract_operator() {
+    std::size_t start = offset;
+    std::string_view rest = source.substr(offset);
+    const auto& bucket = operator_table[static_cast<unsigned char>(source[offset])];
+    for (std::size_t i = 0; i < bucket.count; ++i) {
+        if (rest.starts_with(bucket.entries[i].text)) {
+            offset += bucket.entries[i].text.size();
+            return make_token(bucket.entries[i].type, start);
+        }
+    }
+    error("unexpected character '" + std::string(1, source[offset]) + "'", start);
+}
+
+
+Token Lexer::extract_punctuator() {
+    std::size_t start = offset;
+    auto c = static_cast<unsigned char>(source[offset]);
+    if (c < punctuator_table.size() && punctuator_table[c] != TokenType::END) {
+        offset++;
+        return make_token(punctuator_table[c], start);
+    }
+    error("unexpected character '" + std::string(1, source[offset]) + "'", start);
 }
 
 
@@ -282,81 +469,3 @@ void Lexer::print_tokens(const std::vector<Token>& tokens) {
         std::cout << token.value << " ---> " << token_type_to_string(token.type) << std::endl;
     }
 }
-
-std::set<std::string> Lexer::types = {"int", "float", "double", "char", "bool", "size_t", "void", "auto"};
-std::unordered_map<std::string, TokenType> Lexer::operators = {
-    {"::",TokenType::SCOPE},
-    {"+", TokenType::PLUS},
-    {"-", TokenType::MINUS},
-    {"*", TokenType::MULTIPLY},
-    {"/", TokenType::DIVIDE},
-    {"%", TokenType::MODULO},
-    {"^^", TokenType::POWER},
-    {"=", TokenType::ASSIGN},
-    {"+=", TokenType::PLUS_ASSIGN},
-    {"-=", TokenType::MINUS_ASSIGN},
-    {"*=", TokenType::MULTIPLY_ASSIGN},
-    {"/=", TokenType::DIVIDE_ASSIGN},
-    {"%=", TokenType::MODULO_ASSIGN},
-    {">>=", TokenType::RIGHT_SHIFT_ASSIGN},
-    {"<<=", TokenType::LEFT_SHIFT_ASSIGN},
-    {"&=", TokenType::AND_ASSIGN},
-    {"^=", TokenType::XOR_ASSIGN},
-    {"|=", TokenType::OR_ASSIGN},
-    {"==", TokenType::EQUAL},
-    {"!=", TokenType::NOT_EQUAL},
-    {">", TokenType::GREATER},
-    {"<", TokenType::LESS},
-    {">=", TokenType::GREATER_EQUAL},
-    {"<=", TokenType::LESS_EQUAL},
-    {"!", TokenType::NOT},
-    {"&&", TokenType::AND},
-    {"||", TokenType::OR},
-    {"?", TokenType::QUESTION},
-    {"&", TokenType::BIT_AND},
-    {"|", TokenType::BIT_OR},
-    {"^", TokenType::BIT_XOR},
-    {"~", TokenType::BIT_NOT},
-    {"<<", TokenType::LEFT_SHIFT},
-    {">>", TokenType::RIGHT_SHIFT},
-    {"++", TokenType::INCREMENT},
-    {"--", TokenType::DECREMENT},
-    {".", TokenType::DOT},
-    {"->", TokenType::ARROW},
-    {":", TokenType::COLON}
-};
-std::unordered_map<std::string, TokenType> Lexer::punctuators = {
-    {",", TokenType::COMMA},
-    {".", TokenType::DOT},
-    {":", TokenType::COLON},
-    {";", TokenType::SEMICOLON},
-    {"{", TokenType::BRACE_LEFT},
-    {"}", TokenType::BRACE_RIGHT},
-    {"(", TokenType::PARENTHESIS_LEFT},
-    {")", TokenType::PARENTHESIS_RIGHT},
-    {"[", TokenType::INDEX_LEFT},
-    {"]", TokenType::INDEX_RIGHT}
-};
-std::unordered_map<std::string, TokenType> Lexer::keywords = {
-    {"if", TokenType::IF},
-    {"else", TokenType::ELSE},
-    {"for", TokenType::FOR},
-    {"while", TokenType::WHILE},
-    {"struct", TokenType::STRUCT},
-    {"break", TokenType::BREAK},
-    {"continue", TokenType::CONTINUE},
-    {"const", TokenType::CONST},
-    {"do", TokenType::DO},
-    {"false", TokenType::FALSE},
-    {"true", TokenType::TRUE},
-    {"return", TokenType::RETURN},
-    {"sizeof", TokenType::SIZEOF},
-    {"static_assert", TokenType::STATICASSERT},
-    {"namespace", TokenType::NAMESPACE},
-    {"const", TokenType::CONST},
-    {"constexpr", TokenType::CONSTEXPR},
-    {"nullptr", TokenType::NULLPTR}
-};
-
-
-    
\ No newline at end of file
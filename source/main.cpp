@@ -1,54 +1,150 @@
-#include <iostream>
-#include <vector>
-#include "lexer.hpp"
-#include "parser.hpp"
-#include "ast.hpp"
-#include "analyzer.hpp"
-#include "printer.hpp"
-#include "executer.hpp"  
-
-int main() {
-    try {
-        Lexer  lexer("example.txt");
-        auto   tokens = lexer.tokenize();
-        //Lexer::print_tokens(tokens);
-        std::cout << "lexer end\n";
-
-        Parser parser(tokens);
-        auto   translation_unit = parser.parse();
-        std::cout << "parser end\n";
-
-        
-        Analyzer analyzer;
-        analyzer.analyze(*translation_unit);
-        std::cout << "analyzer end\n";
-
-        const auto& errors = analyzer.getErrors();
-        if (!errors.empty()) {
-            std::cerr << "Semantic errors found (" << errors.size() << "):\n";
-            for (auto& msg : errors) {
-                std::cerr << "  --> " << msg << "\n";
-            }
-            return 2;  
-        }
-
-        
-        Execute executor;
-        executor.symbolTable = analyzer.getScope();
-        executor.execute(*translation_unit);
-        
-        std::cout << "executer end\n";
-
-       Printer printer;
-        printer.visit(*translation_unit);
-        return 0;
-        
-
-        
- 
-
-    } catch (const std::runtime_error& e) {
-        std::cerr << "Error: " << e.what() << "\n";
-        return 1;
-    }
-}
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <vector>
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "ast.hpp"
+#include "analyzer.hpp"
+#include "constant_folder.hpp"
+#include "printer.hpp"
+#include "executer.hpp"  
+#include "compiler.hpp"
+#include "vm.hpp"
+#include "ast_cache.hpp"
+#include "incremental_parser.hpp"
+
+namespace {
+
+// анализ, свёртка констант, исполнение и печать дерева; код возврата программы.
+// fold == false оставляет дерево нетронутым: --watch переиспользует его узлы в следующем запуске
+int run(TranslationUnit& translation_unit, bool use_vm, bool fold = true) {
+    Analyzer analyzer;
+    analyzer.analyze(translation_unit);
+    std::cout << "analyzer end\n";
+
+    const auto& errors = analyzer.getErrors();
+    if (!errors.empty()) {
+        std::cerr << "Semantic errors found (" << errors.size() << "):\n";
+        for (auto& msg : errors) {
+            std::cerr << "  --> " << msg << "\n";
+        }
+        return 2;
+    }
+
+    ConstantFolder folder(analyzer.constants, analyzer.callees, translation_unit.arena.get());
+    if (fold) {
+        folder.fold(translation_unit);
+    }
+
+    if (use_vm) {
+        Compiler compiler;
+        auto program = compiler.compile(translation_unit);
+        VM vm;
+        vm.run(program);
+    } else {
+        Execute executor;
+        executor.symbolTable = analyzer.getScope();
+        // отложенные парсером тела разбираются и проверяются при первом вызове
+        executor.load_body = [&](FuncDeclaration& function) {
+            Parser::parse_body(function, translation_unit.arena);
+            analyzer.analyze_body(function);
+            folder.fold(function);
+        };
+        executor.execute(translation_unit);
+    }
+
+    std::cout << "executer end\n";
+
+    Printer printer;
+    printer.visit(translation_unit);
+    return 0;
+}
+
+// --watch: файл перечитывается при каждом изменении, заново разбираются
+// только задетые правкой объявления верхнего уровня
+[[noreturn]] void watch(const std::string& path, bool use_vm) {
+    IncrementalParser parser(path);
+    std::filesystem::file_time_type seen;
+    while (true) {
+        std::error_code error;
+        auto stamp = std::filesystem::last_write_time(path, error);
+        if (error || stamp == seen) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            continue;
+        }
+        seen = stamp;
+
+        std::ifstream file(path, std::ios::binary);
+        std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        try {
+            parser.update(text);
+            std::cout << "parser end (" << parser.reparsed() << " reparsed)\n";
+            run(*parser.unit(), use_vm, false);
+        } catch (const std::runtime_error& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+        }
+        std::cout.flush();
+    }
+}
+
+}
+
+// program [--vm] [--no-cache] [--watch] [--lazy] [файл]: по умолчанию дерево исполняется Execute, --vm включает байткод,
+// --no-cache разбирает файл заново, не читая и не пополняя кэш деревьев,
+// --watch запускает файл заново после каждого его сохранения,
+// --lazy разбирает и проверяет тело функции при её первом вызове (без --vm: компилятору нужны все тела)
+int main(int argc, char* argv[]) {
+    bool use_vm = false;
+    bool use_cache = true;
+    bool use_watch = false;
+    bool use_lazy = false;
+    std::string path = "example.txt";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--vm") {
+            use_vm = true;
+        } else if (arg == "--no-cache") {
+            use_cache = false;
+        } else if (arg == "--watch") {
+            use_watch = true;
+        } else if (arg == "--lazy") {
+            use_lazy = true;
+        } else {
+            path = arg;
+        }
+    }
+
+    if (use_watch) {
+        watch(path, use_vm);
+    }
+
+    try {
+        // лексер работает по требованию парсера; ошибки лексики приходят уже из parse()
+        Lexer  lexer(path);
+        AstCache cache(use_cache ? AstCache::default_directory() : std::filesystem::path());
+
+        // при попадании в кэш лексер и парсер не запускаются
+        auto translation_unit = cache.load(lexer.text());
+        if (translation_unit) {
+            std::cout << "lexer end\n";
+            std::cout << "parser end\n";
+        } else {
+            std::cout << "lexer end\n";
+
+            Parser parser(lexer, use_lazy && !use_vm);
+            translation_unit = parser.parse();
+            std::cout << "parser end\n";
+
+            cache.store(lexer.text(), *translation_unit);
+        }
+
+        return run(*translation_unit, use_vm);
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
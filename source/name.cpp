@@ -0,0 +1,21 @@
+#include "name.hpp"
+
+Interner& Interner::global() {
+    static Interner table;
+    return table;
+}
+
+Interner::Interner() {
+    intern("");
+}
+
+std::uint32_t Interner::intern(std::string_view text) {
+    auto it = ids.find(text);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    auto id = static_cast<std::uint32_t>(strings.size());
+    const std::string& stored = strings.emplace_back(text);
+    ids.emplace(stored, id);
+    return id;
+}
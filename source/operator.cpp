@@ -0,0 +1,94 @@
+#include "operator.hpp"
+#include <stdexcept>
+
+Operator binary_operator(std::string_view lexeme) {
+    if (lexeme == "=")  return Operator::Assign;
+    if (lexeme == "+=") return Operator::AddAssign;
+    if (lexeme == "-=") return Operator::SubAssign;
+    if (lexeme == "*=") return Operator::MulAssign;
+    if (lexeme == "/=") return Operator::DivAssign;
+    if (lexeme == "%=") return Operator::ModAssign;
+    if (lexeme == "+")  return Operator::Add;
+    if (lexeme == "-")  return Operator::Sub;
+    if (lexeme == "*")  return Operator::Mul;
+    if (lexeme == "/")  return Operator::Div;
+    if (lexeme == "%")  return Operator::Mod;
+    if (lexeme == "<<") return Operator::ShiftLeft;
+    if (lexeme == ">>") return Operator::ShiftRight;
+    if (lexeme == "&")  return Operator::BitAnd;
+    if (lexeme == "|")  return Operator::BitOr;
+    if (lexeme == "^")  return Operator::BitXor;
+    if (lexeme == "^^") return Operator::Power;
+    if (lexeme == "==") return Operator::Equal;
+    if (lexeme == "!=") return Operator::NotEqual;
+    if (lexeme == "<")  return Operator::Less;
+    if (lexeme == ">")  return Operator::Greater;
+    if (lexeme == "<=") return Operator::LessEqual;
+    if (lexeme == ">=") return Operator::GreaterEqual;
+    if (lexeme == "&&") return Operator::And;
+    if (lexeme == "||") return Operator::Or;
+    if (lexeme == ",")  return Operator::Comma;
+    throw std::runtime_error("unknown binary operator: " + std::string(lexeme));
+}
+
+Operator prefix_operator(std::string_view lexeme) {
+    if (lexeme == "++") return Operator::Increment;
+    if (lexeme == "--") return Operator::Decrement;
+    if (lexeme == "*")  return Operator::Dereference;
+    if (lexeme == "&")  return Operator::AddressOf;
+    if (lexeme == "+")  return Operator::Plus;
+    if (lexeme == "-")  return Operator::Minus;
+    if (lexeme == "!")  return Operator::Not;
+    throw std::runtime_error("unknown prefix operator: " + std::string(lexeme));
+}
+
+std::string spelling(Operator op) {
+    switch (op) {
+        case Operator::Assign:       return "=";
+        case Operator::AddAssign:    return "+=";
+        case Operator::SubAssign:    return "-=";
+        case Operator::MulAssign:    return "*=";
+        case Operator::DivAssign:    return "/=";
+        case Operator::ModAssign:    return "%=";
+        case Operator::Add:          return "+";
+        case Operator::Sub:          return "-";
+        case Operator::Mul:          return "*";
+        case Operator::Div:          return "/";
+        case Operator::Mod:          return "%";
+        case Operator::ShiftLeft:    return "<<";
+        case Operator::ShiftRight:   return ">>";
+        case Operator::BitAnd:       return "&";
+        case Operator::BitOr:        return "|";
+        case Operator::BitXor:       return "^";
+        case Operator::Power:        return "^^";
+        case Operator::Equal:        return "==";
+        case Operator::NotEqual:     return "!=";
+        case Operator::Less:         return "<";
+        case Operator::Greater:      return ">";
+        case Operator::LessEqual:    return "<=";
+        case Operator::GreaterEqual: return ">=";
+        case Operator::And:          return "&&";
+        case Operator::Or:           return "||";
+        case Operator::Comma:        return ",";
+        case Operator::Increment:    return "++";
+        case Operator::Decrement:    return "--";
+        case Operator::Dereference:  return "*";
+        case Operator::AddressOf:    return "&";
+        case Operator::Plus:         return "+";
+        case Operator::Minus:        return "-";
+        case Operator::Not:          return "!";
+    }
+    return "?";
+}
+
+Operator compound_operation(Operator op) {
+    switch (op) {
+        case Operator::AddAssign: return Operator::Add;
+        case Operator::SubAssign: return Operator::Sub;
+        case Operator::MulAssign: return Operator::Mul;
+        case Operator::DivAssign: return Operator::Div;
+        case Operator::ModAssign: return Operator::Mod;
+        default:
+            throw std::runtime_error("unsupported compound assignment: " + spelling(op));
+    }
+}
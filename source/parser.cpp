@@ -1,31 +1,232 @@
 #include <string>
 #include <vector>
 #include <memory> 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <utility>
 
 #include "parser.hpp"
 
-Parser::Parser(
-    const std::vector<Token>& tokens
-    ) : tokens(tokens), offset(0) {}
+Parser::Parser(Lexer& lexer, bool lazy_bodies)
+    : lexer(&lexer), tokens(lexer), arena(std::make_unique<Arena>()), lazy_bodies(lazy_bodies) {}
+
+Parser::Parser(std::span<const Token> tokens, const Token& end)
+    : tokens(tokens, end), arena(std::make_unique<Arena>()) {}
+
+
+namespace {
+
+// Уровни приоритета бинарных операторов, от слабого к сильному; None — лексема не оператор.
+enum Precedence : int {
+    None,
+    Assignment,     // = += -= *= /= %=    справа налево
+    Conditional,    // ?:
+    LogicalOr,
+    LogicalAnd,
+    BitwiseOr,
+    BitwiseXor,
+    BitwiseAnd,
+    Equality,
+    Relational,
+    Shift,
+    Additive,
+    Multiplicative,
+    Power           // ^^                  справа налево
+};
+
+struct BinaryRule {
+    int precedence = Precedence::None;
+    bool right_associative = false;
+    Operator op = Operator::Comma;
+};
+
+constexpr std::size_t token_type_count = static_cast<std::size_t>(TokenType::END) + 1;
+
+constexpr std::array<BinaryRule, token_type_count> make_binary_rules() {
+    std::array<BinaryRule, token_type_count> rules{};
+    auto set = [&rules](TokenType type, int precedence, Operator op, bool right_associative = false) {
+        rules[static_cast<std::size_t>(type)] = {precedence, right_associative, op};
+    };
+
+    set(TokenType::ASSIGN,          Assignment, Operator::Assign,    true);
+    set(TokenType::PLUS_ASSIGN,     Assignment, Operator::AddAssign, true);
+    set(TokenType::MINUS_ASSIGN,    Assignment, Operator::SubAssign, true);
+    set(TokenType::MULTIPLY_ASSIGN, Assignment, Operator::MulAssign, true);
+    set(TokenType::DIVIDE_ASSIGN,   Assignment, Operator::DivAssign, true);
+    set(TokenType::MODULO_ASSIGN,   Assignment, Operator::ModAssign, true);
+
+    set(TokenType::QUESTION,        Conditional, Operator::Comma,    true);   // разбирается отдельно
+
+    set(TokenType::OR,              LogicalOr,  Operator::Or);
+    set(TokenType::AND,             LogicalAnd, Operator::And);
+    set(TokenType::BIT_OR,          BitwiseOr,  Operator::BitOr);
+    set(TokenType::BIT_XOR,         BitwiseXor, Operator::BitXor);
+    set(TokenType::BIT_AND,         BitwiseAnd, Operator::BitAnd);
+
+    set(TokenType::EQUAL,           Equality,   Operator::Equal);
+    set(TokenType::NOT_EQUAL,       Equality,   Operator::NotEqual);
+    set(TokenType::LESS,            Relational, Operator::Less);
+    set(TokenType::GREATER,         Relational, Operator::Greater);
+    set(TokenType::LESS_EQUAL,      Relational, Operator::LessEqual);
+    set(TokenType::GREATER_EQUAL,   Relational, Operator::GreaterEqual);
+
+    set(TokenType::LEFT_SHIFT,      Shift,      Operator::ShiftLeft);
+    set(TokenType::RIGHT_SHIFT,     Shift,      Operator::ShiftRight);
+
+    set(TokenType::PLUS,            Additive,   Operator::Add);
+    set(TokenType::MINUS,           Additive,   Operator::Sub);
+
+    set(TokenType::MULTIPLY,        Multiplicative, Operator::Mul);
+    set(TokenType::DIVIDE,          Multiplicative, Operator::Div);
+    set(TokenType::MODULO,          Multiplicative, Operator::Mod);
+
+    set(TokenType::POWER,           Power,      Operator::Power, true);
+    return rules;
+}
+
+constexpr auto binary_rules = make_binary_rules();
+
+const BinaryRule& binary_rule(TokenType type) {
+    return binary_rules[static_cast<std::size_t>(type)];
+}
+
+// меньше этого кусок не делится: разбор крошечных кусков не окупает потока
+constexpr std::size_t min_chunk_tokens = 4096;
+
+// Номера лексем, с которых начинается объявление или оператор верхнего уровня:
+// после «;» или «}» вне всех скобок. Перед else, while и «;» не режем —
+// там продолжается if, do-while или объявление структуры.
+std::vector<std::size_t> top_level_boundaries(const std::vector<Token>& tokens) {
+    std::vector<std::size_t> cuts;
+    long depth = 0;
+    for (std::size_t i = 0; i + 1 < tokens.size(); ++i) {
+        switch (tokens[i].type) {
+            case TokenType::BRACE_LEFT:
+            case TokenType::PARENTHESIS_LEFT:
+            case TokenType::INDEX_LEFT:
+                ++depth;
+                continue;
+            case TokenType::PARENTHESIS_RIGHT:
+            case TokenType::INDEX_RIGHT:
+                --depth;
+                continue;
+            case TokenType::BRACE_RIGHT:
+                --depth;
+                break;
+            case TokenType::SEMICOLON:
+                break;
+            default:
+                continue;
+        }
+        TokenType following = tokens[i + 1].type;
+        if (depth == 0 && following != TokenType::ELSE && following != TokenType::WHILE &&
+            following != TokenType::SEMICOLON && following != TokenType::END) {
+            cuts.push_back(i + 1);
+        }
+    }
+    return cuts;
+}
+
+}
 
 
-std::shared_ptr<TranslationUnit> Parser::parse() {
-    std::vector<std::shared_ptr<ASTNode>> ast_nodes;
+std::unique_ptr<TranslationUnit> Parser::parse() {
+    unsigned threads = std::thread::hardware_concurrency();
+    if (lexer && lexer->size() >= parallel_threshold && threads > 1) {
+        return parse_parallel(threads);
+    }
+
+    auto nodes = arena->copy(parse_top_level());
+    return std::make_unique<TranslationUnit>(nodes, std::move(arena));
+}
+
+std::vector<ASTNode*> Parser::parse_top_level(std::vector<std::size_t>* ends) {
+    std::vector<ASTNode*> ast_nodes;
     
     while (!match_token(TokenType::END)) {
         if (is_type_specifier()) {
+            at_top_level = true;
             ast_nodes.push_back(parse_declaration());
         } else {
             ast_nodes.push_back(parse_statement());
         }
+        if (ends) {
+            ends->push_back(tokens.consumed());
+        }
     }
-    
-    return std::make_shared<TranslationUnit>(ast_nodes);
+    return ast_nodes;
+}
+
+// Файл лексируется целиком, проход по скобкам делит его на куски из целых объявлений,
+// куски разбираются в потоках, каждый в свою арену, и склеиваются по порядку.
+std::unique_ptr<TranslationUnit> Parser::parse_parallel(unsigned threads) {
+    auto all = lexer->tokenize();
+    auto cuts = top_level_boundaries(all);
+
+    // несколько кусков на поток, чтобы потоки не ждали самого длинного
+    std::size_t target = std::max<std::size_t>(all.size() / (threads * 4), min_chunk_tokens);
+    std::vector<std::size_t> chunks{0};
+    for (std::size_t cut : cuts) {
+        if (cut - chunks.back() >= target) {
+            chunks.push_back(cut);
+        }
+    }
+    std::size_t last = all.size() - 1;    // END
+    if (chunks.back() != last) {
+        chunks.push_back(last);
+    }
+    std::size_t count = chunks.size() - 1;
+
+    std::vector<std::vector<ASTNode*>> parts(count);
+    std::vector<std::unique_ptr<Arena>> arenas(count);
+    std::vector<std::exception_ptr> errors(count);
+    std::atomic<std::size_t> next{0};
+
+    auto work = [&] {
+        for (std::size_t i; (i = next++) < count; ) {
+            try {
+                std::span<const Token> chunk(all.data() + chunks[i], chunks[i + 1] - chunks[i]);
+                const Token& after = all[chunks[i + 1]];
+                Parser part(chunk, Token(TokenType::END, "", after.line, after.column));
+                part.lazy_bodies = lazy_bodies;
+                parts[i] = part.parse_top_level();
+                arenas[i] = std::move(part.arena);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+    {
+        std::vector<std::jthread> pool;
+        for (unsigned t = 1; t < std::min<std::size_t>(threads, count); ++t) {
+            pool.emplace_back(work);
+        }
+        work();
+    }
+
+    // первая по тексту ошибка — та же, что дал бы последовательный разбор
+    for (auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::vector<ASTNode*> ast_nodes;
+    for (std::size_t i = 0; i < count; ++i) {
+        ast_nodes.insert(ast_nodes.end(), parts[i].begin(), parts[i].end());
+        arena->adopt(std::move(arenas[i]));
+    }
+    auto nodes = arena->copy(ast_nodes);
+    return std::make_unique<TranslationUnit>(nodes, std::move(arena));
 }
  
 
 bool Parser::is_type_specifier() {
     if (check_token(TokenType::CONST))     return true;
+    if (check_token(TokenType::CONSTEXPR)) return true;
     if (check_token(TokenType::NAMESPACE)) return true;
     if (check_token(TokenType::TYPE)      ||
         check_token(TokenType::STRUCT))   return true;
@@ -35,108 +236,79 @@ bool Parser::is_type_specifier() {
      return false;
  }
 
+// [constexpr] [const] тип *... имя разбирается один раз, вид объявления решает следующая лексема:
+// «(» — функция, «[» — массив, иначе — переменные
 declaration Parser::parse_declaration() {
+    // откладываются только тела функций верхнего уровня, не методов и не функций пространств имён
+    bool top_level = std::exchange(at_top_level, false);
     if (match_token(TokenType::NAMESPACE)) {
         return parse_namespace_declaration();
     }
-    else if (
-        // ⟨TYPE ID (⟩
-        match_pattern(TokenType::TYPE, TokenType::ID, TokenType::PARENTHESIS_LEFT) ||
-        // ⟨TYPE * ID (⟩
-        match_pattern(TokenType::TYPE, TokenType::MULTIPLY, TokenType::ID, TokenType::PARENTHESIS_LEFT) ||
-        // ⟨TYPE ** ID (⟩
-        match_pattern(TokenType::TYPE, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::ID, TokenType::PARENTHESIS_LEFT) ||
-        // ⟨TYPE *** ID (⟩
-        match_pattern(TokenType::TYPE, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::ID, TokenType::PARENTHESIS_LEFT) ||
-        // ⟨TYPE **** ID (⟩
-        match_pattern(TokenType::TYPE, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::ID, TokenType::PARENTHESIS_LEFT) ||
-
-        // ⟨CONST TYPE ID (⟩
-        match_pattern(TokenType::CONST, TokenType::TYPE, TokenType::ID, TokenType::PARENTHESIS_LEFT) ||
-        // ⟨CONST TYPE * ID (⟩
-        match_pattern(TokenType::CONST, TokenType::TYPE, TokenType::MULTIPLY, TokenType::ID, TokenType::PARENTHESIS_LEFT) ||
-        // ⟨CONST TYPE ** ID (⟩
-        match_pattern(TokenType::CONST, TokenType::TYPE, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::ID, TokenType::PARENTHESIS_LEFT) ||
-        // ⟨CONST TYPE *** ID (⟩
-        match_pattern(TokenType::CONST, TokenType::TYPE, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::ID, TokenType::PARENTHESIS_LEFT) ||
-        // ⟨CONST TYPE **** ID (⟩
-        match_pattern(TokenType::CONST, TokenType::TYPE, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::ID, TokenType::PARENTHESIS_LEFT)
-    ) {
-        return parse_function_declaration();
-    }
-    else if (
-        // ⟨TYPE ID [⟩
-        match_pattern(TokenType::TYPE, TokenType::ID, TokenType::INDEX_LEFT) ||
-        // ⟨TYPE * ID [⟩
-        match_pattern(TokenType::TYPE, TokenType::MULTIPLY, TokenType::ID, TokenType::INDEX_LEFT) ||
-        // ⟨TYPE ** ID [⟩
-        match_pattern(TokenType::TYPE, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::ID, TokenType::INDEX_LEFT) ||
-        // ⟨TYPE *** ID [⟩
-        match_pattern(TokenType::TYPE, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::ID, TokenType::INDEX_LEFT) ||
-        // ⟨TYPE **** ID [⟩
-        match_pattern(TokenType::TYPE, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::ID, TokenType::INDEX_LEFT)
-    ) {
-        return parse_array_declaration();
-    }
-    else if (
-        // ⟨TYPE ID⟩
-        match_pattern(TokenType::TYPE, TokenType::ID) ||
-        // ⟨TYPE * ID⟩
-        match_pattern(TokenType::TYPE, TokenType::MULTIPLY, TokenType::ID) ||
-        // ⟨TYPE ** ID⟩
-        match_pattern(TokenType::TYPE, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::ID) ||
-        // ⟨TYPE *** ID⟩
-        match_pattern(TokenType::TYPE, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::ID) ||
-        // ⟨TYPE **** ID⟩
-        match_pattern(TokenType::TYPE, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::ID) ||
-
-        // ⟨CONST TYPE ID⟩
-        match_pattern(TokenType::CONST, TokenType::TYPE, TokenType::ID) ||
-        // ⟨CONST TYPE * ID⟩
-        match_pattern(TokenType::CONST, TokenType::TYPE, TokenType::MULTIPLY, TokenType::ID) ||
-        // ⟨CONST TYPE ** ID⟩
-        match_pattern(TokenType::CONST, TokenType::TYPE, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::ID) ||
-        // ⟨CONST TYPE *** ID⟩
-        match_pattern(TokenType::CONST, TokenType::TYPE, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::ID) ||
-        // ⟨CONST TYPE **** ID⟩
-        match_pattern(TokenType::CONST, TokenType::TYPE, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::MULTIPLY, TokenType::ID) ||
-
-        match_pattern(TokenType::ID, TokenType::ID)
-    ) {
-        return parse_var_declaration();
-    }
-    else if (match_pattern(TokenType::STRUCT, TokenType::ID)) {
+    if (check_token(TokenType::STRUCT)) {
         return parse_struct_declaration();
     }
-    else {
-        throw std::runtime_error("Declaration : Unexpected token " + tokens[offset].value);
+
+    bool is_constexpr = match_token(TokenType::CONSTEXPR);
+    bool is_const = match_token(TokenType::CONST);
+    // тип-идентификатор — имя структуры; такие объявления бывают только переменными
+    bool is_record = check_token(TokenType::ID);
+    if (!check_token(TokenType::TYPE, TokenType::ID)) {
+        throw std::runtime_error("Declaration : Unexpected token " + std::string(tokens.peek().value) + " at " + tokens.peek().position());
     }
+    Name type = extract_name(TokenType::TYPE, TokenType::ID);
+
+    std::size_t pointer_level = 0;
+    while (match_token(TokenType::MULTIPLY)) {
+        ++pointer_level;
+    }
+    if (!check_token(TokenType::ID)) {
+        throw std::runtime_error("Declaration : Unexpected token " + std::string(tokens.peek().value) + " at " + tokens.peek().position());
+    }
+    Name name = extract_name(TokenType::ID);
+
+    if (!is_record && check_token(TokenType::PARENTHESIS_LEFT)) {
+        // вызовы constexpr-функции вычисляет Analyzer, поэтому её тело не откладывается
+        auto function = parse_function_declaration(is_const, type, make_declarator(name, pointer_level),
+                                                   top_level && lazy_bodies && !is_constexpr);
+        function->is_constexpr = is_constexpr;
+        return function;
+    }
+    if (is_constexpr) {
+        throw std::runtime_error("Declaration : constexpr is supported only for functions at " + tokens.peek().position());
+    }
+    if (!is_record && !is_const && check_token(TokenType::INDEX_LEFT)) {
+        if (pointer_level > 0) {
+            throw std::runtime_error("Declaration : arrays of pointers are not supported at " + tokens.peek().position());
+        }
+        return parse_array_declaration(type, name);
+    }
+    return parse_var_declaration(is_const, type, make_declarator(name, pointer_level));
 }
 
 
 name_space_declaration Parser::parse_namespace_declaration() {
 
-    auto name = extract_token(TokenType::ID);
+    auto name = extract_name(TokenType::ID);
     extract_token(TokenType::BRACE_LEFT);
 
-    std::vector<std::shared_ptr<Declaration>> decls;
+    std::vector<Declaration*> decls;
 
     while (!match_token(TokenType::BRACE_RIGHT)) {
         decls.push_back(parse_declaration());
     }
 
-    return std::make_shared<NameSpaceDeclaration>(name, decls);
+    return arena->make<NameSpaceDeclaration>(name, arena->copy(decls));
 }
 
 
 struct_declaration Parser::parse_struct_declaration() {
     extract_token(TokenType::STRUCT);
 
-    std::string struct_name = tokens[offset].value;
+    Name struct_name = tokens.peek().name;
     extract_token(TokenType::ID);
     
 
-    std::vector<std::shared_ptr<Declaration>> members;
+    std::vector<Declaration*> members;
 
  
     extract_token(TokenType::BRACE_LEFT);  
@@ -149,34 +321,24 @@ struct_declaration Parser::parse_struct_declaration() {
     extract_token(TokenType::BRACE_RIGHT);  
     extract_token(TokenType::SEMICOLON); // bespolezen
  
-    return std::make_shared<StructDeclaration>(struct_name, members);
+    return arena->make<StructDeclaration>(struct_name, arena->copy(members));
 }
 
 
-func_declaration Parser::parse_function_declaration() {
-    bool is_const = false;
-    if(match_token(TokenType::CONST)){
-        is_const = true;
-    }
-
-
-    auto type = extract_token(TokenType::TYPE);
-    auto declarator = parse_declarator();
-
-    
+func_declaration Parser::parse_function_declaration(bool is_const, Name type, declarator declarator, bool defer_body) {
     extract_token(TokenType::PARENTHESIS_LEFT);
     
 
-    std::vector<std::shared_ptr<ParameterDeclaration>> args;
+    std::vector<ParameterDeclaration*> args;
     if (!match_token(TokenType::PARENTHESIS_RIGHT)) {
         while (true) {
             args.push_back(parse_parameter_declaration());
             
 
-            if (tokens[offset].value == ",") {
-                ++offset;
-            } else if (tokens[offset].value == ")") {
-                ++offset;
+            if (tokens.peek().value == ",") {
+                tokens.advance();
+            } else if (tokens.peek().value == ")") {
+                tokens.advance();
                 break;
             } else {
                 throw std::runtime_error("Missing closing parenthesis");
@@ -191,31 +353,72 @@ func_declaration Parser::parse_function_declaration() {
     }
 
 
-    std::shared_ptr<CompoundStatement> body;
+    CompoundStatement* body = nullptr;
+    std::span<const Token> deferred;
     if (match_token(TokenType::BRACE_LEFT)) {
-        body = parse_compound_statement();
+        // тип auto выводится из тела, такое тело нужно сразу
+        if (defer_body && type != known::auto_type) {
+            deferred = skip_body();
+        } else {
+            body = parse_compound_statement();
+        }
     } else if (!match_token(TokenType::SEMICOLON)) {
         throw std::runtime_error("Unexpected token");
     }
-    return std::make_shared<FuncDeclaration>(is_const, type, declarator, is_readonly, args, body);
+    auto function = arena->make<FuncDeclaration>(is_const, type, declarator, is_readonly, arena->copy(args), body);
+    function->deferred_body = deferred;
+    return function;
 }
 
+// лексемы тела после «{» до парной «}» включительно, без разбора
+std::span<const Token> Parser::skip_body() {
+    std::vector<Token> body;
+    for (int depth = 1; depth > 0; ) {
+        const Token& token = tokens.peek();
+        if (token.type == TokenType::END) {
+            throw std::runtime_error("missing } at " + token.position());
+        }
+        if (token.type == TokenType::BRACE_LEFT) {
+            ++depth;
+        } else if (token.type == TokenType::BRACE_RIGHT) {
+            --depth;
+        }
+        body.push_back(tokens.consume());
+    }
+    return arena->copy(body);
+}
+
+void Parser::parse_body(FuncDeclaration& function, std::unique_ptr<Arena>& arena) {
+    if (function.body || function.deferred_body.empty()) {
+        return;
+    }
+    const Token& close = function.deferred_body.back();
+    Parser part(function.deferred_body, Token(TokenType::END, "", close.line, close.column));
+    // узлы тела — в арену дерева, без отдельного блока на каждую функцию
+    part.arena.swap(arena);
+    try {
+        function.body = part.parse_compound_statement();
+    } catch (...) {
+        part.arena.swap(arena);
+        throw;
+    }
+    part.arena.swap(arena);
+    function.deferred_body = {};
+}
 
-array_declaration Parser::parse_array_declaration() {
-    auto type = extract_token(TokenType::TYPE);
-    auto name = extract_token(TokenType::ID);
 
+array_declaration Parser::parse_array_declaration(Name type, Name name) {
     extract_token(TokenType::INDEX_LEFT);
 
    
-    std::shared_ptr<Expression> size = nullptr;
+    Expression* size = nullptr;
     if (!match_token(TokenType::INDEX_RIGHT)) {
         size = parse_expression();
         extract_token(TokenType::INDEX_RIGHT);
     }
 
     
-    std::vector<std::shared_ptr<Expression>> init_list;
+    std::vector<Expression*> init_list;
     if (match_token(TokenType::ASSIGN)) {
         extract_token(TokenType::BRACE_LEFT);
 
@@ -228,48 +431,26 @@ array_declaration Parser::parse_array_declaration() {
     }
 
     extract_token(TokenType::SEMICOLON);
-    return std::make_shared<ArrayDeclaration>(type, name, size, init_list);
+    return arena->make<ArrayDeclaration>(type, name, size, arena->copy(init_list));
 }
 
 parameter_declaration Parser::parse_parameter_declaration() {
-    auto type = extract_token(TokenType::TYPE);
+    auto type = extract_name(TokenType::TYPE);
     auto declarator = parse_init_declarator();
 
 
-    return std::make_shared<ParameterDeclaration>(type, declarator);
+    return arena->make<ParameterDeclaration>(type, declarator);
 }
 
 
-var_declaration Parser::parse_var_declaration() {
-    bool is_const = false;
-    if (match_token(TokenType::CONST)) {
-        is_const = true;
-    }
-
-    
-    bool is_auto = false;
-    std::string type;
-    if (check_token(TokenType::TYPE) && tokens[offset].value == "auto") {
-        is_auto = true;
-        type    = extract_token(TokenType::TYPE);   // вытянем "auto"
-    }
-    else if (check_token(TokenType::TYPE)) {
-        type = extract_token(TokenType::TYPE);      // "int", "float" и т.п.
-    }
-    else if (check_token(TokenType::ID)) {
-        type = extract_token(TokenType::ID);        // имя структуры/класса
-    }
-    else {
-        throw std::runtime_error("Var : expected 'auto', type or identifier, but got " 
-                                 + tokens[offset].value);
-    }
-
-    std::vector<std::shared_ptr<Declaration::InitDeclarator>> declarator_list;
+var_declaration Parser::parse_var_declaration(bool is_const, Name type, declarator first) {
+    bool is_auto = type == known::auto_type;
+    std::vector<Declaration::InitDeclarator*> declarator_list;
 
 
     while (true) {
-        
-        auto init_decl = parse_init_declarator();
+        auto init_decl = parse_init_declarator(first);
+        first = nullptr;
         if (is_auto && !init_decl->initializer) {
             throw std::runtime_error("auto declaration requires initializer");
         }
@@ -280,42 +461,45 @@ var_declaration Parser::parse_var_declaration() {
         } else if (match_token(TokenType::SEMICOLON)) {
             break;
         } else {
-            throw std::runtime_error("Var : Unexpected token " + tokens[offset].value);
+            throw std::runtime_error("Var : Unexpected token " + std::string(tokens.peek().value) + " at " + tokens.peek().position());
         }
     }
 
-    return std::make_shared<VarDeclaration>(is_const, type, declarator_list);
+    return arena->make<VarDeclaration>(is_const, type, arena->copy(declarator_list));
 }
 
 
-init_declarator Parser::parse_init_declarator() {
-
-    auto declarator = parse_declarator();
-    std::shared_ptr<Expression> initializer;
+init_declarator Parser::parse_init_declarator(declarator declarator) {
+    if (!declarator) {
+        declarator = parse_declarator();
+    }
+    Expression* initializer = nullptr;
 
     if (match_token(TokenType::ASSIGN)) {
         initializer = parse_expression();
     }
 
-    return std::make_shared<Declaration::InitDeclarator>(declarator, initializer);
+    return arena->make<Declaration::InitDeclarator>(declarator, initializer);
 }
 
 declarator Parser::parse_declarator() {
-    int pointer_level = 0;
-    while (check_token(TokenType::MULTIPLY)) {
-        extract_token(TokenType::MULTIPLY);
+    std::size_t pointer_level = 0;
+    while (match_token(TokenType::MULTIPLY)) {
         pointer_level++;
     }
     if (check_token(TokenType::ID)) {
-        auto name = extract_token(TokenType::ID);
-        std::shared_ptr<Declaration::Declarator> decl = std::make_shared<Declaration::SimpleDeclarator>(name);
-        for (int i = 0; i < pointer_level; ++i) {
-            decl = std::make_shared<Declaration::PtrDeclarator>(decl);
-        }
-        return decl;
+        return make_declarator(extract_name(TokenType::ID), pointer_level);
     } else {
-        throw std::runtime_error("Declarator : Unexpected token " + tokens[offset].value);
+        throw std::runtime_error("Declarator : Unexpected token " + std::string(tokens.peek().value) + " at " + tokens.peek().position());
+    }
+}
+
+declarator Parser::make_declarator(Name name, std::size_t pointer_level) {
+    Declaration::Declarator* decl = arena->make<Declaration::SimpleDeclarator>(name);
+    for (std::size_t i = 0; i < pointer_level; ++i) {
+        decl = arena->make<Declaration::PtrDeclarator>(decl);
     }
+    return decl;
 }
 
 //block nazvatb
@@ -337,14 +521,14 @@ statement Parser::parse_statement() {
     }
 }
 compound_statement Parser::parse_compound_statement() { 
-    std::vector<std::shared_ptr<Statement>> statements;
+    std::vector<Statement*> statements;
     while (!match_token(TokenType::BRACE_RIGHT)) {
-        statements.push_back(parse_statement());
-        if(offset >= tokens.size()){
-            throw std::runtime_error("missing }");
+        if (check_token(TokenType::END)) {
+            throw std::runtime_error("missing } at " + tokens.peek().position());
         }
+        statements.push_back(parse_statement());
     }
-    return std::make_shared<CompoundStatement>(statements);
+    return arena->make<CompoundStatement>(arena->copy(statements));
 }
 
 conditional_statement Parser::parse_conditional_statement() {
@@ -354,12 +538,12 @@ conditional_statement Parser::parse_conditional_statement() {
     auto if_statement = parse_statement();    
     auto if_branch = std::make_pair(if_condition, if_statement);
 
-    std::shared_ptr<Statement> else_branch;
+    Statement* else_branch = nullptr;
     if (match_token(TokenType::ELSE)) {      
         else_branch = parse_statement();
     }
 
-    return std::make_shared<ConditionalStatement>(if_branch, else_branch);
+    return arena->make<ConditionalStatement>(if_branch, else_branch);
 }
 
 loop_statement Parser::parse_loop_statement() { //do-while
@@ -372,7 +556,7 @@ loop_statement Parser::parse_loop_statement() { //do-while
     } 
     else {
 
-        throw std::runtime_error("Unexpected token in loop statement:" + tokens[offset].value);
+        throw std::runtime_error("Unexpected token in loop statement:" + std::string(tokens.peek().value) + " at " + tokens.peek().position());
     }
 }
 
@@ -383,7 +567,7 @@ do_while_statement Parser::parse_do_while_statement(){
     auto condition = parse_expression();
     extract_token(TokenType::PARENTHESIS_RIGHT);
     extract_token(TokenType::SEMICOLON);
-    return std::make_shared<DoWhileStatement>(statement, condition);
+    return arena->make<DoWhileStatement>(statement, condition);
 }
 
 
@@ -392,14 +576,14 @@ while_statement Parser::parse_while_statement() {
     auto condition = parse_expression();
     extract_token(TokenType::PARENTHESIS_RIGHT);
     auto statement = parse_statement();
-    return std::make_shared<WhileStatement>(condition, statement);
+    return arena->make<WhileStatement>(condition, statement);
 }
 
 for_statement Parser::parse_for_statement() {
     extract_token(TokenType::PARENTHESIS_LEFT); 
   
 
-    std::shared_ptr<ASTNode> initialization;
+    ASTNode* initialization = nullptr;
     if (!check_token(TokenType::SEMICOLON)) {  
         if (check_token(TokenType::TYPE)) {  
             initialization = parse_declaration(); 
@@ -411,14 +595,14 @@ for_statement Parser::parse_for_statement() {
     }
    
 
-    std::shared_ptr<Expression> condition;
+    Expression* condition = nullptr;
     if (!check_token(TokenType::SEMICOLON)) {  
         condition = parse_expression();  
     }
     extract_token(TokenType::SEMICOLON);  
  
 
-    std::shared_ptr<Expression> increment;
+    Expression* increment = nullptr;
     if (!check_token(TokenType::PARENTHESIS_RIGHT)) {  
         increment = parse_expression();  
     }
@@ -428,7 +612,7 @@ for_statement Parser::parse_for_statement() {
     auto body = parse_statement();  
 
 
-    return std::make_shared<ForStatement>(initialization, condition, increment, body);
+    return arena->make<ForStatement>(initialization, condition, increment, body);
 }
 
 
@@ -446,34 +630,34 @@ jump_statement Parser::parse_jump_statement() {
 
 break_statement Parser::parse_break_statement() {
     extract_token(TokenType::SEMICOLON);
-    return std::make_shared<BreakStatement>();
+    return arena->make<BreakStatement>();
 }
 
 continue_statement Parser::parse_continue_statement() {
     extract_token(TokenType::SEMICOLON);
-    return std::make_shared<ContinueStatement>();
+    return arena->make<ContinueStatement>();
 }
 
 return_statement Parser::parse_return_statement() { 
-    std::shared_ptr<Expression> expression;
+    Expression* expression = nullptr;
     if (!check_token(TokenType::SEMICOLON)) {
         expression = parse_expression();
     }
 
     extract_token(TokenType::SEMICOLON);
 
-    return std::make_shared<ReturnStatement>(expression); 
+    return arena->make<ReturnStatement>(expression); 
 }
 
 declaration_statement Parser::parse_declaration_statement() {
     auto declaration = parse_declaration();
-    return std::make_shared<DeclarationStatement>(declaration);
+    return arena->make<DeclarationStatement>(declaration);
 }
 
 expression_statement Parser::parse_expression_statement() { // mozhet bit nullptr
     auto expression = parse_expression();
     extract_token(TokenType::SEMICOLON);
-    return std::make_shared<ExpressionStatement>(expression);
+    return arena->make<ExpressionStatement>(expression);
 }
 
 
@@ -488,135 +672,64 @@ stat_assert Parser::parse_staticassert_statement(){
     extract_token(TokenType::PARENTHESIS_RIGHT);
     extract_token(TokenType::SEMICOLON);
 
-    return std::make_shared<StaticAssertStatement>(condition, msg);
+    return arena->make<StaticAssertStatement>(condition, arena->copy(msg));
 }
 //comma dobavit, logical
 expression Parser::parse_expression(){
-    return parse_assignment();
+    return parse_binary_expression(Precedence::Assignment);
 }
 
 expression Parser::parse_comma_expression(){
-    auto left = parse_assignment();
+    auto left = parse_expression();
     while(match_token(TokenType::COMMA)){
-        auto op = tokens[offset - 1].value;
-        auto right = parse_assignment();
-        left = std::make_shared<BinaryOperation>(op, left, right);
+        auto op = binary_operator(tokens.previous().value);
+        auto right = parse_expression();
+        left = arena->make<BinaryOperation>(op, left, right);
     } // while dlya levoy if rigt
     return left;
 }
 
-
-expression Parser::parse_assignment(){ 
-    auto left = parse_ternary_expression(); //logical or
-    if (match_token(TokenType::ASSIGN, TokenType::PLUS_ASSIGN, TokenType::MINUS_ASSIGN, TokenType::MULTIPLY_ASSIGN, TokenType::DIVIDE_ASSIGN, TokenType::MODULO_ASSIGN)) {
-        auto op = tokens[offset - 1].value;
-        auto right = parse_assignment();
-        left = std::make_shared<BinaryOperation>(op, left, right);
-    }
-    return left;
-}
-
-expression Parser::parse_ternary_expression(){ // int x = 5; int y = (x > 0) ? 10 : 20;
-    auto condition = parse_logical_or_expression();
-    while (match_token(TokenType::QUESTION)) {
-        auto true_expr = parse_expression();
-        extract_token(TokenType::COLON);
-        auto false_expr = parse_expression();
-        condition = std::make_shared<TernaryExpression>(condition, true_expr, false_expr);
-    } 
-    return condition;
-}
-
-expression Parser::parse_logical_or_expression(){
-    auto left = parse_logical_and_expression();
-    if(match_token(TokenType::OR)){
-        auto op = tokens[offset -1].value;
-        auto right = parse_logical_or_expression();
-        left = std::make_shared<BinaryOperation>(op, left, right);
-    }
-    return left;
-}
-
-expression Parser::parse_logical_and_expression(){
-    auto left = parse_equality_expression();
-    if(match_token(TokenType::AND)){
-        auto op = tokens[offset -1].value;
-        auto right = parse_logical_and_expression();
-        left = std::make_shared<BinaryOperation>(op, left, right);
-    }
-    return left;
-}
-
-expression Parser::parse_equality_expression(){
-    auto left = parse_compared_expression();
-    while(match_token(TokenType::EQUAL, TokenType::NOT_EQUAL)){
-        auto op = tokens[offset -1].value;
-        auto right = parse_compared_expression();
-        left = std::make_shared<BinaryOperation>(op, left, right);
-    }
-    return left;
-    
-}
-
-
-
-expression Parser::parse_compared_expression(){ // 4 < 20 < 2    EQUAL,
-    auto left = parse_sum_expression();
-    if(match_token(TokenType:: EQUAL, TokenType:: NOT_EQUAL, TokenType:: GREATER, TokenType:: LESS, TokenType:: GREATER_EQUAL, TokenType:: LESS_EQUAL)){
-        auto op = tokens[offset -1].value;
-        auto right = parse_compared_expression();
-        left = std::make_shared <BinaryOperation>(op, left, right);
-    }
-    return left;
-}
-
-
-expression Parser::parse_sum_expression(){ // 1+3+4
-    auto left = parse_mul_expression();
-    while(match_token(TokenType::PLUS, TokenType::MINUS)){
-        auto op = tokens[offset-1].value;
-        auto right = parse_mul_expression();
-        left = std::make_shared<BinaryOperation>(op, left, right);
-    }
-    return left;
-}
-
-
-expression Parser::parse_mul_expression(){
-    auto left = parse_pow_expression();
-    while(match_token(TokenType::MULTIPLY, TokenType::DIVIDE)){
-        auto op = tokens[offset-1].value;
-        auto right = parse_pow_expression();
-        left = std::make_shared<BinaryOperation>(op, left, right);
-    }
-    return left;
-}
-
-expression Parser::parse_pow_expression(){
+// Разбор по приоритетам: левый операнд, затем операторы не слабее min_precedence.
+// Правый операнд берётся с порогом на ступень выше, у правоассоциативных — с тем же,
+// так что глубина вызовов зависит от числа операторов, а не от числа уровней грамматики.
+expression Parser::parse_binary_expression(int min_precedence){
     auto left = parse_unary_expression();
-    if(match_token(TokenType::POWER)){
-        auto op = tokens[offset -1].value;
-        auto right = parse_pow_expression();
-        left = std::make_shared<BinaryOperation>(op, left, right);
+    while (true) {
+        const BinaryRule& rule = binary_rule(tokens.peek().type);
+        if (rule.precedence == Precedence::None || rule.precedence < min_precedence) {
+            return left;
+        }
+        tokens.advance();
+
+        // int y = (x > 0) ? 10 : 20;
+        if (rule.precedence == Precedence::Conditional) {
+            auto true_expr = parse_expression();
+            extract_token(TokenType::COLON);
+            auto false_expr = parse_expression();
+            left = arena->make<TernaryExpression>(left, true_expr, false_expr);
+            continue;
+        }
+
+        auto right = parse_binary_expression(rule.right_associative ? rule.precedence : rule.precedence + 1);
+        left = arena->make<BinaryOperation>(rule.op, left, right);
     }
-    return left;
 }
 
 expression Parser::parse_unary_expression(){ // a 2 ls + - and logical
     if(match_token(TokenType::INCREMENT, TokenType:: DECREMENT)){
-        auto op = tokens[offset-1].value;
+        auto op = prefix_operator(tokens.previous().value);
         auto base = parse_postfix_expression();
-        return std::make_shared<PrefixExpression>(op, base);
+        return arena->make<PrefixExpression>(op, base);
     }
     if(match_token(TokenType::MULTIPLY)){ // poka dlya odnogo pointera
-        auto op = tokens[offset-1].value;
+        auto op = prefix_operator(tokens.previous().value);
         auto base = parse_unary_expression();
-        return std::make_shared<PrefixExpression>(op, base);
+        return arena->make<PrefixExpression>(op, base);
     }
     if(match_token(TokenType::BIT_AND)){
-        auto op = tokens[offset-1].value;
+        auto op = prefix_operator(tokens.previous().value);
         auto base = parse_unary_expression();
-        return std::make_shared<PrefixExpression>(op, base);
+        return arena->make<PrefixExpression>(op, base);
     }
     return parse_postfix_expression();
 }
@@ -626,43 +739,43 @@ expression Parser::parse_postfix_expression() {
     if (match_token(TokenType::SIZEOF)) {
         if (match_token(TokenType::PARENTHESIS_LEFT)) {
             if (check_token(TokenType::TYPE)) {
-                auto type_name = extract_token(TokenType::TYPE);
+                auto type_name = extract_name(TokenType::TYPE);
                 extract_token(TokenType::PARENTHESIS_RIGHT);
-                return std::make_shared<SizeOfExpression>(type_name);
+                return arena->make<SizeOfExpression>(type_name);
             } else {
                 auto expr = parse_expression();
                 extract_token(TokenType::PARENTHESIS_RIGHT);
-                return std::make_shared<SizeOfExpression>(expr);
+                return arena->make<SizeOfExpression>(expr);
             }
         } else {
             throw std::runtime_error("Expected '(' after sizeof");
         }
     }
 
-    //std::cout << tokens[offset].value << std::endl;
+    //std::cout << tokens.peek().value << std::endl;
     auto left = parse_base();
 
     while (check_token(TokenType::INCREMENT, TokenType::DECREMENT, TokenType::INDEX_LEFT, 
                        TokenType::PARENTHESIS_LEFT, TokenType::DOT, TokenType::SCOPE)) {
         
         if (match_token(TokenType::INCREMENT)) {
-            left = std::make_shared<PostfixIncrementExpression>(left);
+            left = arena->make<PostfixIncrementExpression>(left);
         }
         if (match_token(TokenType::DECREMENT)) {
-            left = std::make_shared<PostfixDecrementExpression>(left);
+            left = arena->make<PostfixDecrementExpression>(left);
         }
         if (match_token(TokenType::INDEX_LEFT)) {
             auto arg = parse_expression();
             extract_token(TokenType::INDEX_RIGHT);
-            left = std::make_shared<SubscriptExpression>(left, arg);
+            left = arena->make<SubscriptExpression>(left, arg);
         }
         if (match_token(TokenType::PARENTHESIS_LEFT)) {
-            //std::cout << tokens[offset].value << std::endl;
-            std::vector<std::shared_ptr<Expression>> args;
+            //std::cout << tokens.peek().value << std::endl;
+            std::vector<Expression*> args;
             while (!check_token(TokenType::PARENTHESIS_RIGHT)) {
                 auto arg = parse_expression();
                 args.push_back(arg);
-                //std::cout << tokens[offset].value << std::endl;
+                //std::cout << tokens.peek().value << std::endl;
                 if (match_token(TokenType::COMMA)) {
                     continue; 
                 } else if (check_token(TokenType::PARENTHESIS_RIGHT)) {
@@ -672,15 +785,15 @@ expression Parser::parse_postfix_expression() {
                 }
             }
             extract_token(TokenType::PARENTHESIS_RIGHT); 
-            left = std::make_shared<FunctionCallExpression>(left, args);
+            left = arena->make<FunctionCallExpression>(left, arena->copy(args));
         }
         if (match_token(TokenType::DOT)) {
-            auto member = extract_token(TokenType::ID);
-            left = std::make_shared<StructMemberAccessExpression>(left, member);
+            auto member = extract_name(TokenType::ID);
+            left = arena->make<StructMemberAccessExpression>(left, member);
         }
         if(match_token(TokenType::SCOPE)){
-            auto member = extract_token(TokenType::ID);
-            left = std::make_shared<NameSpaceAcceptExpression>(left, member);
+            auto member = extract_name(TokenType::ID);
+            left = arena->make<NameSpaceAcceptExpression>(left, member);
         }
     }
 
@@ -697,33 +810,33 @@ expression Parser::parse_base() {
     }
 
     if (check_token(TokenType::LITERAL_CHAR)) {
-        return std::make_shared<CharLiteral>(extract_token(TokenType::LITERAL_CHAR));
+        return arena->make<CharLiteral>(extract_token(TokenType::LITERAL_CHAR));
     }
     if (check_token(TokenType::LITERAL_NUM)) {
         auto value = extract_token(TokenType::LITERAL_NUM);
         if (value.find('.') != std::string::npos)
-            return std::make_shared<FloatLiteral>(value);
+            return arena->make<FloatLiteral>(value);
         else
-            return std::make_shared<IntLiteral>(value);
+            return arena->make<IntLiteral>(value);
     }
     if (check_token(TokenType::LITERAL_STRING)) {
-        return std::make_shared<StringLiteral>(extract_token(TokenType::LITERAL_STRING));
+        return arena->make<StringLiteral>(arena->copy(extract_token(TokenType::LITERAL_STRING)));
     }
     if (check_token(TokenType::TRUE, TokenType::FALSE)) {
-        auto val = tokens[offset++].value;
-        return std::make_shared<BoolLiteral>(val);
+        std::string val(tokens.consume().value);
+        return arena->make<BoolLiteral>(val);
     }
     if(match_token(TokenType::NULLPTR)){
-        return std::make_shared<NullPtrLiteral>();
+        return arena->make<NullPtrLiteral>();
     }
     if (check_token(TokenType::ID)) {
-        auto name = extract_token(TokenType::ID);
-        return std::make_shared<IdentifierExpression>(name);
+        auto name = extract_name(TokenType::ID);
+        return arena->make<IdentifierExpression>(name);
     }
 
 
 
-    throw std::runtime_error("parse base error " + tokens[offset].value);
+    throw std::runtime_error("parse base error " + std::string(tokens.peek().value) + " at " + tokens.peek().position());
 }
 
 
@@ -732,36 +845,35 @@ template<typename... Args>
 bool Parser::match_token(const Args&... expected) {
 	bool match_found = check_token(expected...);
 	if (match_found) {
-		++offset;
+		tokens.advance();
 	}
 	return match_found;
 }
 
 template<typename... Args>
 bool Parser::check_token(const Args&... expected) {
-	return ((tokens[offset].type == expected) || ...);
+	return ((tokens.peek().type == expected) || ...);
 }
 
-template<typename... Args>
-bool Parser::match_pattern(const Args&... expected) {
-	std::size_t i = offset;
-	return ((tokens[i++].type == expected) && ...);
-} 
 
 template<typename... Args>
 std::string Parser::extract_token(const Args&... expected) {
-	if (!((tokens[offset].type == expected) || ...)) {
-		throw std::runtime_error("Extract token : Unexpected token " + tokens[offset].value);
+	if (!((tokens.peek().type == expected) || ...)) {
+		throw std::runtime_error("Extract token : Unexpected token " + std::string(tokens.peek().value) + " at " + tokens.peek().position());
 	}
-	return tokens[offset++].value;
+	return std::string(tokens.consume().value);
+}
+
+template<typename... Args>
+Name Parser::extract_name(const Args&... expected) {
+	if (!((tokens.peek().type == expected) || ...)) {
+		throw std::runtime_error("Extract token : Unexpected token " + std::string(tokens.peek().value) + " at " + tokens.peek().position());
+	}
+	return tokens.consume().name;
 }
 
 Token Parser::peek_token(int lookahead) {
-    if (offset + lookahead < tokens.size()) {
-        return tokens[offset + lookahead];
-    } else {
-        return Token{TokenType::END, ""}; 
-    }
+    return tokens.peek(lookahead);
 }
 
 
@@ -12,7 +12,7 @@ void Printer::visit(TranslationUnit& node) {
     std::cout << "TranslationUnit {\n";
     ++indent_level;
     for (auto& decl : node.declarations) {
-        decl->accept(*this);
+        walk(*decl);
         std::cout << "\n";
     }
     --indent_level;
@@ -38,7 +38,7 @@ void Printer::visit(Declaration::PtrDeclarator& node) {
     std::cout << "PtrDeclarator: *\n";
     ++indent_level;
     if (node.inner) {
-        node.inner->accept(*this);
+        walk(*node.inner);
     }
     --indent_level;
 }
@@ -46,12 +46,12 @@ void Printer::visit(Declaration::InitDeclarator& node) {
     indent();
     std::cout << "InitDeclarator:\n";
     ++indent_level;
-    node.declarator->accept(*this);
+    walk(*node.declarator);
     if (node.initializer) {
         indent();
         std::cout << "= \n";
         ++indent_level;
-        node.initializer->accept(*this);
+        walk(*node.initializer);
         --indent_level;
     }
     --indent_level;
@@ -65,7 +65,7 @@ void Printer::visit(VarDeclaration& node) {
 
     ++indent_level;
     for (std::size_t i = 0; i < node.declarator_list.size(); ++i) {
-        node.declarator_list[i]->accept(*this);
+        walk(*node.declarator_list[i]);
     }
     --indent_level;
 }
@@ -74,29 +74,30 @@ void Printer::visit(ParameterDeclaration& node) {
     indent();
     std::cout << "ParameterDeclaration: " << node.type << "\n";
     ++indent_level;
-    node.init_declarator->accept(*this);
+    walk(*node.init_declarator);
     --indent_level;
 }
 
 void Printer::visit(FuncDeclaration& node) {
     indent();
     std::cout << "FuncDeclaration: "
+              << (node.is_constexpr ? "constexpr " : "")
               << (node.is_const ? "const " : "") << node.type << "\n";
     std::cout<< (node.is_readonly ? "readonly " : "");
     ++indent_level;
-    node.declarator->accept(*this);
+    walk(*node.declarator);
     std::cout << "\n";
     indent();
     std::cout << "Parameters:\n";
     ++indent_level;
     for (auto& arg : node.args) {
-        arg->accept(*this);
+        walk(*arg);
     }
 
     
     --indent_level;
     if (node.body) {
-        node.body->accept(*this);
+        walk(*node.body);
     } else {
         indent();
         std::cout << ";\n";
@@ -109,7 +110,7 @@ void Printer::visit(CompoundStatement& node) {
     std::cout << "CompoundStatement {\n";
     ++indent_level;
     for (auto& stmt : node.statements) {
-        stmt->accept(*this);
+        walk(*stmt);
     }
     --indent_level;
     indent();
@@ -120,7 +121,7 @@ void Printer::visit(DeclarationStatement& node) {
     indent();
     std::cout << "DeclarationStatement:\n";
     ++indent_level;
-    node.declaration->accept(*this);
+    walk(*node.declaration);
     --indent_level;
 }
 
@@ -128,7 +129,7 @@ void Printer::visit(ExpressionStatement& node) {
     indent();
     std::cout << "ExpressionStatement:\n";
     ++indent_level;
-    node.expression->accept(*this);
+    walk(*node.expression);
     --indent_level;
 }
 
@@ -139,18 +140,18 @@ void Printer::visit(ConditionalStatement& node) {
     indent();
     std::cout << "Condition:\n";
     ++indent_level;
-    node.if_branch.first->accept(*this);
+    walk(*node.if_branch.first);
     --indent_level;
     indent();
     std::cout << "Then:\n";
     ++indent_level;
-    node.if_branch.second->accept(*this);
+    walk(*node.if_branch.second);
     --indent_level;
     if (node.else_branch) {
         indent();
         std::cout << "Else:\n";
         ++indent_level;
-        node.else_branch->accept(*this);
+        walk(*node.else_branch);
         --indent_level;
     }
     --indent_level;
@@ -163,12 +164,12 @@ void Printer::visit(WhileStatement& node) {
     indent();
     std::cout << "Condition:\n";
     ++indent_level;
-    node.condition->accept(*this);
+    walk(*node.condition);
     --indent_level;
     indent();
     std::cout << "Body:\n";
     ++indent_level;
-    node.statement->accept(*this);
+    walk(*node.statement);
     --indent_level;
     --indent_level;
 }
@@ -182,7 +183,7 @@ void Printer::visit(ForStatement& node) {
         indent();
         std::cout << "Initialization:\n";
         ++indent_level;
-        node.initialization->accept(*this);
+        walk(*node.initialization);
         --indent_level;
     }
 
@@ -190,7 +191,7 @@ void Printer::visit(ForStatement& node) {
         indent();
         std::cout << "Condition:\n";
         ++indent_level;
-        node.condition->accept(*this);
+        walk(*node.condition);
         --indent_level;
     }
 
@@ -198,7 +199,7 @@ void Printer::visit(ForStatement& node) {
         indent();
         std::cout << "Increment:\n";
         ++indent_level;
-        node.increment->accept(*this);
+        walk(*node.increment);
         --indent_level;
     }
 
@@ -206,7 +207,7 @@ void Printer::visit(ForStatement& node) {
         indent();
         std::cout << "Body:\n";
         ++indent_level;
-        node.body->accept(*this);
+        walk(*node.body);
         --indent_level;
     }
 
@@ -218,7 +219,7 @@ void Printer::visit(ReturnStatement& node) {
     std::cout << "ReturnStatement:\n";
     ++indent_level;
     if(node.expression) {
-        node.expression->accept(*this);
+        walk(*node.expression);
     } else {
         indent();
         std::cout << ";\n";
@@ -238,18 +239,18 @@ void Printer::visit(ContinueStatement&) {
 
 void Printer::visit(BinaryOperation& node) {
     indent();
-    std::cout << "BinaryOperation: " << node.op << "\n";
+    std::cout << "BinaryOperation: " << spelling(node.op) << "\n";
     ++indent_level;
-    node.lhs->accept(*this);
-    node.rhs->accept(*this);
+    walk(*node.lhs);
+    walk(*node.rhs);
     --indent_level;
 }
 
 void Printer::visit(PrefixExpression& node) {
     indent();
-    std::cout << "PrefixExpression: " << node.op << "\n";
+    std::cout << "PrefixExpression: " << spelling(node.op) << "\n";
     ++indent_level;
-    node.base->accept(*this);
+    walk(*node.base);
     --indent_level;
 }
 
@@ -257,7 +258,7 @@ void Printer::visit(PostfixIncrementExpression& node) {
     indent();
     std::cout << "PostfixIncrementExpression: ++\n";
     ++indent_level;
-    node.base->accept(*this);
+    walk(*node.base);
     --indent_level;
 }
 
@@ -265,7 +266,7 @@ void Printer::visit(PostfixDecrementExpression& node) {
     indent();
     std::cout << "PostfixDecrementExpression: --\n";
     ++indent_level;
-    node.base->accept(*this);
+    walk(*node.base);
     --indent_level;
 }
 
@@ -274,9 +275,9 @@ void Printer::visit(FunctionCallExpression& node) {
     indent();
     std::cout << "FunctionCallExpression:\n";
     ++indent_level;
-    node.base->accept(*this);
+    walk(*node.base);
     for (auto& arg : node.args) {
-        arg->accept(*this);
+        walk(*arg);
     }
     --indent_level;
 }
@@ -320,7 +321,7 @@ void Printer::visit(ParenthesizedExpression& node) {
     indent();
     std::cout << "ParenthesizedExpression:\n";
     ++indent_level;
-    node.expression->accept(*this);
+    walk(*node.expression);
     --indent_level;
 }
 
@@ -329,7 +330,7 @@ void Printer::visit(StructDeclaration& node) {
     std::cout << "StructDeclaration: " << node.name << "\n";
     ++indent_level;
     for (auto& member : node.members) { 
-        member->accept(*this);
+        walk(*member);
     }
     --indent_level;
 }
@@ -339,7 +340,7 @@ void Printer::visit(StructMemberAccessExpression& node) {
     indent();
     std::cout << "StructMemberAccessExpression:\n";
     ++indent_level;
-    node.base->accept(*this);  
+    walk(*node.base);  
     indent();
     std::cout << "Member: " << node.member << "\n";
     --indent_level;
@@ -362,7 +363,7 @@ void Printer::visit(ArrayDeclaration &node) {
     indent();
     std::cout << "Size: ";
     if (node.size) {
-        node.size->accept(*this);
+        walk(*node.size);
     } else {
         std::cout << "<unspecified>\n";
     }
@@ -374,7 +375,7 @@ void Printer::visit(ArrayDeclaration &node) {
         for (size_t i = 0; i < node.initializer_list.size(); ++i) {
             indent();
             std::cout << "[" << i << "]: ";
-            node.initializer_list[i]->accept(*this);
+            walk(*node.initializer_list[i]);
         }
         --indent_level;
     }
@@ -390,11 +391,11 @@ void Printer::visit(SubscriptExpression &node) {
     
     indent();
     std::cout << "Base: ";
-    node.base->accept(*this); 
+    walk(*node.base); 
     
     indent();
     std::cout << "Index: ";
-    node.index->accept(*this); 
+    walk(*node.index); 
     
     --indent_level;
     }
@@ -408,15 +409,15 @@ void Printer::visit(TernaryExpression &node) {
     
     indent();
     std::cout << "Condition: ";
-    node.condition->accept(*this);
+    walk(*node.condition);
 
     indent();
     std::cout << "TrueExpr: ";
-    node.true_expr->accept(*this);
+    walk(*node.true_expr);
 
     indent();
     std::cout << "FalseExpr: ";
-    node.false_expr->accept(*this);
+    walk(*node.false_expr);
 
     --indent_level;
 }
@@ -434,7 +435,7 @@ void Printer::visit(SizeOfExpression& node) {
         indent();
         std::cout << "Expression:\n";
         ++indent_level;
-        node.expression->accept(*this);
+        walk(*node.expression);
         --indent_level;
     }
 
@@ -450,13 +451,13 @@ void Printer::visit(DoWhileStatement& node) {
     indent();
     std::cout << "Body:\n";
     ++indent_level;
-    node.statement->accept(*this);
+    walk(*node.statement);
     --indent_level;
 
     indent();
     std::cout << "Condition:\n";
     ++indent_level;
-    node.condition->accept(*this);
+    walk(*node.condition);
     --indent_level;
 
     --indent_level;
@@ -467,7 +468,7 @@ void Printer::visit(NameSpaceDeclaration& node) {
     std::cout << "Namespace: " << node.name << "\n";
     ++indent_level;
     for (auto& decl : node.declarations) {
-        decl->accept(*this);
+        walk(*decl);
     }
     --indent_level;
 }
@@ -480,7 +481,7 @@ void Printer::visit(NameSpaceAcceptExpression& node) {
     
     indent();
     std::cout << "Base: ";
-    node.base->accept(*this); 
+    walk(*node.base); 
     
     indent();
     std::cout << "Name: " << node.name << "\n"; 
@@ -496,7 +497,7 @@ void Printer::visit(StaticAssertStatement& node){
 
     indent();
     std::cout << "Condition";
-    node.condition->accept(*this);
+    walk(*node.condition);
 
     indent();
     std::cout << "Message:" << node.msg << "\n";
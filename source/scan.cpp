@@ -0,0 +1,216 @@
+#include "scan.hpp"
+
+#include <bit>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+bool is_blank(char c) { return c == ' ' || c == '\t' || c == '\v' || c == '\f' || c == '\r'; }
+bool is_digit(char c) { return c >= '0' && c <= '9'; }
+bool is_ident(char c) { return is_digit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; }
+
+namespace scalar {
+
+template<typename Predicate>
+const char* skip_while(const char* p, const char* end, Predicate predicate) {
+    while (p < end && predicate(*p)) ++p;
+    return p;
+}
+
+#ifndef SCAN_X86
+const char* skip_blanks(const char* p, const char* end) { return skip_while(p, end, is_blank); }
+const char* skip_ident(const char* p, const char* end)  { return skip_while(p, end, is_ident); }
+const char* skip_digits(const char* p, const char* end) { return skip_while(p, end, is_digit); }
+#endif
+
+const char* find_either(const char* p, const char* end, char a, char b) {
+    while (p < end && *p != a && *p != b) ++p;
+    return p;
+}
+
+std::size_t count(const char* p, const char* end, char c) {
+    std::size_t n = 0;
+    for (; p < end; ++p) n += *p == c;
+    return n;
+}
+
+}
+
+#ifdef SCAN_X86
+
+// Байты сравниваются как знаковые: символы >= 0x80 отрицательны и ни в один диапазон не попадают.
+namespace sse2 {
+
+using Mask = std::uint32_t;
+constexpr std::size_t width = 16;
+
+__m128i load(const char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+__m128i splat(char c) { return _mm_set1_epi8(c); }
+
+__m128i in_range(__m128i x, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(x, splat(lo - 1)), _mm_cmplt_epi8(x, splat(hi + 1)));
+}
+
+Mask blanks(__m128i x) {
+    __m128i controls = _mm_andnot_si128(_mm_cmpeq_epi8(x, splat('\n')), in_range(x, '\t', '\r'));
+    return _mm_movemask_epi8(_mm_or_si128(controls, _mm_cmpeq_epi8(x, splat(' '))));
+}
+
+Mask digits(__m128i x) { return _mm_movemask_epi8(in_range(x, '0', '9')); }
+
+Mask ident(__m128i x) {
+    __m128i letters = in_range(_mm_or_si128(x, splat(0x20)), 'a', 'z');
+    __m128i rest = _mm_or_si128(in_range(x, '0', '9'), _mm_cmpeq_epi8(x, splat('_')));
+    return _mm_movemask_epi8(_mm_or_si128(letters, rest));
+}
+
+template<typename Classify, typename Predicate>
+const char* skip_while(const char* p, const char* end, Classify classify, Predicate predicate) {
+    constexpr Mask all = (Mask(1) << width) - 1;
+    for (; end - p >= static_cast<std::ptrdiff_t>(width); p += width) {
+        Mask mask = classify(load(p));
+        if (mask != all) {
+            return p + std::countr_one(mask);
+        }
+    }
+    return scalar::skip_while(p, end, predicate);
+}
+
+const char* skip_blanks(const char* p, const char* end) { return skip_while(p, end, blanks, is_blank); }
+const char* skip_ident(const char* p, const char* end)  { return skip_while(p, end, ident, is_ident); }
+const char* skip_digits(const char* p, const char* end) { return skip_while(p, end, digits, is_digit); }
+
+const char* find_either(const char* p, const char* end, char a, char b) {
+    for (; end - p >= static_cast<std::ptrdiff_t>(width); p += width) {
+        __m128i x = load(p);
+        Mask mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(x, splat(a)), _mm_cmpeq_epi8(x, splat(b))));
+        if (mask) {
+            return p + std::countr_zero(mask);
+        }
+    }
+    return scalar::find_either(p, end, a, b);
+}
+
+std::size_t count(const char* p, const char* end, char c) {
+    std::size_t n = 0;
+    for (; end - p >= static_cast<std::ptrdiff_t>(width); p += width) {
+        n += std::popcount(static_cast<Mask>(_mm_movemask_epi8(_mm_cmpeq_epi8(load(p), splat(c)))));
+    }
+    return n + scalar::count(p, end, c);
+}
+
+}
+
+// те же ядра на 32 байта; компилируются под AVX2 независимо от флагов сборки
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+namespace avx2 {
+
+using Mask = std::uint32_t;
+constexpr std::size_t width = 32;
+
+__m256i load(const char* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+__m256i splat(char c) { return _mm256_set1_epi8(c); }
+
+__m256i in_range(__m256i x, char lo, char hi) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(x, splat(lo - 1)), _mm256_cmpgt_epi8(splat(hi + 1), x));
+}
+
+Mask blanks(__m256i x) {
+    __m256i controls = _mm256_andnot_si256(_mm256_cmpeq_epi8(x, splat('\n')), in_range(x, '\t', '\r'));
+    return _mm256_movemask_epi8(_mm256_or_si256(controls, _mm256_cmpeq_epi8(x, splat(' '))));
+}
+
+Mask digits(__m256i x) { return _mm256_movemask_epi8(in_range(x, '0', '9')); }
+
+Mask ident(__m256i x) {
+    __m256i letters = in_range(_mm256_or_si256(x, splat(0x20)), 'a', 'z');
+    __m256i rest = _mm256_or_si256(in_range(x, '0', '9'), _mm256_cmpeq_epi8(x, splat('_')));
+    return _mm256_movemask_epi8(_mm256_or_si256(letters, rest));
+}
+
+template<typename Classify, typename Predicate>
+const char* skip_while(const char* p, const char* end, Classify classify, Predicate predicate) {
+    for (; end - p >= static_cast<std::ptrdiff_t>(width); p += width) {
+        Mask mask = classify(load(p));
+        if (mask != ~Mask(0)) {
+            return p + std::countr_one(mask);
+        }
+    }
+    return scalar::skip_while(p, end, predicate);
+}
+
+const char* skip_blanks(const char* p, const char* end) { return skip_while(p, end, blanks, is_blank); }
+const char* skip_ident(const char* p, const char* end)  { return skip_while(p, end, ident, is_ident); }
+const char* skip_digits(const char* p, const char* end) { return skip_while(p, end, digits, is_digit); }
+
+const char* find_either(const char* p, const char* end, char a, char b) {
+    for (; end - p >= static_cast<std::ptrdiff_t>(width); p += width) {
+        __m256i x = load(p);
+        Mask mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(x, splat(a)), _mm256_cmpeq_epi8(x, splat(b))));
+        if (mask) {
+            return p + std::countr_zero(mask);
+        }
+    }
+    return sse2::find_either(p, end, a, b);
+}
+
+std::size_t count(const char* p, const char* end, char c) {
+    std::size_t n = 0;
+    for (; end - p >= static_cast<std::ptrdiff_t>(width); p += width) {
+        n += std::popcount(static_cast<Mask>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(load(p), splat(c)))));
+    }
+    return n + sse2::count(p, end, c);
+}
+
+}
+
+#pragma GCC pop_options
+
+#endif
+
+struct Kernels {
+    const char* (*skip_blanks)(const char*, const char*);
+    const char* (*skip_ident)(const char*, const char*);
+    const char* (*skip_digits)(const char*, const char*);
+    const char* (*find_either)(const char*, const char*, char, char);
+    std::size_t (*count)(const char*, const char*, char);
+};
+
+Kernels select() {
+#ifdef SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {avx2::skip_blanks, avx2::skip_ident, avx2::skip_digits, avx2::find_either, avx2::count};
+    }
+    // SSE2 входит в базовый набор x86-64
+    return {sse2::skip_blanks, sse2::skip_ident, sse2::skip_digits, sse2::find_either, sse2::count};
+#else
+    return {scalar::skip_blanks, scalar::skip_ident, scalar::skip_digits, scalar::find_either, scalar::count};
+#endif
+}
+
+// выбирается один раз при загрузке программы
+const Kernels kernels = select();
+
+}
+
+namespace scan {
+
+const char* skip_blanks(const char* p, const char* end) { return kernels.skip_blanks(p, end); }
+const char* skip_ident(const char* p, const char* end)  { return kernels.skip_ident(p, end); }
+const char* skip_digits(const char* p, const char* end) { return kernels.skip_digits(p, end); }
+
+const char* find_either(const char* p, const char* end, char a, char b) {
+    return kernels.find_either(p, end, a, b);
+}
+
+std::size_t count(const char* p, const char* end, char c) { return kernels.count(p, end, c); }
+
+}
@@ -16,60 +16,100 @@ std::shared_ptr<Scope> Scope::create_new_table(std::shared_ptr<Scope> prev_scope
     return scope;
 }   
 
-bool Scope::contains_symbol(std::string name) {
-    return symbolTable.find(name) != symbolTable.end();
+namespace {
+const std::shared_ptr<Symbol> no_symbol;
 }
 
-std::shared_ptr<Symbol> Scope::match_global(std::string name) {
-      /*std::cout << "[Scope::match_global] Looking for '" << name 
-              << "' in scope: " << this << std::endl;*/
+bool Scope::contains_symbol(Name name) const {
+    return symbolTable.find(name) != symbolTable.end();
+}
 
-    if (contains_symbol(name)) {
-       /* std::cout << "[Scope::match_global] Found '" << name 
-                  << "' in scope: " << this << std::endl; */
-        return symbolTable.find(name)->second;
+const std::shared_ptr<Symbol>& Scope::find(Name name) const {
+    for (const Scope* scope = this; scope; scope = scope->prev_table.get()) {
+        auto it = scope->symbolTable.find(name);
+        if (it != scope->symbolTable.end()) {
+            return it->second;
+        }
     }
-    if (prev_table == nullptr){
-       /* std::cout << "[Scope::match_global] Not found '" << name 
-                  << "', reached top scope." << std::endl; */
+    return no_symbol;
+}
+
+const std::shared_ptr<Symbol>& Scope::find_local(Name name) const {
+    auto it = symbolTable.find(name);
+    return it != symbolTable.end() ? it->second : no_symbol;
+}
+
+const std::shared_ptr<Symbol>& Scope::match_global(Name name) const {
+    const auto& symbol = find(name);
+    if (!symbol) {
         throw std::runtime_error("Symbol '" + name + "' not found in scope.");
     }
-    return this->prev_table->match_global(name); // возвращаем из старшей области видимости
+    return symbol;
 }
 
-std::shared_ptr<Symbol> Scope::match_local(std::string name) {
-    if (contains_symbol(name)) {
-        return symbolTable.find(name)->second;
+const std::shared_ptr<Symbol>& Scope::match_local(Name name) const {
+    const auto& symbol = find_local(name);
+    if (!symbol) {
+        throw std::runtime_error("Symbol '" + name + "' not found in local scope.");
     }
-    throw std::runtime_error("Symbol '" + name + "' not found in local scope.");
+    return symbol;
 }
 
-std::vector<std::shared_ptr<Symbol>> Scope::match_range(std::string name) {
-    std::vector<std::shared_ptr<Symbol>> result;
-    auto range = symbolTable.equal_range(name); // Получаем диапазон элементов с одинаковым ключом
-    for (auto it = range.first; it != range.second; ++it) {
-        result.push_back(it->second);
-    }
-    if (result.empty() && prev_table != nullptr) {
-        return this->prev_table->match_range(name); // Ищем в старшей области видимости
-    }
-    if (result.empty()) {
-        throw std::runtime_error("Symbol '" + name + "' not found in scope.");
-    }
-    return result;
+// имя объявлено в области не более одного раза, поэтому диапазон — это один символ
+std::span<const std::shared_ptr<Symbol>> Scope::match_range(Name name) const {
+    return {&match_global(name), 1};
 }
 
-void Scope::push_symbol(std::string name, std::shared_ptr<Symbol> symbol) {
+int Scope::push_symbol(Name name, std::shared_ptr<Symbol> symbol, int slot) {
     if (dynamic_cast<FuncSymbol*>(symbol.get()) && contains_symbol(name)) {
         
     }
     if (contains_symbol(name)) {
         throw std::runtime_error("Symbol '" + name + "' already exists in scope. in scope");
     }
+    if (slot < 0) {
+        slot = static_cast<int>(slots.size());
+        slots.push_back(symbol);
+    }
+    slot_index[symbol.get()] = slot;
     symbolTable.insert({name, symbol});
+    return slot;
+}
+
+bool Scope::locate(const Symbol* symbol, int& depth, int& slot) {
+    depth = 0;
+    for (Scope* scope = this; scope; scope = scope->prev_table.get()) {
+        if (!scope->frame && !scope->members) {
+            ++depth;
+        }
+        auto it = scope->slot_index.find(symbol);
+        if (it != scope->slot_index.end()) {
+            slot = it->second;
+            if (scope->frame) {
+                depth = 0;
+            }
+            return true;
+        }
+    }
+    depth = slot = -1;
+    return false;
+}
+
+void Scope::place_symbol(int slot, std::shared_ptr<Symbol> symbol) {
+    if (static_cast<size_t>(slot) >= slots.size()) {
+        slots.resize(slot + 1);
+    }
+    slots[slot] = std::move(symbol);
+}
+
+std::shared_ptr<Symbol> Scope::local_slot(int slot) {
+    if (static_cast<size_t>(slot) < slots.size()) {
+        return slots[slot];
+    }
+    return nullptr;
 }
 
-bool Scope::contains_symbol_recursive(const std::string& name) {
+bool Scope::contains_symbol_recursive(Name name) const {
     if (contains_symbol(name)) {
         return true;
     }
@@ -0,0 +1,42 @@
+#include "source_buffer.hpp"
+
+#include <fstream>
+#include <iterator>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SourceBuffer::SourceBuffer(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    opened = true;
+
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        void* view = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view != MAP_FAILED) {
+            ::madvise(view, info.st_size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(view);
+            size = static_cast<std::size_t>(info.st_size);
+            mapped = true;
+        }
+    }
+    ::close(fd);
+
+    if (!mapped) {
+        std::ifstream file(filename, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data = contents.data();
+        size = contents.size();
+    }
+}
+
+SourceBuffer::~SourceBuffer() {
+    if (mapped) {
+        ::munmap(const_cast<char*>(data), size);
+    }
+}
@@ -1,84 +1,88 @@
 #include "visitor.hpp"
 
 CompoundStatement::CompoundStatement(
-	const std::vector<std::shared_ptr<Statement>>& statements
-	) : statements(statements) {}
+	node_list<Statement> statements
+	) : Statement(node_kind), statements(statements) {}
 
 void CompoundStatement::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
 ConditionalStatement::ConditionalStatement(
-	const std::pair<std::shared_ptr<Expression>, std::shared_ptr<Statement>>& if_branch,
-	const std::shared_ptr<Statement>& else_branch
-	) : if_branch(if_branch), else_branch(else_branch) {}
+	std::pair<Expression*, Statement*> if_branch,
+	Statement* else_branch
+	) : Statement(node_kind), if_branch(if_branch), else_branch(else_branch) {}
 
 void ConditionalStatement::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
 WhileStatement::WhileStatement(
-	const std::shared_ptr<Expression>& condition,
-	const std::shared_ptr<Statement>& statement
-	) : condition(condition), statement(statement) {}
+	Expression* condition,
+	Statement* statement
+	) : LoopStatement(node_kind), condition(condition), statement(statement) {}
 
 void WhileStatement::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 ForStatement::ForStatement(
-	std::shared_ptr<ASTNode> initialization,
-	std::shared_ptr<Expression> condition,
-	std::shared_ptr<Expression> increment,
-	std::shared_ptr<Statement> body
-) : initialization(initialization), condition(condition), increment(increment), body(body) {}
+	ASTNode* initialization,
+	Expression* condition,
+	Expression* increment,
+	Statement* body
+) : LoopStatement(node_kind), initialization(initialization), condition(condition), increment(increment), body(body) {}
 
 void ForStatement::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
 ReturnStatement::ReturnStatement(
-	const std::shared_ptr<Expression>& expression
-	) : expression(expression) {}
+	Expression* expression
+	) : JumpStatement(node_kind), expression(expression) {}
 
 void ReturnStatement::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
+BreakStatement::BreakStatement() : JumpStatement(node_kind) {}
+
 void BreakStatement::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
+ContinueStatement::ContinueStatement() : JumpStatement(node_kind) {}
+
 void ContinueStatement::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
 DeclarationStatement::DeclarationStatement(
-	const std::shared_ptr<Declaration>& declaration
-	) : declaration(declaration) {}
+	Declaration* declaration
+	) : Statement(node_kind), declaration(declaration) {}
 
 void DeclarationStatement::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
 ExpressionStatement::ExpressionStatement(
-	const std::shared_ptr<Expression>& expression
-	) : expression(expression) {}
+	Expression* expression
+	) : Statement(node_kind), expression(expression) {}
 
 void ExpressionStatement::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
 DoWhileStatement::DoWhileStatement(
-	const std::shared_ptr<Statement>& statement,
-	const std::shared_ptr<Expression>& condition
-	) : statement(statement), condition(condition) {}
+	Statement* statement,
+	Expression* condition
+	) : LoopStatement(node_kind), statement(statement), condition(condition) {}
 void DoWhileStatement::accept(Visitor& visitor) {
 	visitor.visit(*this);
 }
 
 
 StaticAssertStatement::StaticAssertStatement(
-	const std::shared_ptr<Expression>& condition, const std::string& msg) : condition(condition) , msg(msg) {}
+	Expression* condition, std::string_view msg) : Statement(node_kind), condition(condition) , msg(msg) {}
 void StaticAssertStatement::accept(Visitor& visitor){
 	visitor.visit(*this);
 }
@@ -0,0 +1,42 @@
+#include "token_stream.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+const Token& TokenStream::peek(std::size_t lookahead) {
+    if (lookahead > max_lookahead) {
+        throw std::runtime_error("TokenStream: lookahead " + std::to_string(lookahead) + " is too far");
+    }
+    std::size_t index = position + lookahead;
+    if (!lexer) {
+        return index < chunk.size() ? chunk[index] : end;
+    }
+    while (lexed <= index && !finished) {
+        Token token = lexer->next();
+        finished = token.type == TokenType::END;
+        ring[lexed++ & (capacity - 1)] = token;
+    }
+    // END повторяется сколько угодно раз
+    return slot(std::min(index, lexed - 1));
+}
+
+const Token& TokenStream::previous() const {
+    if (position == 0) {
+        throw std::runtime_error("TokenStream: no previous token");
+    }
+    if (!lexer) {
+        return position <= chunk.size() ? chunk[position - 1] : end;
+    }
+    return slot(std::min(position, lexed) - 1);
+}
+
+void TokenStream::advance() {
+    peek();
+    ++position;
+}
+
+Token TokenStream::consume() {
+    Token token = peek();
+    ++position;
+    return token;
+}
@@ -1,6 +1,5 @@
 #include "type.hpp"
 #include <iostream>
-#include <any>
 
 // «Закрываем» v-таблицы для базовых абстрактных классов
 Type::~Type() = default;
@@ -15,14 +14,14 @@ void Type::print() { }
 // ---------------------------
 
 bool VoidType::equals(const std::shared_ptr<Type>& other) const {
-    return dynamic_cast<VoidType*>(other.get()) != nullptr;
+    return other && other->kind == kind;
 }
 void VoidType::print() {
     std::cout << "void";
 }
 
 bool NullPtrType::equals(const std::shared_ptr<Type>& other) const {
-    return dynamic_cast<NullPtrType*>(other.get()) != nullptr;
+    return other && other->kind == kind;
 }
 void NullPtrType::print() {
     std::cout << "nullptr";
@@ -32,15 +31,10 @@ void NullPtrType::print() {
 // Arithmetic, Integral
 // ---------------------------
 
-Arithmetic::Arithmetic(std::any value) : value(std::move(value)) {}
-std::any Arithmetic::get_any_value() const {
-    return value;
-}
 void Arithmetic::print() {
     std::cout << "Arithmetic";
 }
 
-Integral::Integral(std::any value) : Arithmetic(std::move(value)) {}
 void Integral::print() {
     std::cout << "Integral";
 }
@@ -49,52 +43,36 @@ void Integral::print() {
 // BoolType, CharType, IntegerType, FloatType
 // ---------------------------
 
-BoolType::BoolType(std::any value) : Integral(std::move(value)) {
-    this->value = std::any_cast<bool>(get_any_value());
-}
 bool BoolType::equals(const std::shared_ptr<Type>& other) const {
-    return dynamic_cast<BoolType*>(other.get()) != nullptr;
+    return other && other->kind == kind;
 }
 void BoolType::print() {
     std::cout << "bool";
 }
 
-CharType::CharType(std::any value) : Integral(std::move(value)) {
-    this->value = std::any_cast<char16_t>(get_any_value());
-}
 bool CharType::equals(const std::shared_ptr<Type>& other) const {
-    return dynamic_cast<CharType*>(other.get()) != nullptr;
+    return other && other->kind == kind;
 }
 void CharType::print() {
     std::cout << "char";
 }
 
-IntegerType::IntegerType(std::any value) : Integral(std::move(value)) {
-    this->value = std::any_cast<int8_t>(get_any_value());
-}
 bool IntegerType::equals(const std::shared_ptr<Type>& other) const {
-    return dynamic_cast<IntegerType*>(other.get()) != nullptr;
+    return other && other->kind == kind;
 }
 void IntegerType::print() {
     std::cout << "int";
 }
 
-FloatType::FloatType(std::any value) : Arithmetic(std::move(value)) {
-    this->value = std::any_cast<double>(get_any_value());
-}
 bool FloatType::equals(const std::shared_ptr<Type>& other) const {
-    return dynamic_cast<FloatType*>(other.get()) != nullptr;
+    return other && other->kind == kind;
 }
 void FloatType::print() {
     std::cout << "float";
 }
 
-StringType::StringType(std::string value) : value(std::move(value)) {}
-std::string StringType::get_value() const {
-    return value;
-}
 bool StringType::equals(const std::shared_ptr<Type>& other) const {
-    return dynamic_cast<StringType*>(other.get()) != nullptr;
+    return other && other->kind == kind;
 }
 void StringType::print() {
     std::cout << "string";
@@ -107,16 +85,17 @@ void StringType::print() {
 FuncType::FuncType(std::shared_ptr<Type> return_type,
                    std::vector<std::shared_ptr<Type>> args,
                    bool is_method_c)
-    : returnable_type(std::move(return_type))
+    : Composite(TypeKind::Func)
+    , returnable_type(std::move(return_type))
     , args(std::move(args))
     , is_method_c(is_method_c)
 {}
 
-std::shared_ptr<Type> FuncType::get_returnable_type() const {
+const std::shared_ptr<Type>& FuncType::get_returnable_type() const {
     return returnable_type;
 }
 
-std::vector<std::shared_ptr<Type>> FuncType::get_args() const {
+const std::vector<std::shared_ptr<Type>>& FuncType::get_args() const {
     return args;
 }
 
@@ -124,8 +103,13 @@ bool FuncType::is_method_const() const {
     return is_method_c;
 }
 
+// каноничные типы равны только себе; по составляющим сравниваются лишь
+// типы со структурами, которые создаются заново на каждое объявление
 bool FuncType::equals(const std::shared_ptr<Type>& other) const {
-    if (auto o = dynamic_cast<FuncType*>(other.get())) {
+    if (other.get() == this) {
+        return true;
+    }
+    if (auto o = type_cast<FuncType>(other.get())) {
         if (!returnable_type->equals(o->returnable_type) ||
             args.size() != o->args.size() ||
             is_method_c != o->is_method_c)
@@ -154,21 +138,36 @@ void FuncType::print() {
 // ---------------------------
 
 StructType::StructType(
-    const std::unordered_map<std::string, std::shared_ptr<Type>>& members,
-    const std::unordered_map<std::string, std::shared_ptr<FuncType>>& methods)
-    : members(members), methods(methods)
+    const std::unordered_map<Name, std::shared_ptr<Type>>& members,
+    const std::unordered_map<Name, std::shared_ptr<FuncType>>& methods)
+    : RecordType(TypeKind::Struct), members(members), methods(methods)
 {}
 
-std::unordered_map<std::string, std::shared_ptr<Type>> StructType::get_members() const {
+const std::unordered_map<Name, std::shared_ptr<Type>>& StructType::get_members() const {
     return members;
 }
 
-std::unordered_map<std::string, std::shared_ptr<FuncType>> StructType::get_methods() const {
+const std::unordered_map<Name, std::shared_ptr<FuncType>>& StructType::get_methods() const {
     return methods;
 }
 
+const std::shared_ptr<Type>& StructType::find_member(Name name) const {
+    static const std::shared_ptr<Type> none;
+    auto it = members.find(name);
+    return it != members.end() ? it->second : none;
+}
+
+const std::shared_ptr<FuncType>& StructType::find_method(Name name) const {
+    static const std::shared_ptr<FuncType> none;
+    auto it = methods.find(name);
+    return it != methods.end() ? it->second : none;
+}
+
 bool StructType::equals(const std::shared_ptr<Type>& other) const {
-    if (auto o = dynamic_cast<StructType*>(other.get())) {
+    if (other.get() == this) {
+        return true;
+    }
+    if (auto o = type_cast<StructType>(other.get())) {
         if (o->members.size() != members.size()) return false;
         for (auto& [k,v] : members) {
             auto it = o->members.find(k);
@@ -200,15 +199,18 @@ void StructType::print() {
 // ---------------------------
 
 PointerType::PointerType(std::shared_ptr<Type> base)
-    : base(std::move(base))
+    : Composite(TypeKind::Pointer), base(std::move(base))
 {}
 
-std::shared_ptr<Type> PointerType::get_base() const {
+const std::shared_ptr<Type>& PointerType::get_base() const {
     return base;
 }
 
 bool PointerType::equals(const std::shared_ptr<Type>& other) const {
-    if (auto o = dynamic_cast<PointerType*>(other.get())) {
+    if (other.get() == this) {
+        return true;
+    }
+    if (auto o = type_cast<PointerType>(other.get())) {
         return base->equals(o->base);
     }
     return false;
@@ -226,15 +228,18 @@ void PointerType::print() {
 // ---------------------------
 
 LValueType::LValueType(std::shared_ptr<Type> ref_to)
-    : ref_to(std::move(ref_to))
+    : RefType(TypeKind::LValue), ref_to(std::move(ref_to))
 {}
 
-std::shared_ptr<Type> LValueType::get_referenced_type() const {
+const std::shared_ptr<Type>& LValueType::get_referenced_type() const {
     return ref_to;
 }
 
 bool LValueType::equals(const std::shared_ptr<Type>& other) const {
-    if (auto o = dynamic_cast<LValueType*>(other.get())) {
+    if (other.get() == this) {
+        return true;
+    }
+    if (auto o = type_cast<LValueType>(other.get())) {
         return ref_to->equals(o->ref_to);
     }
     return false;
@@ -247,15 +252,18 @@ void LValueType::print() {
 }
 
 RValueType::RValueType(std::shared_ptr<Type> ref_to)
-    : ref_to(std::move(ref_to))
+    : RefType(TypeKind::RValue), ref_to(std::move(ref_to))
 {}
 
-std::shared_ptr<Type> RValueType::get_referenced_type() const {
+const std::shared_ptr<Type>& RValueType::get_referenced_type() const {
     return ref_to;
 }
 
 bool RValueType::equals(const std::shared_ptr<Type>& other) const {
-    if (auto o = dynamic_cast<RValueType*>(other.get())) {
+    if (other.get() == this) {
+        return true;
+    }
+    if (auto o = type_cast<RValueType>(other.get())) {
         return ref_to->equals(o->ref_to);
     }
     return false;
@@ -271,20 +279,19 @@ void RValueType::print() {
 // ArrayType
 // ---------------------------
 
-ArrayType::ArrayType(std::shared_ptr<Type> base, std::shared_ptr<Expression> size)
-    : base(std::move(base)), size(size)
+ArrayType::ArrayType(std::shared_ptr<Type> base)
+    : Composite(TypeKind::Array), base(std::move(base))
 {}
 
-std::shared_ptr<Type> ArrayType::get_base_type() const {
+const std::shared_ptr<Type>& ArrayType::get_base_type() const {
     return base;
 }
 
-/*Symbol ArrayType::get_size() const {
-    return size;
-}*/
-
 bool ArrayType::equals(const std::shared_ptr<Type>& other) const {
-    if (auto o = dynamic_cast<ArrayType*>(other.get())) {
+    if (other.get() == this) {
+        return true;
+    }
+    if (auto o = type_cast<ArrayType>(other.get())) {
         return base->equals(o->base);
     }
     return false;
@@ -301,15 +308,18 @@ void ArrayType::print() {
 // ---------------------------
 
 ConstType::ConstType(std::shared_ptr<Type> base)
-    : base(std::move(base))
+    : Type(TypeKind::Const), base(std::move(base))
 {}
 
-std::shared_ptr<Type> ConstType::get_base() const {
+const std::shared_ptr<Type>& ConstType::get_base() const {
     return base;
 }
 
 bool ConstType::equals(const std::shared_ptr<Type>& other) const {
-    if (auto p = std::dynamic_pointer_cast<ConstType>(other)) {
+    if (other.get() == this) {
+        return true;
+    }
+    if (auto p = type_cast<ConstType>(other.get())) {
         return base->equals(p->base);
     }
     return false;
@@ -320,3 +330,75 @@ void ConstType::print() {
     base->print();
     std::cout << ")";
 }
+
+
+// ---------------------------
+// TypeContext
+// ---------------------------
+
+TypeContext& TypeContext::global() {
+    static TypeContext context;
+    return context;
+}
+
+TypeContext::TypeContext()
+    : void_t(new VoidType())
+    , nullptr_t(new NullPtrType())
+    , bool_t(new BoolType())
+    , char_t(new CharType())
+    , int_t(new IntegerType())
+    , float_t(new FloatType())
+    , string_t(new StringType())
+{}
+
+template<typename T>
+std::shared_ptr<Type> TypeContext::derived(TypeKind kind, const std::shared_ptr<Type>& base) {
+    auto [it, inserted] = derived_types.try_emplace(DerivedKey{kind, base.get()});
+    if (inserted) {
+        it->second.reset(new T(base));
+    }
+    return it->second;
+}
+
+std::shared_ptr<Type> TypeContext::pointer_to(const std::shared_ptr<Type>& base) {
+    return derived<PointerType>(TypeKind::Pointer, base);
+}
+
+std::shared_ptr<Type> TypeContext::const_of(const std::shared_ptr<Type>& base) {
+    return derived<ConstType>(TypeKind::Const, base);
+}
+
+std::shared_ptr<Type> TypeContext::lvalue_of(const std::shared_ptr<Type>& base) {
+    return derived<LValueType>(TypeKind::LValue, base);
+}
+
+std::shared_ptr<Type> TypeContext::rvalue_of(const std::shared_ptr<Type>& base) {
+    return derived<RValueType>(TypeKind::RValue, base);
+}
+
+std::shared_ptr<Type> TypeContext::array_of(const std::shared_ptr<Type>& element) {
+    return derived<ArrayType>(TypeKind::Array, element);
+}
+
+std::size_t TypeContext::FuncHash::operator()(const FuncKey& key) const noexcept {
+    std::size_t hash = std::hash<const Type*>()(key.returns) * 2 + key.is_method_const;
+    for (const Type* arg : key.args) {
+        hash = hash * 31 + std::hash<const Type*>()(arg);
+    }
+    return hash;
+}
+
+std::shared_ptr<FuncType> TypeContext::function(const std::shared_ptr<Type>& returns,
+                                                const std::vector<std::shared_ptr<Type>>& args,
+                                                bool is_method_const) {
+    FuncKey key{returns.get(), {}, is_method_const};
+    key.args.reserve(args.size());
+    for (const auto& arg : args) {
+        key.args.push_back(arg.get());
+    }
+    auto [it, inserted] = function_types.try_emplace(std::move(key));
+    if (inserted) {
+        it->second.reset(new FuncType(returns, args, is_method_const));
+    }
+    return it->second;
+}
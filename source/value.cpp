@@ -0,0 +1,350 @@
+#include "value.hpp"
+#include "symbol.hpp"
+#include "type.hpp"
+
+#include <stdexcept>
+#include <cstring>
+#include <climits>
+
+Value Value::cast(ValueKind to) const {
+    if (kind == to || !is_arithmetic()) return *this;
+    switch (to) {
+        case ValueKind::Int:   return from_int(as_int());
+        case ValueKind::Float: return from_float(as_float());
+        case ValueKind::Char:  return from_char(static_cast<char>(as_int()));
+        case ValueKind::Bool:  return from_bool(as_bool());
+        default:               return *this;
+    }
+}
+
+ValueKind kind_of(const std::shared_ptr<Type>& type) {
+    auto t = type.get();
+    if (auto cp = type_cast<ConstType>(t)) t = cp->get_base().get();
+    if (!t) return ValueKind::Void;
+    switch (t->kind) {
+        case TypeKind::Integer: return ValueKind::Int;
+        case TypeKind::Float:   return ValueKind::Float;
+        case TypeKind::Char:    return ValueKind::Char;
+        case TypeKind::Bool:    return ValueKind::Bool;
+        case TypeKind::Pointer: return ValueKind::Pointer;
+        case TypeKind::Struct:  return ValueKind::Struct;
+        case TypeKind::String:  return ValueKind::String;
+        default:                return ValueKind::Void;
+    }
+}
+
+Value default_value(const std::shared_ptr<Type>& type) {
+    switch (kind_of(type)) {
+        case ValueKind::Int:     return Value::from_int(0);
+        case ValueKind::Float:   return Value::from_float(0.0);
+        case ValueKind::Char:    return Value::from_char(0);
+        case ValueKind::Bool:    return Value::from_bool(false);
+        case ValueKind::Pointer: return Value::null();
+        default:                 return Value{};
+    }
+}
+
+void store(Value& slot, const Value& v) {
+    if (slot.kind == ValueKind::Struct && v.kind == ValueKind::Struct && slot.record && v.record) {
+        copy_record(*slot.record, *v.record);
+    } else if (slot.is_arithmetic() && v.is_arithmetic() && slot.kind != v.kind) {
+        slot = v.cast(slot.kind);
+    } else {
+        slot = v;
+    }
+}
+
+namespace {
+
+std::size_t element_width(ValueKind kind) {
+    switch (kind) {
+        case ValueKind::Int:   return sizeof(std::int32_t);
+        case ValueKind::Float: return sizeof(double);
+        case ValueKind::Char:
+        case ValueKind::Bool:  return sizeof(char);
+        default:               return sizeof(Value);
+    }
+}
+
+template <typename T>
+T load_raw(const unsigned char* at) {
+    T v;
+    std::memcpy(&v, at, sizeof(T));
+    return v;
+}
+
+template <typename T>
+void store_raw(unsigned char* at, T v) {
+    std::memcpy(at, &v, sizeof(T));
+}
+
+}
+
+void ArrayStorage::assign(std::size_t n, const Value& init) {
+    element = init.is_arithmetic() ? init.kind : ValueKind::Void;
+    width = element_width(element);
+    count = n;
+    bytes.assign(n * width, 0);
+    // нулевой буфер уже равен значению по умолчанию для чисел
+    bool zero = (element == ValueKind::Int && init.i == 0)
+             || (element == ValueKind::Float && init.f == 0.0)
+             || (element == ValueKind::Char && init.c == 0)
+             || (element == ValueKind::Bool && !init.b);
+    if (!zero) {
+        for (std::size_t i = 0; i < n; ++i) {
+            set(i, init);
+        }
+    }
+}
+
+void ArrayStorage::clear() {
+    element = ValueKind::Void;
+    count = 0;
+    bytes.clear();
+}
+
+Value ArrayStorage::get(std::size_t i) const {
+    const unsigned char* at = bytes.data() + i * width;
+    switch (element) {
+        case ValueKind::Int:   return Value::from_int(load_raw<std::int32_t>(at));
+        case ValueKind::Float: return Value::from_float(load_raw<double>(at));
+        case ValueKind::Char:  return Value::from_char(load_raw<char>(at));
+        case ValueKind::Bool:  return Value::from_bool(load_raw<char>(at) != 0);
+        default:               return load_raw<Value>(at);
+    }
+}
+
+void ArrayStorage::set(std::size_t i, const Value& v) {
+    unsigned char* at = bytes.data() + i * width;
+    if (element == ValueKind::Void) {
+        store_raw(at, v);
+        return;
+    }
+    if (!v.is_arithmetic()) {
+        throw std::runtime_error("cannot store a non-arithmetic value into a typed array");
+    }
+    switch (element) {
+        case ValueKind::Int:   store_raw<std::int32_t>(at, v.as_int()); break;
+        case ValueKind::Float: store_raw<double>(at, v.as_float()); break;
+        case ValueKind::Char:  store_raw<char>(at, static_cast<char>(v.as_int())); break;
+        case ValueKind::Bool:  store_raw<char>(at, v.as_bool() ? 1 : 0); break;
+        default: break;
+    }
+}
+
+
+Value binary_operation(const Value& lhs, Operator op, const Value& rhs) {
+
+    // арифметика указателей: p + n или p - n
+    if (lhs.is_pointer() && rhs.is_arithmetic() && (op == Operator::Add || op == Operator::Sub)) {
+        int offset = rhs.as_int();
+        int newIndex = (op == Operator::Add) ? (lhs.index + offset) : (lhs.index - offset);
+        VarSymbol* target = lhs.target;
+        if (!target || target->elements.empty()) {
+            // указатель на "отдельную" переменную: допускаем только offset == 0
+            if (newIndex != 0)
+                throw std::runtime_error("pointer arithmetic goes out of bounds");
+        }
+        else if (newIndex < 0 || newIndex > static_cast<int>(target->elements.size())) {
+            throw std::runtime_error("pointer arithmetic: out of array bounds");
+        }
+        return Value::pointer(target, newIndex);
+    }
+
+    // вычитание указателей: p2 - p1
+    if (op == Operator::Sub && lhs.is_pointer() && rhs.is_pointer()) {
+        if (lhs.target != rhs.target) {
+            throw std::runtime_error("pointer subtraction only valid for same array");
+        }
+        return Value::from_int(lhs.index - rhs.index);
+    }
+
+    // сравнение указателей с nullptr или друг с другом
+    bool lhsPtr = lhs.is_pointer() || lhs.kind == ValueKind::Null;
+    bool rhsPtr = rhs.is_pointer() || rhs.kind == ValueKind::Null;
+    if (lhsPtr || rhsPtr) {
+        if (!lhsPtr || !rhsPtr) {
+            throw std::runtime_error("pointer comparison type mismatch");
+        }
+        VarSymbol* l = lhs.is_pointer() ? lhs.target : nullptr;
+        VarSymbol* r = rhs.is_pointer() ? rhs.target : nullptr;
+        bool eq = (l == r) && (!l || lhs.index == rhs.index);
+        if (op == Operator::Equal)    return Value::from_bool(eq);
+        if (op == Operator::NotEqual) return Value::from_bool(!eq);
+        if (l && l == r) {
+            switch (op) {
+                case Operator::Less:         return Value::from_bool(lhs.index <  rhs.index);
+                case Operator::Greater:      return Value::from_bool(lhs.index >  rhs.index);
+                case Operator::LessEqual:    return Value::from_bool(lhs.index <= rhs.index);
+                case Operator::GreaterEqual: return Value::from_bool(lhs.index >= rhs.index);
+                default: break;
+            }
+        }
+        throw std::runtime_error("unsupported pointer operation: " + spelling(op));
+    }
+
+    if (!lhs.is_arithmetic() || !rhs.is_arithmetic()) {
+        throw std::runtime_error("binary operation requires arithmetic operands: " + spelling(op));
+    }
+
+    // арифметика и сравнения над числами: float, если есть float-операнд
+    if (lhs.kind == ValueKind::Float || rhs.kind == ValueKind::Float) {
+        double l = lhs.as_float(), r = rhs.as_float();
+        switch (op) {
+            case Operator::Add:          return Value::from_float(l + r);
+            case Operator::Sub:          return Value::from_float(l - r);
+            case Operator::Mul:          return Value::from_float(l * r);
+            case Operator::Div:
+                if (r == 0.0) throw std::runtime_error("division by zero");
+                return Value::from_float(l / r);
+            case Operator::Less:         return Value::from_bool(l < r);
+            case Operator::Greater:      return Value::from_bool(l > r);
+            case Operator::LessEqual:    return Value::from_bool(l <= r);
+            case Operator::GreaterEqual: return Value::from_bool(l >= r);
+            case Operator::Equal:        return Value::from_bool(l == r);
+            case Operator::NotEqual:     return Value::from_bool(l != r);
+            default: break;
+        }
+    } else {
+        int l = lhs.as_int(), r = rhs.as_int();
+        switch (op) {
+            // встроенные функции пишут результат по модулю 2^32 и при переполнении
+            case Operator::Add:          { int out; __builtin_add_overflow(l, r, &out); return Value::from_int(out); }
+            case Operator::Sub:          { int out; __builtin_sub_overflow(l, r, &out); return Value::from_int(out); }
+            case Operator::Mul:          { int out; __builtin_mul_overflow(l, r, &out); return Value::from_int(out); }
+            case Operator::Div:
+                if (r == 0) throw std::runtime_error("division by zero");
+                if (l == INT_MIN && r == -1) throw std::runtime_error("integer overflow in division");
+                return Value::from_int(l / r);
+            case Operator::Mod:
+                if (r == 0) throw std::runtime_error("division by zero");
+                if (l == INT_MIN && r == -1) throw std::runtime_error("integer overflow in division");
+                return Value::from_int(l % r);
+            case Operator::ShiftLeft:
+            case Operator::ShiftRight:
+                // сдвиг на отрицательное число разрядов или на ширину int и больше не определён
+                if (r < 0 || r >= 32) throw std::runtime_error("shift count out of range: " + std::to_string(r));
+                // влево — как unsigned: выдвинутые разряды отбрасываются и у отрицательных чисел
+                if (op == Operator::ShiftLeft) return Value::from_int(static_cast<int>(static_cast<unsigned>(l) << r));
+                return Value::from_int(l >> r);
+            case Operator::BitAnd:       return Value::from_int(l & r);
+            case Operator::BitOr:        return Value::from_int(l | r);
+            case Operator::BitXor:       return Value::from_int(l ^ r);
+            case Operator::Less:         return Value::from_bool(l < r);
+            case Operator::Greater:      return Value::from_bool(l > r);
+            case Operator::LessEqual:    return Value::from_bool(l <= r);
+            case Operator::GreaterEqual: return Value::from_bool(l >= r);
+            case Operator::Equal:        return Value::from_bool(l == r);
+            case Operator::NotEqual:     return Value::from_bool(l != r);
+            default: break;
+        }
+    }
+
+    if (op == Operator::And) return Value::from_bool(lhs.as_bool() && rhs.as_bool());
+    if (op == Operator::Or)  return Value::from_bool(lhs.as_bool() || rhs.as_bool());
+
+    throw std::runtime_error("unsupported binary operator: " + spelling(op));
+}
+
+
+
+Value unary_operation(const Value& v, Operator op) {
+    switch (op) {
+        case Operator::Plus:
+            if (v.kind == ValueKind::Float) return v;
+            if (v.is_arithmetic())          return Value::from_int(v.as_int());
+            throw std::runtime_error("unsupported operand for unary +");
+        case Operator::Minus:
+            if (v.kind == ValueKind::Float) return Value::from_float(-v.f);
+            if (v.is_arithmetic())          return Value::from_int(static_cast<int>(0u - static_cast<unsigned>(v.as_int())));
+            throw std::runtime_error("unsupported operand for unary -");
+        case Operator::Not:
+            if (!v.is_arithmetic() && !v.is_pointer() && v.kind != ValueKind::Null)
+                throw std::runtime_error("invalid operand for '!'");
+            return Value::from_bool(!v.as_bool());
+        default:
+            throw std::runtime_error("unsupported unary operator: " + spelling(op));
+    }
+}
+
+bool overflows(const Value& lhs, Operator op, const Value& rhs) {
+    if (!lhs.is_arithmetic() || !rhs.is_arithmetic() ||
+        lhs.kind == ValueKind::Float || rhs.kind == ValueKind::Float) {
+        return false;
+    }
+    int l = lhs.as_int(), r = rhs.as_int(), out;
+    switch (op) {
+        case Operator::Add: return __builtin_add_overflow(l, r, &out);
+        case Operator::Sub: return __builtin_sub_overflow(l, r, &out);
+        case Operator::Mul: return __builtin_mul_overflow(l, r, &out);
+        default:            return false;
+    }
+}
+
+bool overflows(const Value& v, Operator op) {
+    return op == Operator::Minus && v.is_arithmetic() && v.kind != ValueKind::Float && v.as_int() == INT_MIN;
+}
+
+// ячейка, на которую указывает p: сама переменная или элемент массива
+Ref dereference(const Value& p) {
+    if (!p.is_pointer() || !p.target) {
+        throw std::runtime_error("invalid pointer value");
+    }
+    VarSymbol* target = p.target;
+    if (target->elements.empty()) {
+        if (p.index != 0) {
+            throw std::runtime_error("pointer arithmetic goes out of bounds");
+        }
+        return Ref{target};
+    }
+    if (p.index < 0 || p.index >= static_cast<int>(target->elements.size())) {
+        throw std::runtime_error("array index out of range");
+    }
+    return Ref{target, p.index};
+}
+
+void copy_record(StructSymbol& to, const StructSymbol& from) {
+    if (&to == &from) {
+        return;
+    }
+    for (auto& kv : to.members) {
+        auto field = dynamic_cast<VarSymbol*>(kv.second.get());
+        auto it = from.members.find(kv.first);
+        if (!field || it == from.members.end()) {
+            continue;
+        }
+        if (auto source = dynamic_cast<VarSymbol*>(it->second.get())) {
+            store(field->value, source->value);
+        }
+    }
+}
+
+Value pointee(const Value& p) {
+    return dereference(p).get();
+}
+
+void assign_pointee(const Value& p, const Value& v) {
+    dereference(p).set(v);
+}
+
+std::ostream& operator<<(std::ostream& out, const Value& v) {
+    switch (v.kind) {
+        case ValueKind::Int:   return out << v.i;
+        case ValueKind::Float: return out << v.f;
+        case ValueKind::Char:  return out << v.c;
+        case ValueKind::Bool:  return out << (v.b ? "true" : "false");
+        case ValueKind::Null:  return out << "nullptr";
+        case ValueKind::Pointer:
+            // адрес переменной; для элементов массива адреса нет
+            if (v.target && v.target->elements.empty()) return out << static_cast<const void*>(v.target);
+            return out << "<ptr>";
+        case ValueKind::String: {
+            std::string_view s = *v.str;
+            if (s.size() >= 2 && s.front() == '\"' && s.back() == '\"') {
+                return out.write(s.data() + 1, s.size() - 2);
+            }
+            return out << s;
+        }
+        default: return out << "<<?>";
+    }
+}
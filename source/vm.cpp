@@ -0,0 +1,349 @@
+#include "vm.hpp"
+#include <stdexcept>
+#include <iostream>
+
+// целочисленный быстрый путь; остальные случаи — общая семантика binary_operation
+#define ARITHMETIC(OPCODE, OP, NAME)                                        \
+    case OpCode::OPCODE: {                                                  \
+        const Value& l = regs[in.b];                                        \
+        const Value& r = regs[in.c];                                        \
+        if (l.kind == ValueKind::Int && r.kind == ValueKind::Int) {         \
+            regs[in.a] = Value::from_int(l.i OP r.i);                       \
+        } else {                                                            \
+            regs[in.a] = binary_operation(l, Operator::NAME, r);            \
+        }                                                                   \
+        break;                                                              \
+    }
+
+// + - * над int по модулю 2^32, как в binary_operation
+#define WRAPPING(OPCODE, BUILTIN, NAME)                                     \
+    case OpCode::OPCODE: {                                                  \
+        const Value& l = regs[in.b];                                        \
+        const Value& r = regs[in.c];                                        \
+        if (l.kind == ValueKind::Int && r.kind == ValueKind::Int) {         \
+            int out;                                                        \
+            BUILTIN(l.i, r.i, &out);                                        \
+            regs[in.a] = Value::from_int(out);                              \
+        } else {                                                            \
+            regs[in.a] = binary_operation(l, Operator::NAME, r);            \
+        }                                                                   \
+        break;                                                              \
+    }
+
+// сдвиг на 0..31 разрядов; остальные счётчики отклоняет binary_operation
+#define SHIFT(OPCODE, EXPR, NAME)                                           \
+    case OpCode::OPCODE: {                                                  \
+        const Value& l = regs[in.b];                                        \
+        const Value& r = regs[in.c];                                        \
+        if (l.kind == ValueKind::Int && r.kind == ValueKind::Int &&         \
+            r.i >= 0 && r.i < 32) {                                         \
+            regs[in.a] = Value::from_int(EXPR);                             \
+        } else {                                                            \
+            regs[in.a] = binary_operation(l, Operator::NAME, r);            \
+        }                                                                   \
+        break;                                                              \
+    }
+
+#define COMPARISON(OPCODE, OP, NAME)                                        \
+    case OpCode::OPCODE: {                                                  \
+        const Value& l = regs[in.b];                                        \
+        const Value& r = regs[in.c];                                        \
+        if (l.kind == ValueKind::Int && r.kind == ValueKind::Int) {         \
+            regs[in.a] = Value::from_bool(l.i OP r.i);                      \
+        } else {                                                            \
+            regs[in.a] = binary_operation(l, Operator::NAME, r);            \
+        }                                                                   \
+        break;                                                              \
+    }
+
+
+VM::VM() { }
+
+VM::~VM() { }
+
+
+std::shared_ptr<StructSymbol> VM::instantiate(const StructSymbol& tmpl) {
+    std::unordered_map<Name, std::shared_ptr<Symbol>> members;
+    for (auto& kv : tmpl.members) {
+        if (auto fld = std::dynamic_pointer_cast<VarSymbol>(kv.second)) {
+            members[kv.first] = std::make_shared<VarSymbol>(fld->type, fld->value);
+        } else {
+            // методы общие для всех экземпляров
+            members[kv.first] = kv.second;
+        }
+    }
+    return std::make_shared<StructSymbol>(
+        std::static_pointer_cast<StructType>(tmpl.type), std::move(members));
+}
+
+
+int VM::run(const Program& program) {
+    const Function* fn = &program.functions[program.entry];
+    stack.assign(std::max<std::size_t>(1024, fn->num_registers), Value{});
+    boxes.assign(fn->num_boxes, nullptr);
+    frames.clear();
+
+    std::size_t base = 0;
+    std::size_t box_base = 0;
+    const Instruction* code = fn->code.data();
+    const Instruction* pc = code;
+    Value* regs = stack.data();
+
+    for (;;) {
+        const Instruction& in = *pc++;
+        switch (in.op) {
+            case OpCode::Move:
+                regs[in.a] = regs[in.b];
+                break;
+            case OpCode::LoadConst:
+                regs[in.a] = program.constants[in.b];
+                break;
+            case OpCode::Convert:
+                regs[in.a] = regs[in.b].cast(static_cast<ValueKind>(in.c));
+                break;
+            case OpCode::GetGlobal:
+                regs[in.a] = stack[in.b];
+                break;
+            case OpCode::SetGlobal:
+                stack[in.a] = regs[in.b];
+                break;
+
+            WRAPPING(Add, __builtin_add_overflow, Add)
+            WRAPPING(Sub, __builtin_sub_overflow, Sub)
+            WRAPPING(Mul, __builtin_mul_overflow, Mul)
+            SHIFT(ShiftLeft, static_cast<int>(static_cast<unsigned>(l.i) << r.i), ShiftLeft)
+            SHIFT(ShiftRight, l.i >> r.i, ShiftRight)
+            ARITHMETIC(BitAnd, &, BitAnd)
+            ARITHMETIC(BitOr, |, BitOr)
+            ARITHMETIC(BitXor, ^, BitXor)
+            COMPARISON(Equal, ==, Equal)
+            COMPARISON(NotEqual, !=, NotEqual)
+            COMPARISON(Less, <, Less)
+            COMPARISON(LessEqual, <=, LessEqual)
+            COMPARISON(Greater, >, Greater)
+            COMPARISON(GreaterEqual, >=, GreaterEqual)
+
+            case OpCode::Div: {
+                const Value& l = regs[in.b];
+                const Value& r = regs[in.c];
+                if (l.kind == ValueKind::Int && r.kind == ValueKind::Int && r.i != 0 && r.i != -1) {
+                    regs[in.a] = Value::from_int(l.i / r.i);
+                } else {
+                    regs[in.a] = binary_operation(l, Operator::Div, r);
+                }
+                break;
+            }
+            case OpCode::Mod: {
+                const Value& l = regs[in.b];
+                const Value& r = regs[in.c];
+                if (l.kind == ValueKind::Int && r.kind == ValueKind::Int && r.i != 0 && r.i != -1) {
+                    regs[in.a] = Value::from_int(l.i % r.i);
+                } else {
+                    regs[in.a] = binary_operation(l, Operator::Mod, r);
+                }
+                break;
+            }
+            case OpCode::Negate:
+                regs[in.a] = unary_operation(regs[in.b], Operator::Minus);
+                break;
+            case OpCode::Plus:
+                regs[in.a] = unary_operation(regs[in.b], Operator::Plus);
+                break;
+            case OpCode::Not:
+                regs[in.a] = unary_operation(regs[in.b], Operator::Not);
+                break;
+            case OpCode::Test:
+                regs[in.a] = Value::from_bool(regs[in.b].as_bool());
+                break;
+            case OpCode::Increment:
+            case OpCode::Decrement: {
+                Value& v = regs[in.a];
+                if (v.kind == ValueKind::Int) {
+                    // как у WRAPPING: INT_MAX + 1 даёт INT_MIN
+                    if (in.op == OpCode::Increment) {
+                        __builtin_add_overflow(v.i, 1, &v.i);
+                    } else {
+                        __builtin_sub_overflow(v.i, 1, &v.i);
+                    }
+                } else if (v.is_arithmetic() || v.is_pointer()) {
+                    v = binary_operation(v, in.op == OpCode::Increment ? Operator::Add : Operator::Sub, Value::from_int(1)).cast(v.kind);
+                } else {
+                    throw std::runtime_error("unsupported operand for increment");
+                }
+                break;
+            }
+
+            case OpCode::Jump:
+                pc = code + in.a;
+                break;
+            case OpCode::JumpIfFalse:
+                if (!regs[in.a].as_bool()) pc = code + in.b;
+                break;
+            case OpCode::JumpIfTrue:
+                if (regs[in.a].as_bool()) pc = code + in.b;
+                break;
+
+            case OpCode::Box: {
+                const auto& info = program.boxes[in.c];
+                auto& box = boxes[box_base + in.b];
+                box = std::make_shared<VarSymbol>(info.type, info.init);
+                regs[in.a] = Value::pointer(box.get(), 0);
+                break;
+            }
+            case OpCode::Array: {
+                int size = regs[in.a].as_int();
+                if (size < 0) {
+                    throw std::runtime_error("array size must be non-negative");
+                }
+                const auto& info = program.boxes[in.c];
+                auto& box = boxes[box_base + in.b];
+                box = std::make_shared<VarSymbol>(info.type);
+                box->elements.assign(size, info.init);
+                regs[in.a] = Value::pointer(box.get(), 0);
+                break;
+            }
+            case OpCode::NewStruct: {
+                const auto& tmpl = program.structs[in.c];
+                auto& box = boxes[box_base + in.b];
+                box = std::make_shared<VarSymbol>(tmpl->type);
+                box->instance = instantiate(*tmpl);
+                box->value = Value::from_record(box->instance.get());
+                regs[in.a] = box->value;
+                break;
+            }
+            case OpCode::Address:
+                regs[in.a] = Value::pointer(boxes[box_base + in.b].get(), 0);
+                break;
+            case OpCode::CopyStruct: {
+                const Value& dst = regs[in.a];
+                const Value& src = regs[in.b];
+                if (dst.kind != ValueKind::Struct || src.kind != ValueKind::Struct) {
+                    throw std::runtime_error("struct copy of non-struct value");
+                }
+                copy_record(*dst.record, *src.record);
+                break;
+            }
+            case OpCode::Load:
+                regs[in.a] = pointee(regs[in.b]);
+                break;
+            case OpCode::Store:
+                assign_pointee(regs[in.a], regs[in.b]);
+                break;
+            case OpCode::Field: {
+                const Value& object = regs[in.b];
+                if (object.kind != ValueKind::Struct || !object.record) {
+                    throw std::runtime_error("member access on non-struct value");
+                }
+                const auto& name = program.names[in.c];
+                auto it = object.record->members.find(name);
+                auto field = it != object.record->members.end()
+                           ? dynamic_cast<VarSymbol*>(it->second.get())
+                           : nullptr;
+                if (!field) {
+                    throw std::runtime_error("no such member: " + name);
+                }
+                regs[in.a] = Value::pointer(field, 0);
+                break;
+            }
+
+            case OpCode::Call: {
+                if (frames.size() >= max_depth) {
+                    throw std::runtime_error("stack overflow");
+                }
+                const Function* callee = &program.functions[in.b];
+                frames.push_back(Frame{fn, pc, base, box_base});
+
+                base += in.a;
+                if (base + callee->num_registers > stack.size()) {
+                    stack.resize(std::max(base + callee->num_registers, stack.size() * 2));
+                }
+                box_base = boxes.size();
+                if (callee->num_boxes > 0) {
+                    boxes.resize(box_base + callee->num_boxes);
+                }
+                fn = callee;
+                code = fn->code.data();
+                pc = code;
+                regs = stack.data() + base;
+                break;
+            }
+            case OpCode::Return: {
+                Value result = in.a >= 0 ? regs[in.a] : Value{};
+                if (boxes.size() > box_base) {
+                    // возвращаемая структура переживает переменные вызванной функции
+                    if (result.kind == ValueKind::Struct) {
+                        for (std::size_t i = box_base; i < boxes.size(); ++i) {
+                            if (boxes[i] && boxes[i]->instance.get() == result.record) {
+                                returned = boxes[i];
+                            }
+                        }
+                    }
+                    boxes.resize(box_base);
+                }
+                if (frames.empty()) {
+                    return result.as_int();
+                }
+                stack[base] = result;
+
+                const Frame& caller = frames.back();
+                fn = caller.function;
+                code = fn->code.data();
+                pc = caller.pc;
+                base = caller.base;
+                box_base = caller.box_base;
+                frames.pop_back();
+                regs = stack.data() + base;
+                break;
+            }
+
+            case OpCode::Print:
+                for (int i = 0; i < in.b; ++i) {
+                    std::cout << regs[in.a + i];
+                    if (i + 1 < in.b) {
+                        std::cout << " ";
+                    }
+                }
+                std::cout << std::endl;
+                regs[in.a] = Value::from_int(0);
+                break;
+            case OpCode::Read:
+                switch (static_cast<ValueKind>(in.b)) {
+                    case ValueKind::Int: {
+                        int v;
+                        if (!(std::cin >> v)) {
+                            throw std::runtime_error("read(): failed to read an integer from stdin");
+                        }
+                        regs[in.a] = Value::from_int(v);
+                        break;
+                    }
+                    case ValueKind::Float: {
+                        double v;
+                        if (!(std::cin >> v)) {
+                            throw std::runtime_error("read(): failed to read a float from stdin");
+                        }
+                        regs[in.a] = Value::from_float(v);
+                        break;
+                    }
+                    case ValueKind::Char: {
+                        char v;
+                        if (!(std::cin >> v)) {
+                            throw std::runtime_error("read(): failed to read a char from stdin");
+                        }
+                        regs[in.a] = Value::from_char(v);
+                        break;
+                    }
+                    case ValueKind::Bool: {
+                        bool v;
+                        if (!(std::cin >> v)) {
+                            throw std::runtime_error("read(): failed to read a bool from stdin");
+                        }
+                        regs[in.a] = Value::from_bool(v);
+                        break;
+                    }
+                    default:
+                        throw std::runtime_error("read(): unsupported variable type");
+                }
+                break;
+        }
+    }
+}
@@ -0,0 +1,21 @@
+#!/bin/sh
+# Регрессионные тесты: каждая программа tests/regression/*.txt исполняется в трёх режимах
+# (дерево, --vm, --lazy), её вывод до печати дерева сравнивается с файлом .out рядом.
+# Использование: tests/run.sh [путь к интерпретатору]
+program=${1:-bin/program}
+dir=$(dirname "$0")/regression
+failed=0
+for source in "$dir"/*.txt; do
+    expected="${source%.txt}.out"
+    for mode in "" --vm --lazy; do
+        if ! "$program" $mode --no-cache "$source" 2>&1 < /dev/null | sed '/^TranslationUnit {/,$d' | diff -u "$expected" - > /dev/null; then
+            echo "FAIL $source $mode"
+            failed=$((failed + 1))
+        fi
+    done
+done
+if [ "$failed" -ne 0 ]; then
+    echo "$failed failed"
+    exit 1
+fi
+echo "all passed"